@@ -1,10 +1,14 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 
+#include "SBarcodeMetrics.h"
+#include "SBarcodeResultsModel.h"
+
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 #include "SBarcodeFilter.h"
 #else
 #include "SBarcodeScanner.h"
+#include "SFrameReplaySource.h"
 #endif
 
 int main(int argc, char* argv[])
@@ -21,12 +25,16 @@ int main(int argc, char* argv[])
     qmlRegisterSingletonType(QUrl("qrc:/qml/Theme.qml"), "Theme", 1, 0, "Theme");
     qmlRegisterUncreatableMetaObject(
         SCodes::staticMetaObject, "com.scythestudio.scodes", 1, 0, "SCodes", "Error, enum type");
+    qmlRegisterType<SBarcodeMetrics>("com.scythestudio.scodes", 1, 0, "SBarcodeMetrics");
+    qmlRegisterUncreatableType<SBarcodeResultsModel>(
+        "com.scythestudio.scodes", 1, 0, "SBarcodeResultsModel", "Provided by the resultsModel property of a scanner");
 
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     qmlRegisterType<SBarcodeFilter>("com.scythestudio.scodes", 1, 0, "SBarcodeScanner");
     engine.load(QUrl(QStringLiteral("qrc:/qml/Qt5ScannerPage.qml")));
 #else
     qmlRegisterType<SBarcodeScanner>("com.scythestudio.scodes", 1, 0, "SBarcodeScanner");
+    qmlRegisterType<SFrameReplaySource>("com.scythestudio.scodes", 1, 0, "SFrameReplaySource");
     engine.load(QUrl(QStringLiteral("qrc:/qml/Qt6ScannerPage.qml")));
 #endif
 
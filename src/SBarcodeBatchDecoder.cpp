@@ -0,0 +1,259 @@
+#include "SBarcodeBatchDecoder.h"
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QImageReader>
+#include <QSemaphore>
+#include <QThread>
+
+#include <atomic>
+
+#include "private/debug.h"
+
+/*!
+ * \brief State of a single batch, shared by the worker threads
+ */
+struct SBarcodeBatchDecoder::Batch {
+    QStringList paths;
+    QList<QByteArray> buffers;
+    int count = 0;
+    ZXing::BarcodeFormats formats;
+
+    /// Index of the next image to be decoded
+    std::atomic<int> next { 0 };
+    std::atomic<int> workers { 0 };
+    std::atomic<bool> cancelled { false };
+
+    /// Limits the number of images held in memory at once
+    QSemaphore loadedImages;
+};
+
+SBarcodeBatchDecoder::SBarcodeBatchDecoder(QObject *parent)
+    : QObject{parent},
+    m_formats{SCodes::toZXingFormat(SCodes::SBarcodeFormat::Basic)}
+{ }
+
+SBarcodeBatchDecoder::~SBarcodeBatchDecoder()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+SBarcodeDecoder *SBarcodeBatchDecoder::decoder()
+{
+    return &m_decoder;
+}
+
+ZXing::BarcodeFormats SBarcodeBatchDecoder::formats() const
+{
+    return m_formats;
+}
+
+void SBarcodeBatchDecoder::setFormats(ZXing::BarcodeFormats formats)
+{
+    m_formats = formats;
+}
+
+int SBarcodeBatchDecoder::threadCount() const
+{
+    return m_threadCount;
+}
+
+void SBarcodeBatchDecoder::setThreadCount(int threadCount)
+{
+    m_threadCount = qMax(0, threadCount);
+}
+
+int SBarcodeBatchDecoder::maxLoadedImages() const
+{
+    return m_maxLoadedImages;
+}
+
+void SBarcodeBatchDecoder::setMaxLoadedImages(int maxLoadedImages)
+{
+    m_maxLoadedImages = qMax(0, maxLoadedImages);
+}
+
+SBarcodeBatchDecoder::ResultOrder SBarcodeBatchDecoder::resultOrder() const
+{
+    return m_resultOrder;
+}
+
+void SBarcodeBatchDecoder::setResultOrder(ResultOrder resultOrder)
+{
+    m_resultOrder = resultOrder;
+}
+
+bool SBarcodeBatchDecoder::isRunning() const
+{
+    return m_batch != nullptr;
+}
+
+bool SBarcodeBatchDecoder::start(const QStringList &paths)
+{
+    auto batch   = std::make_shared<Batch>();
+    batch->paths = paths;
+    batch->count = paths.size();
+
+    return launch(batch);
+}
+
+bool SBarcodeBatchDecoder::start(const QList<QByteArray> &buffers)
+{
+    auto batch     = std::make_shared<Batch>();
+    batch->buffers = buffers;
+    batch->count   = buffers.size();
+
+    return launch(batch);
+}
+
+bool SBarcodeBatchDecoder::launch(const std::shared_ptr<Batch> &batch)
+{
+    if (isRunning()) {
+        return false;
+    }
+
+    const int threads = m_threadCount > 0 ? m_threadCount : QThread::idealThreadCount();
+
+    batch->formats = m_formats;
+    batch->loadedImages.release(m_maxLoadedImages > 0 ? m_maxLoadedImages : threads);
+
+    m_batch     = batch;
+    m_pending.clear();
+    m_nextIndex = 0;
+    m_processed = 0;
+
+    sDebug() << "Batch of" << batch->count << "images started on" << threads << "threads";
+
+    if (batch->count == 0) {
+        QMetaObject::invokeMethod(this, [this, batch](){ finish(batch); }, Qt::QueuedConnection);
+        return true;
+    }
+
+    // Every worker pulls images until the batch is exhausted, so the pool never holds more tasks than threads
+    const int workers = qMin(threads, batch->count);
+    batch->workers = workers;
+    m_pool.setMaxThreadCount(threads);
+
+    for (int i = 0; i < workers; ++i) {
+        m_pool.start([this, batch](){ work(batch); });
+    }
+
+    return true;
+}
+
+void SBarcodeBatchDecoder::cancel()
+{
+    if (!m_batch) {
+        return;
+    }
+
+    // Workers still running finish their current image and stop, their results are dropped
+    m_batch->cancelled = true;
+    m_batch.reset();
+    m_pending.clear();
+
+    emit finished(true);
+}
+
+void SBarcodeBatchDecoder::work(const std::shared_ptr<Batch> &batch)
+{
+    for (int index = batch->next++; index < batch->count && !batch->cancelled; index = batch->next++) {
+        Outcome outcome;
+
+        {
+            batch->loadedImages.acquire();
+            QSemaphoreReleaser releaser(batch->loadedImages);
+
+            QElapsedTimer timer;
+            timer.start();
+
+            QBuffer buffer;
+            QImageReader reader;
+
+            if (batch->paths.isEmpty()) {
+                buffer.setData(batch->buffers.at(index));
+                reader.setDevice(&buffer);
+            } else {
+                reader.setFileName(batch->paths.at(index));
+            }
+
+            reader.setAutoTransform(true);
+
+            const QImage image = reader.read();
+            outcome.loadTime = timer.nsecsElapsed() / 1000;
+
+            if (image.isNull()) {
+                outcome.error = reader.errorString();
+            } else {
+                timer.restart();
+                outcome.results    = m_decoder.read(image, batch->formats, &outcome.error);
+                outcome.decodeTime = timer.nsecsElapsed() / 1000;
+            }
+        }
+
+        QMetaObject::invokeMethod(this, [this, batch, index, outcome](){
+            handleResult(batch, index, outcome);
+        }, Qt::QueuedConnection);
+    }
+
+    // Results of all workers are queued before the last one reports the end
+    if (--batch->workers == 0) {
+        QMetaObject::invokeMethod(this, [this, batch](){ finish(batch); }, Qt::QueuedConnection);
+    }
+}
+
+void SBarcodeBatchDecoder::handleResult(const std::shared_ptr<Batch> &batch, int index, const Outcome &outcome)
+{
+    if (batch != m_batch) {
+        return;
+    }
+
+    if (m_resultOrder == ResultOrder::Completion) {
+        report(index, outcome);
+        return;
+    }
+
+    // Only results of images still being decoded by other threads are held back, never the images themselves
+    m_pending.insert(index, outcome);
+
+    for (auto it = m_pending.find(m_nextIndex); it != m_pending.end(); it = m_pending.find(m_nextIndex)) {
+        const Outcome next = it.value();
+        m_pending.erase(it);
+        report(m_nextIndex++, next);
+
+        // A slot connected to the signals may have cancelled the batch
+        if (batch != m_batch) {
+            return;
+        }
+    }
+}
+
+void SBarcodeBatchDecoder::report(int index, const Outcome &outcome)
+{
+    const int total = m_batch->count;
+
+    ++m_processed;
+
+    emit imageTimed(index, outcome.loadTime, outcome.decodeTime);
+
+    if (outcome.error.isEmpty()) {
+        emit resultReady(index, outcome.results);
+    } else {
+        emit imageFailed(index, outcome.error);
+    }
+
+    emit progressChanged(m_processed, total);
+}
+
+void SBarcodeBatchDecoder::finish(const std::shared_ptr<Batch> &batch)
+{
+    if (batch != m_batch) {
+        return;
+    }
+
+    m_batch.reset();
+    m_pending.clear();
+
+    emit finished(false);
+}
@@ -0,0 +1,243 @@
+#ifndef SBARCODEBATCHDECODER_H
+#define SBARCODEBATCHDECODER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+
+#include <memory>
+
+#include "SBarcodeDecoder.h"
+#include "SBarcodeResult.h"
+
+/*!
+ * \brief The SBarcodeBatchDecoder class decodes a list of image files or encoded image buffers on a bounded
+ * thread pool. Results are streamed back by resultReady signal, either in input order or as soon as they are
+ * completed. At most maxLoadedImages images are held in memory at once.
+ */
+class SBarcodeBatchDecoder : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * \brief Order in which results are reported
+     */
+    enum class ResultOrder {
+        Input,
+        Completion
+    };
+    Q_ENUM(ResultOrder)
+
+    /*!
+     * \fn explicit SBarcodeBatchDecoder(QObject *parent)
+     * \brief Constructor.
+     * \param QObject *parent - a pointer to the parent object.
+     */
+    explicit SBarcodeBatchDecoder(QObject *parent = nullptr);
+
+    /*!
+     * \fn ~SBarcodeBatchDecoder()
+     * \brief Destructor, cancels the running batch and waits for the worker threads.
+     */
+    ~SBarcodeBatchDecoder() override;
+
+    /*!
+     * \fn SBarcodeDecoder *decoder()
+     * \brief Returns the decoder used for every image, to set multiResult, binarizerRace and decodeTimeBudget.
+     */
+    SBarcodeDecoder *decoder();
+
+    /*!
+     * \fn ZXing::BarcodeFormats formats() const
+     * \brief Returns the barcode formats to be decoded.
+     */
+    ZXing::BarcodeFormats formats() const;
+
+    /*!
+     * \fn void setFormats(ZXing::BarcodeFormats formats)
+     * \brief Sets the barcode formats to be decoded, takes effect with the next batch.
+     * \param ZXing::BarcodeFormats formats - barcode formats.
+     */
+    void setFormats(ZXing::BarcodeFormats formats);
+
+    /*!
+     * \fn int threadCount() const
+     * \brief Returns number of threads decoding images.
+     */
+    int threadCount() const;
+
+    /*!
+     * \fn void setThreadCount(int threadCount)
+     * \brief Sets number of threads decoding images, takes effect with the next batch.
+     * \param int threadCount - number of threads, 0 means one per CPU core.
+     */
+    void setThreadCount(int threadCount);
+
+    /*!
+     * \fn int maxLoadedImages() const
+     * \brief Returns maximum number of decoded images held in memory at once.
+     */
+    int maxLoadedImages() const;
+
+    /*!
+     * \fn void setMaxLoadedImages(int maxLoadedImages)
+     * \brief Sets maximum number of decoded images held in memory at once, takes effect with the next batch.
+     * \param int maxLoadedImages - number of images, 0 means one per thread.
+     */
+    void setMaxLoadedImages(int maxLoadedImages);
+
+    /*!
+     * \fn ResultOrder resultOrder() const
+     * \brief Returns the order in which results are reported.
+     */
+    ResultOrder resultOrder() const;
+
+    /*!
+     * \fn void setResultOrder(ResultOrder resultOrder)
+     * \brief Sets the order in which results are reported, takes effect with the next batch.
+     * \param ResultOrder resultOrder - Input keeps the order of the input list, Completion reports every image
+     * as soon as it is decoded.
+     */
+    void setResultOrder(ResultOrder resultOrder);
+
+    /*!
+     * \fn bool isRunning() const
+     * \brief Returns true while a batch is being decoded.
+     */
+    bool isRunning() const;
+
+    /*!
+     * \fn bool start(const QStringList &paths)
+     * \brief Starts decoding of image files. Results are reported with index of the path in the list.
+     * \param const QStringList &paths - paths of image files.
+     * \return false if a batch is already running.
+     */
+    bool start(const QStringList &paths);
+
+    /*!
+     * \fn bool start(const QList<QByteArray> &buffers)
+     * \brief Starts decoding of encoded images (PNG, JPEG, ...) held in memory. Results are reported with index
+     * of the buffer in the list.
+     * \param const QList<QByteArray> &buffers - encoded images.
+     * \return false if a batch is already running.
+     */
+    bool start(const QList<QByteArray> &buffers);
+
+public slots:
+    /*!
+     * \fn void cancel()
+     * \brief Stops the running batch. Images being decoded are finished, but not reported.
+     */
+    void cancel();
+
+signals:
+    /*!
+     * \brief This signal is emitted once per decoded image.
+     * \param int index - index of the image in the input list.
+     * \param const QList<SBarcodeResult> &results - decoded barcodes, empty if nothing was found.
+     */
+    void resultReady(int index, const QList<SBarcodeResult> &results);
+
+    /*!
+     * \brief This signal is emitted instead of resultReady if the image could not be loaded or decoded.
+     * \param int index - index of the image in the input list.
+     * \param const QString &errorString - error message.
+     */
+    void imageFailed(int index, const QString &errorString);
+
+    /*!
+     * \brief This signal is emitted right before resultReady or imageFailed with time spent on the image.
+     * \param int index - index of the image in the input list.
+     * \param qint64 loadTime - time spent on reading the image, in microseconds.
+     * \param qint64 decodeTime - time spent on decoding the image, in microseconds.
+     */
+    void imageTimed(int index, qint64 loadTime, qint64 decodeTime);
+
+    /*!
+     * \brief This signal is emitted after every reported image.
+     * \param int processed - number of reported images.
+     * \param int total - number of images in the batch.
+     */
+    void progressChanged(int processed, int total);
+
+    /*!
+     * \brief This signal is emitted when all images are reported or the batch was cancelled.
+     * \param bool cancelled - true if the batch was cancelled.
+     */
+    void finished(bool cancelled);
+
+private:
+    struct Batch;
+
+    /*!
+     * \brief Outcome of a single image
+     */
+    struct Outcome {
+        QList<SBarcodeResult> results;
+        QString error;
+        qint64 loadTime   = 0;
+        qint64 decodeTime = 0;
+    };
+
+    /*!
+     * \brief Decoder shared by all worker threads, its read method is thread safe
+     */
+    SBarcodeDecoder m_decoder;
+
+    ZXing::BarcodeFormats m_formats;
+
+    int m_threadCount = 0;
+
+    int m_maxLoadedImages = 0;
+
+    ResultOrder m_resultOrder = ResultOrder::Input;
+
+    QThreadPool m_pool;
+
+    std::shared_ptr<Batch> m_batch;
+
+    /*!
+     * \brief Results completed out of input order, by index
+     */
+    QMap<int, Outcome> m_pending;
+
+    int m_nextIndex = 0;
+
+    int m_processed = 0;
+
+    /*!
+     * \fn bool launch(const std::shared_ptr<Batch> &batch)
+     * \brief Starts worker threads decoding the batch.
+     */
+    bool launch(const std::shared_ptr<Batch> &batch);
+
+    /*!
+     * \fn void work(const std::shared_ptr<Batch> &batch)
+     * \brief Decodes images of the batch until there is none left or the batch is cancelled. Runs on a worker thread.
+     */
+    void work(const std::shared_ptr<Batch> &batch);
+
+    /*!
+     * \fn void handleResult(const std::shared_ptr<Batch> &batch, int index, const Outcome &outcome)
+     * \brief Reports a completed image in the requested order.
+     */
+    void handleResult(const std::shared_ptr<Batch> &batch, int index, const Outcome &outcome);
+
+    /*!
+     * \fn void report(int index, const Outcome &outcome)
+     * \brief Emits the result signals of an image.
+     */
+    void report(int index, const Outcome &outcome);
+
+    /*!
+     * \fn void finish(const std::shared_ptr<Batch> &batch)
+     * \brief Reports the end of the batch once all worker threads are done.
+     */
+    void finish(const std::shared_ptr<Batch> &batch);
+};
+
+#endif // SBARCODEBATCHDECODER_H
@@ -3,16 +3,45 @@
 
 #include <QDebug>
 #include <QImage>
+#ifndef SCODES_CORE_ONLY
 #include <QtMultimedia/qvideoframe.h>
 #include <QOpenGLContext>
 #include <QOpenGLFunctions>
 #include <QOffscreenSurface>
+#endif
 #include <iostream>
 
 #include <ReadBarcode.h>
 #include <exception>
 #include <QScopeGuard>
+#include <QDeadlineTimer>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include "private/debug.h"
+#include "private/DecodeMetrics.h"
+#include "private/DecodePool.h"
+#include "private/FormatPriorities.h"
+#include "private/LuminancePyramid.h"
+#include "private/ScanlineImage.h"
+#include "private/Tiling.h"
+#include "private/Trace.h"
+
+#ifndef SCODES_CORE_ONLY
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+using SVideoPixelFormat = QVideoFrame;
+#else
+#include <QVideoFrameFormat>
+using SVideoPixelFormat = QVideoFrameFormat;
+#endif
+#endif
 
 /*!
  * \brief Provide an interface to access `ZXing::ReadBarcode` method
@@ -23,6 +52,8 @@ using ZXing::ReaderOptions;
 using ZXing::BarcodeFormat;
 using ZXing::BarcodeFormats;
 using ZXing::Binarizer;
+using ZXing::ImageFormat;
+using ZXing::ImageView;
 
 template <typename T, typename _ = decltype(ToString(T()))>
 QDebug operator << (QDebug dbg, const T& v)
@@ -45,6 +76,8 @@ public:
 
     using ZXing::Result::format;
     using ZXing::Result::isValid;
+    using ZXing::Result::position;
+    using ZXing::Result::bytes;
 
     /*!
      * \fn inline QString text() const
@@ -54,46 +87,504 @@ public:
 };
 
 /*!
- * \fn Result ReadBarcode(const QImage& img, const ReaderOptions& options = { })
- * \brief Interface for calling ZXing::ReadBarcode method to get result as a text.
- * \param const QImage& img - reference of the image to be processed
+ * \fn std::vector<Result> ReadBarcodes(const ImageView& image, const ReaderOptions& options = { })
+ * \brief Interface for calling ZXing::ReadBarcodes method to get all results found in the image.
+ * \param const ImageView& image - view of the pixels to be processed
  * \param const ReaderOptions& options - barcode decode hints
  */
-Result ReadBarcode(const QImage& img, const ReaderOptions& options = { })
+std::vector<Result> ReadBarcodes(const ImageView& image, const ReaderOptions& options = { })
 {
-    auto ImgFmtFromQImg = [](const QImage& img){
-          switch (img.format()) {
-              case QImage::Format_ARGB32:
-              case QImage::Format_RGB32:
-                  #if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
-                  return ImageFormat::BGRX;
+    std::vector<Result> results;
+
+    for (auto&& result : ZXing::ReadBarcodes(image, options)) {
+        results.emplace_back(std::move(result));
+    }
 
-                  #else
-                  return ImageFormat::XRGB;
+    return results;
+}
 
-                  #endif
-              case QImage::Format_RGB888: return ImageFormat::RGB;
+/*!
+ * \fn ImageFormat ImgFmtFromQImg(const QImage& img)
+ * \brief Returns ZXing image format matching the QImage pixel layout, ImageFormat::None if there is none.
+ * \param const QImage& img - reference of the image
+ */
+ImageFormat ImgFmtFromQImg(const QImage& img)
+{
+    switch (img.format()) {
+        case QImage::Format_ARGB32:
+        case QImage::Format_RGB32:
+            #if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+            return ImageFormat::BGRX;
 
-              case QImage::Format_RGBX8888:
-              case QImage::Format_RGBA8888: return ImageFormat::RGBX;
+            #else
+            return ImageFormat::XRGB;
 
-              case QImage::Format_Grayscale8: return ImageFormat::Lum;
+            #endif
+        case QImage::Format_RGB888: return ImageFormat::RGB;
 
-              default: return ImageFormat::None;
-          }
-    };
+        case QImage::Format_RGBX8888:
+        case QImage::Format_RGBA8888: return ImageFormat::RGBX;
 
-    auto exec = [&](const QImage& img){
-          return Result(ZXing::ReadBarcode({ img.bits(), img.width(), img.height(), ImgFmtFromQImg(img) }, options));
-     };
+        case QImage::Format_Grayscale8: return ImageFormat::Lum;
 
-    return ImgFmtFromQImg(img) == ImageFormat::None ? exec(img.convertToFormat(QImage::Format_RGBX8888)) : exec(img);
+        default: return ImageFormat::None;
+    }
 }
 } // Qt namespace
 } // ZXing namespace
 
 using namespace ZXing::Qt;
 
+namespace {
+/*!
+ * \brief Single step of the decoding ladder. Passes are run from the cheapest one until a barcode is found.
+ */
+struct DecodePass {
+    /// Decode the levels of the luminance pyramid, from the coarsest one, instead of the full resolution image
+    bool pyramid;
+    /// Spend more time to try to find a barcode
+    bool tryHarder;
+    /// Also try rotated image
+    bool tryRotate;
+};
+
+/*!
+ *  Decoding ladder, the last pass is the most expensive one and matches the former fixed options
+ */
+constexpr DecodePass k_decodePasses[] =
+{
+    { true, false, false },
+    { false, false, false },
+    { false, true, true },
+};
+
+/*!
+ *  Maximum number of pyramid levels, the coarsest one has 1/8 of the original resolution
+ */
+constexpr int k_pyramidLevels = 3;
+
+/*!
+ *  Pyramid levels with shorter side smaller than this are not built
+ */
+constexpr int k_minDownscaledSize = 240;
+
+/*!
+ *  Number of frame buffers preallocated for the camera resolution, a frame being converted, one being decoded
+ *  and a spare one
+ */
+constexpr int k_pooledFrameBuffers = 3;
+
+/*!
+ *  Interval in milliseconds of saving the learned format statistics, kept off the decoding threads
+ */
+constexpr int k_prioritiesSaveInterval = 30000;
+
+/*!
+ *  Binarizers competing for the same image when binarizer race is enabled
+ */
+constexpr Binarizer k_racedBinarizers[] =
+{
+    Binarizer::LocalAverage,
+    Binarizer::GlobalHistogram,
+    Binarizer::FixedThreshold,
+};
+
+/*!
+ * \brief Shared state of a binarizer race, owned jointly by the decoding thread and the decode pool tasks helping
+ * it, so tasks starting after the race was decided only touch this state
+ */
+struct BinarizerRace {
+    /// Index of the next binarizer to be claimed
+    std::atomic<int> next { 0 };
+    /// Set once the winner is known, binarizers claimed afterwards are skipped
+    std::atomic<bool> decided { false };
+    /// Number of claimed binarizers that are done, guarded by mutex
+    int finished = 0;
+    QMutex mutex;
+    QWaitCondition done;
+    std::vector<Result> winner;
+    QString error;
+};
+
+/*!
+ * \fn std::vector<Result> raceBinarizers(const ImageView &image, const ReaderOptions &options)
+ * \brief Decodes the image with every binarizer from k_racedBinarizers concurrently and returns the results of the
+ * first one that finds a barcode. Binarizers not started before the winner was found are skipped. Returns only
+ * once no task reads the image any more, so the caller's pixels are used without a copy.
+ * \param const ImageView &image - image to be decoded.
+ * \param const ReaderOptions &options - barcode decode hints, the binarizer is replaced for every task.
+ */
+std::vector<Result> raceBinarizers(const ImageView &image, const ReaderOptions &options)
+{
+    constexpr int binarizerCount = int(std::size(k_racedBinarizers));
+
+    auto race = std::make_shared<BinarizerRace>();
+
+    // Claims binarizers until none is left, the image is only read for a claimed one
+    auto runBinarizers = [race, &image, options]() {
+        for (int i = race->next++; i < binarizerCount; i = race->next++) {
+            std::vector<Result> results;
+            QString error;
+
+            if (!race->decided) {
+                try {
+                    results = ReadBarcodes(image, ReaderOptions(options).setBinarizer(k_racedBinarizers[i]));
+                }
+                catch(std::exception& e) {
+                    error = QString::fromLocal8Bit(e.what());
+                }
+            }
+
+            const bool found = std::any_of(results.begin(), results.end(), [](const Result &r){ return r.isValid(); });
+
+            QMutexLocker locker(&race->mutex);
+
+            if (found && !race->decided) {
+                race->winner  = std::move(results);
+                race->decided = true;
+            } else if (!error.isEmpty()) {
+                race->error = error;
+            }
+
+            if (++race->finished == binarizerCount) {
+                race->done.wakeAll();
+            }
+        }
+    };
+
+    // The calling thread races too and runs every binarizer no worker claimed, so it only waits for binarizers
+    // being decoded right now, never for busy workers
+    for (int i = 1; i < binarizerCount; ++i) {
+        SCodes::DecodePool::instance().submit(runBinarizers);
+    }
+
+    runBinarizers();
+
+    QMutexLocker locker(&race->mutex);
+
+    while (race->finished < binarizerCount) {
+        race->done.wait(&race->mutex);
+    }
+
+    if (race->winner.empty() && !race->error.isEmpty()) {
+        throw std::runtime_error(race->error.toStdString());
+    }
+
+    return std::move(race->winner);
+}
+
+/*!
+ * \brief State shared by the thread decoding an image tile by tile and the decode pool tasks helping it
+ */
+struct TileJob {
+    /// Index of the next tile to be claimed
+    std::atomic<int> next { 0 };
+    /// Number of decoded tiles, guarded by mutex
+    int finished = 0;
+    QMutex mutex;
+    QWaitCondition done;
+};
+
+#ifndef SCODES_CORE_ONLY
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+constexpr auto k_mapReadOnly = QAbstractVideoBuffer::ReadOnly;
+#else
+constexpr auto k_mapReadOnly = QVideoFrame::ReadOnly;
+#endif
+
+/*!
+ *  Byte offset of the most significant byte of a native 16 bit sample
+ */
+constexpr int k_sampleHighByte = Q_BYTE_ORDER == Q_BIG_ENDIAN ? 0 : 1;
+
+/*!
+ * \fn bool luminanceLayout(SVideoPixelFormat::PixelFormat pixelFormat, int &offset, int &pixStride)
+ * \brief Returns true if the first plane of the pixel format holds full resolution luminance samples and provides
+ * the byte offset and the distance in bytes between two samples.
+ * \param SVideoPixelFormat::PixelFormat pixelFormat - video frame pixel format.
+ * \param int &offset - byte offset of the first luminance sample.
+ * \param int &pixStride - distance between two luminance samples in bytes.
+ */
+bool luminanceLayout(SVideoPixelFormat::PixelFormat pixelFormat, int &offset, int &pixStride)
+{
+    offset = 0;
+    pixStride = 1;
+
+    switch (pixelFormat) {
+        case SVideoPixelFormat::Format_NV12:
+        case SVideoPixelFormat::Format_NV21:
+        case SVideoPixelFormat::Format_YUV420P:
+        case SVideoPixelFormat::Format_YV12:
+        case SVideoPixelFormat::Format_IMC1:
+        case SVideoPixelFormat::Format_IMC2:
+        case SVideoPixelFormat::Format_IMC3:
+        case SVideoPixelFormat::Format_IMC4:
+        case SVideoPixelFormat::Format_Y8:
+            return true;
+
+        case SVideoPixelFormat::Format_YUYV:
+            pixStride = 2;
+            return true;
+
+        case SVideoPixelFormat::Format_UYVY:
+            offset = 1;
+            pixStride = 2;
+            return true;
+
+        case SVideoPixelFormat::Format_Y16:
+            // 16 bit native endian samples, the most significant byte is enough for decoding
+            offset = k_sampleHighByte;
+            pixStride = 2;
+            return true;
+
+        #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        case SVideoPixelFormat::Format_YUV422P:
+            return true;
+
+        case SVideoPixelFormat::Format_P010:
+        case SVideoPixelFormat::Format_P016:
+            // 16 bit native endian samples, the most significant byte is enough for decoding
+            offset = k_sampleHighByte;
+            pixStride = 2;
+            return true;
+
+        #endif
+        default:
+            return false;
+    }
+}
+
+/*!
+ *  Byte offsets of the color channels of QImage::Format_ARGB32 pixels, stored as native 0xAARRGGBB words
+ */
+constexpr int k_argb32Red   = Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? 2 : 1;
+constexpr int k_argb32Green = Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? 1 : 2;
+constexpr int k_argb32Blue  = Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? 0 : 3;
+
+/*!
+ * \fn bool rgbLayout(SVideoPixelFormat::PixelFormat pixelFormat, int &red, int &green, int &blue)
+ * \brief Returns true if the first plane of the pixel format holds 32 bit RGB pixels and provides the byte
+ * offsets of the color channels within a pixel.
+ * \param SVideoPixelFormat::PixelFormat pixelFormat - video frame pixel format.
+ * \param int &red - byte offset of the red channel.
+ * \param int &green - byte offset of the green channel.
+ * \param int &blue - byte offset of the blue channel.
+ */
+bool rgbLayout(SVideoPixelFormat::PixelFormat pixelFormat, int &red, int &green, int &blue)
+{
+    auto set = [&](int r, int g, int b) {
+        red   = r;
+        green = g;
+        blue  = b;
+        return true;
+    };
+
+    switch (pixelFormat) {
+        #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        // Native 0xAARRGGBB and 0xBBGGRRAA words
+        case SVideoPixelFormat::Format_ARGB32:
+        case SVideoPixelFormat::Format_ARGB32_Premultiplied:
+        case SVideoPixelFormat::Format_RGB32:
+            return set(k_argb32Red, k_argb32Green, k_argb32Blue);
+
+        case SVideoPixelFormat::Format_BGRA32:
+        case SVideoPixelFormat::Format_BGRA32_Premultiplied:
+        case SVideoPixelFormat::Format_BGR32:
+            return Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? set(1, 2, 3) : set(2, 1, 0);
+
+        #else
+        // Byte ordered formats
+        case SVideoPixelFormat::Format_ARGB8888:
+        case SVideoPixelFormat::Format_ARGB8888_Premultiplied:
+        case SVideoPixelFormat::Format_XRGB8888:
+            return set(1, 2, 3);
+
+        case SVideoPixelFormat::Format_BGRA8888:
+        case SVideoPixelFormat::Format_BGRA8888_Premultiplied:
+        case SVideoPixelFormat::Format_BGRX8888:
+            return set(2, 1, 0);
+
+        case SVideoPixelFormat::Format_ABGR8888:
+        case SVideoPixelFormat::Format_XBGR8888:
+            return set(3, 2, 1);
+
+        case SVideoPixelFormat::Format_RGBA8888:
+        case SVideoPixelFormat::Format_RGBX8888:
+            return set(0, 1, 2);
+
+        #endif
+        default:
+            return false;
+    }
+}
+
+/*!
+ * \fn bool sampleLayout(SVideoPixelFormat::PixelFormat pixelFormat, int &offset, int &pixStride)
+ * \brief Like luminanceLayout, additionally accepts 32 bit RGB formats and provides the layout of their green
+ * channel. Green follows luminance closely enough to measure sharpness and motion, but not for decoding.
+ * \param SVideoPixelFormat::PixelFormat pixelFormat - video frame pixel format.
+ * \param int &offset - byte offset of the first sample.
+ * \param int &pixStride - distance between two samples in bytes.
+ */
+bool sampleLayout(SVideoPixelFormat::PixelFormat pixelFormat, int &offset, int &pixStride)
+{
+    int red  = 0;
+    int blue = 0;
+
+    if (luminanceLayout(pixelFormat, offset, pixStride)) {
+        return true;
+    }
+
+    pixStride = 4;
+    return rgbLayout(pixelFormat, red, offset, blue);
+}
+
+/*!
+ * \fn void copyLuminance(const uchar *source, int rowStride, int pixStride, QImage &target)
+ * \brief Copies luminance samples to the Grayscale8 target image, of the size of the target.
+ * \param const uchar *source - first sample.
+ * \param int rowStride - distance between source rows in bytes.
+ * \param int pixStride - distance between two source samples in bytes.
+ * \param QImage &target - Grayscale8 image.
+ */
+void copyLuminance(const uchar *source, int rowStride, int pixStride, QImage &target)
+{
+    for (int y = 0; y < target.height(); ++y) {
+        const uchar *in = source + size_t(y) * rowStride;
+        uchar *out = target.scanLine(y);
+
+        if (pixStride == 1) {
+            std::memcpy(out, in, size_t(target.width()));
+            continue;
+        }
+
+        for (int x = 0; x < target.width(); ++x) {
+            out[x] = in[x * pixStride];
+        }
+    }
+}
+
+/*!
+ * \fn void rgbToLuminance(const uchar *source, int rowStride, int red, int green, int blue, QImage &target)
+ * \brief Converts 32 bit RGB pixels to luminance of the Grayscale8 target image, with the weights used by ZXing.
+ * \param const uchar *source - first pixel.
+ * \param int rowStride - distance between source rows in bytes.
+ * \param int red - byte offset of the red channel.
+ * \param int green - byte offset of the green channel.
+ * \param int blue - byte offset of the blue channel.
+ * \param QImage &target - Grayscale8 image.
+ */
+void rgbToLuminance(const uchar *source, int rowStride, int red, int green, int blue, QImage &target)
+{
+    for (int y = 0; y < target.height(); ++y) {
+        const uchar *in = source + size_t(y) * rowStride;
+        uchar *out = target.scanLine(y);
+
+        for (int x = 0; x < target.width(); ++x, in += 4) {
+            out[x] = uchar((306 * in[red] + 601 * in[green] + 117 * in[blue] + 0x200) >> 10);
+        }
+    }
+}
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+/*!
+ * \fn void readTexture(GLuint textureId, const QRect &rect, uchar *pixels)
+ * \brief Reads an area of the texture as RGBA pixels through a temporary framebuffer of the current OpenGL context.
+ * \param GLuint textureId - texture of the video frame.
+ * \param const QRect &rect - area to be read, in texture pixels.
+ * \param uchar *pixels - destination of rect.width() * rect.height() * 4 bytes.
+ */
+void readTexture(GLuint textureId, const QRect &rect, uchar *pixels)
+{
+    QOpenGLContext *ctx = QOpenGLContext::currentContext();
+
+    QOpenGLFunctions *f = ctx->functions();
+
+    GLuint fbo;
+
+    f->glGenFramebuffers(1, &fbo);
+
+    GLint prevFbo;
+
+    f->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFbo);
+    f->glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    f->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
+    f->glReadPixels(rect.x(), rect.y(), rect.width(), rect.height(), GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    f->glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>( prevFbo ) );
+    f->glDeleteFramebuffers(1,&fbo);
+}
+#endif
+
+/*!
+ * \fn std::optional<ZXing::ImageView> luminanceView(const QVideoFrame &mappedFrame, const QRect &rect)
+ * \brief Returns a view on the luminance samples of a mapped frame, limited to the capture area. Returns nothing
+ * if the pixel format has no usable luminance plane.
+ * \param const QVideoFrame &mappedFrame - frame mapped for reading.
+ * \param const QRect &rect - capture area rectangle in frame pixels, must lie within the frame.
+ */
+std::optional<ZXing::ImageView> luminanceView(const QVideoFrame &mappedFrame, const QRect &rect)
+{
+    int offset = 0;
+    int pixStride = 1;
+
+    if (!luminanceLayout(mappedFrame.pixelFormat(), offset, pixStride)) {
+        return std::nullopt;
+    }
+
+    const uchar *bits = mappedFrame.bits(0);
+    const int rowStride = mappedFrame.bytesPerLine(0);
+
+    if (bits == nullptr || rowStride <= 0) {
+        return std::nullopt;
+    }
+
+    return ZXing::ImageView(bits + offset + rect.y() * rowStride + rect.x() * pixStride, rect.width(), rect.height(),
+                            ImageFormat::Lum, rowStride, pixStride);
+}
+#endif
+
+/*!
+ * \fn template <typename MapPoint> SBarcodeResult toSBarcodeResult(const Result &result, MapPoint mapPoint)
+ * \brief Converts ZXing result to SBarcodeResult, mapping every corner of its position by the given function.
+ * \param const Result &result - ZXing result.
+ * \param MapPoint mapPoint - function returning normalized frame coordinates of a point of the decoded image.
+ */
+template <typename MapPoint>
+SBarcodeResult toSBarcodeResult(const Result &result, MapPoint mapPoint)
+{
+    SBarcodeResult barcode;
+    barcode.text   = result.text();
+    barcode.format = SCodes::fromZXingFormat(result.format());
+    barcode.bytes  = QByteArray(reinterpret_cast<const char *>(result.bytes().data()), int(result.bytes().size()));
+
+    for (const auto &point : result.position()) {
+        barcode.position.append(mapPoint(QPointF(point.x, point.y)));
+    }
+
+    return barcode;
+}
+
+/*!
+ * \fn SBarcodeResult toSBarcodeResult(const Result &result, const QRect &sourceRect, const QSizeF &imageSize, const QSize &frameSize)
+ * \brief Converts ZXing result to SBarcodeResult, mapping its position from image to normalized frame coordinates.
+ * \param const Result &result - ZXing result.
+ * \param const QRect &sourceRect - area of the frame covered by the decoded image, in frame pixels.
+ * \param const QSizeF &imageSize - size of the decoded image.
+ * \param const QSize &frameSize - size of the full frame.
+ */
+SBarcodeResult toSBarcodeResult(const Result &result, const QRect &sourceRect, const QSizeF &imageSize,
+                                const QSize &frameSize)
+{
+    const qreal scaleX = sourceRect.width() / imageSize.width();
+    const qreal scaleY = sourceRect.height() / imageSize.height();
+
+    return toSBarcodeResult(result, [&](const QPointF &point) {
+        return QPointF((sourceRect.x() + point.x() * scaleX) / frameSize.width(),
+                       (sourceRect.y() + point.y() * scaleY) / frameSize.height());
+    });
+}
+}
+
 std::ostream& operator << (std::ostream& os, const std::vector<ZXing::ResultPoint>& points)
 {
     for (const auto& p : points) {
@@ -104,11 +595,25 @@ std::ostream& operator << (std::ostream& os, const std::vector<ZXing::ResultPoin
 }
 
 SBarcodeDecoder::SBarcodeDecoder(QObject *parent) : QObject(parent)
-{ }
+{
+    qRegisterMetaType<SBarcodeResult>();
+    qRegisterMetaType<QList<SBarcodeResult> >();
+
+    m_prioritiesSaveTimer.setInterval(k_prioritiesSaveInterval);
+    connect(&m_prioritiesSaveTimer, &QTimer::timeout, this, [this]() { m_formatPriorities.saveChanges(); });
+}
+
+SBarcodeDecoder::~SBarcodeDecoder()
+{
+    if (m_learnedFormats) {
+        m_formatPriorities.saveChanges();
+    }
+}
 
 void SBarcodeDecoder::clean()
 {
     m_captured = "";
+    m_resultFilter.reset();
 }
 
 QString SBarcodeDecoder::captured() const
@@ -138,34 +643,504 @@ bool SBarcodeDecoder::  isDecoding() const
     return m_isDecoding;
 }
 
-void SBarcodeDecoder::process(const QImage& capturedImage, ZXing::BarcodeFormats formats)
+QList<SBarcodeResult> SBarcodeDecoder::process(const QImage& capturedImage, ZXing::BarcodeFormats formats)
+{
+    return process(capturedImage, formats, capturedImage.rect(), capturedImage.size());
+}
+
+QList<SBarcodeResult> SBarcodeDecoder::process(const QImage &capturedImage, ZXing::BarcodeFormats formats,
+                                               const QRect &sourceRect, const QSize &frameSize)
 {
     // This will set the "isDecoding" to false automatically
     auto decodeGuard = qScopeGuard([=](){setIsDecoding(false);});
-    SCODES_MEASURE(time);
     setIsDecoding(true);
 
+    if (capturedImage.isNull()) {
+        return {};
+    }
+
+    // ZXing works on luminance anyway, converting once up front also allows decoding of the downscaled pyramid
+    const QImage image = capturedImage.format() == QImage::Format_Grayscale8
+      ? capturedImage
+      : capturedImage.convertToFormat(QImage::Format_Grayscale8);
+
+    return decode({ image.bits(), image.width(), image.height(), ImgFmtFromQImg(image), int(image.bytesPerLine()) },
+                  formats, sourceRect, frameSize);
+}
+
+QList<SBarcodeResult> SBarcodeDecoder::read(const QImage &image, ZXing::BarcodeFormats formats, QString *error) const
+{
+    if (image.isNull()) {
+        return {};
+    }
+
+    const QImage luminance = image.format() == QImage::Format_Grayscale8
+      ? image
+      : image.convertToFormat(QImage::Format_Grayscale8);
+
+    QString readError;
+    const auto barcodes = readBarcodes({ luminance.bits(), luminance.width(), luminance.height(),
+                                         ImgFmtFromQImg(luminance), int(luminance.bytesPerLine()) },
+                                       formats, luminance.rect(), luminance.size(), m_multiResult ? 0xff : 1, readError);
+
+    if (error) {
+        *error = readError;
+    }
+
+    return barcodes;
+}
+
+SCodes::FrameGate &SBarcodeDecoder::frameGate()
+{
+    return m_frameGate;
+}
+
+const SCodes::FrameGate &SBarcodeDecoder::frameGate() const
+{
+    return m_frameGate;
+}
+
+#ifndef SCODES_CORE_ONLY
+bool SBarcodeDecoder::acceptFrame(const QVideoFrame &videoFrame, const QRect &captureRect)
+{
+    SCODES_TRACE("SBarcodeDecoder::acceptFrame");
+
+    int offset = 0;
+    int pixStride = 1;
+
+    if (!m_frameGate.isEnabled() || !sampleLayout(videoFrame.pixelFormat(), offset, pixStride)) {
+        return true;
+    }
+
+    const QRect frameRect(QPoint(0, 0), videoFrame.size());
+    const QRect rect = captureRect.isEmpty() ? frameRect : captureRect.intersected(frameRect);
+
+    // QVideoFrame is explicitly shared, mapping the copy maps the same buffer
+    QVideoFrame frame(videoFrame);
+
+    if (rect.isEmpty() || !frame.map(k_mapReadOnly)) {
+        return true;
+    }
+
+    auto unmapGuard = qScopeGuard([&frame](){ frame.unmap(); });
+
+    const uchar *bits = frame.bits(0);
+    const int rowStride = frame.bytesPerLine(0);
+
+    if (bits == nullptr || rowStride <= 0) {
+        return true;
+    }
+
+    return m_frameGate.accept({ bits + offset + rect.y() * rowStride + rect.x() * pixStride, rect.width(),
+                                rect.height(), rowStride, pixStride });
+}
+
+QList<SBarcodeResult> SBarcodeDecoder::processFrame(const QVideoFrame &videoFrame, const QRect &captureRect,
+                                                    ZXing::BarcodeFormats formats)
+{
+    auto decodeGuard = qScopeGuard([=](){setIsDecoding(false);});
+    setIsDecoding(true);
+
+    SCODES_MEASURE(time);
+
+    QString error;
+    const auto barcodes = readFrame(videoFrame, captureRect, formats, &error);
+
+    if (!error.isEmpty()) {
+        emit errorOccured(error);
+    }
+
+    reportResults(barcodes);
+
+    return barcodes;
+}
+
+QList<SBarcodeResult> SBarcodeDecoder::readFrame(const QVideoFrame &videoFrame, const QRect &captureRect,
+                                                 ZXing::BarcodeFormats formats, QString *error)
+{
+    SCODES_TRACE("SBarcodeDecoder::readFrame");
+
+    const QRect frameRect(QPoint(0, 0), videoFrame.size());
+    const QRect rect = captureRect.isEmpty() ? frameRect : captureRect.intersected(frameRect);
+
+    if (rect.isEmpty()) {
+        return {};
+    }
+
+    const int maxSymbols = m_multiResult ? 0xff : 1;
+    QString readError;
+    QList<SBarcodeResult> barcodes;
+
+    int offset = 0;
+    int pixStride = 1;
+    // QVideoFrame is explicitly shared, mapping the copy maps the same buffer
+    QVideoFrame frame(videoFrame);
+    bool decoded = false;
+
+    if (luminanceLayout(frame.pixelFormat(), offset, pixStride) && frame.map(k_mapReadOnly)) {
+        auto unmapGuard = qScopeGuard([&](){frame.unmap();});
+
+        if (const auto view = luminanceView(frame, rect)) {
+            barcodes = readBarcodes(*view, formats, rect, frameRect.size(), maxSymbols, readError);
+            decoded = true;
+        }
+    }
+
+    if (!decoded) {
+        const QImage image = videoFrameToLuminance(videoFrame, rect);
+
+        if (image.isNull()) {
+            return {};
+        }
+
+        barcodes = readBarcodes({ image.bits(), image.width(), image.height(), ImgFmtFromQImg(image),
+                                  int(image.bytesPerLine()) },
+                                formats, rect, frameRect.size(), maxSymbols, readError);
+    }
+
+    if (error) {
+        *error = readError;
+    }
+
+    return barcodes;
+}
+#endif
+
+QList<SBarcodeResult> SBarcodeDecoder::decode(const ZXing::ImageView &image, ZXing::BarcodeFormats formats,
+                                              const QRect &sourceRect, const QSize &frameSize)
+{
+    SCODES_MEASURE(time);
+
+    QString error;
+    const auto barcodes = readBarcodes(image, formats, sourceRect, frameSize, m_multiResult ? 0xff : 1, error);
+
+    if (!error.isEmpty()) {
+        emit errorOccured(error);
+    }
+
+    reportResults(barcodes);
+
+    return barcodes;
+}
+
+void SBarcodeDecoder::reportResults(const QList<SBarcodeResult> &results)
+{
+    SCODES_TRACE("SBarcodeDecoder::reportResults");
+
+    const auto reported = m_resultFilter.filter(results);
+
+    if (!reported.isEmpty()) {
+        setCaptured(reported.first().text);
+        emit resultsCaptured(reported);
+    }
+}
+
+QList<SBarcodeResult> SBarcodeDecoder::readBarcodes(const ZXing::ImageView &image, ZXing::BarcodeFormats formats,
+                                                    const QRect &sourceRect, const QSize &frameSize,
+                                                    int maxSymbols, QString &error, bool record) const
+{
+    SCODES_TRACE("SBarcodeDecoder::readBarcodes");
+    SCodes::LatencyTimer decodeTimer(SCodes::DecodeMetrics::instance().decodeTime);
+
+    // Linear barcodes are read from a few bands of lines, the rest of the image is never touched
+    const bool scanlines = m_scanlineCount > 0 && image.format() == ImageFormat::Lum && SCodes::isLinearOnly(formats);
+
+    // The likely and the remaining formats share one time budget
+    const int timeBudget = m_decodeTimeBudget;
+    const QDeadlineTimer deadline = timeBudget > 0 ? QDeadlineTimer(timeBudget)
+                                                   : QDeadlineTimer(QDeadlineTimer::Forever);
+
+    auto read = [&](ZXing::BarcodeFormats readFormats) {
+        return scanlines ? readScanlines(image, readFormats, sourceRect, frameSize, maxSymbols, deadline, error)
+                         : readLadder(image, readFormats, sourceRect, frameSize, maxSymbols, deadline, error);
+    };
+
+    // A single barcode is looked for in the formats decoded most often first, the others are tried after a miss
+    const ZXing::BarcodeFormats likely = m_learnedFormats && maxSymbols == 1
+      ? m_formatPriorities.likelyFormats(formats)
+      : formats;
+
+    QList<SBarcodeResult> barcodes = read(likely);
+
+    if (barcodes.isEmpty() && error.isEmpty() && !(likely == formats)) {
+        const auto remaining = SCodes::FormatPriorities::remainingFormats(formats, likely);
+
+        if (!remaining.empty()) {
+            barcodes = read(remaining);
+        }
+    }
+
+    if (record) {
+        recordHits(barcodes);
+    }
+
+    return barcodes;
+}
+
+void SBarcodeDecoder::recordHits(const QList<SBarcodeResult> &barcodes) const
+{
+    SCodes::DecodeMetrics &metrics = SCodes::DecodeMetrics::instance();
+    const bool learned = m_learnedFormats;
+
+    for (const auto &barcode : barcodes) {
+        metrics.recordHit(int(barcode.format));
+
+        if (learned) {
+            m_formatPriorities.recordHit(barcode.format);
+        }
+    }
+}
+
+QList<SBarcodeResult> SBarcodeDecoder::readLadder(const ZXing::ImageView &image, ZXing::BarcodeFormats formats,
+                                                  const QRect &sourceRect, const QSize &frameSize, int maxSymbols,
+                                                  const QDeadlineTimer &deadline, QString &error) const
+{
+    // Pyramid buffers are reused by all decoders running on the same thread
+    thread_local SCodes::LuminancePyramid pyramid;
+
+    QList<SBarcodeResult> barcodes;
+    bool pyramidBuilt = false;
+
+    // Runs single decoding attempt, returns true if the ladder should stop
+    auto tryDecode = [&](const ImageView &passImage, const DecodePass &pass) {
+        // The budget is checked between attempts, a started attempt is never interrupted
+        if (deadline.hasExpired()) {
+            sDebug() << "Decode time budget exceeded before pass" << (&pass - k_decodePasses);
+            return true;
+        }
+
+        const auto readerOptions = ReaderOptions()
+          .setFormats(formats)
+          .setTryHarder(pass.tryHarder)
+          .setTryRotate(pass.tryRotate)
+          .setTryDownscale(pass.tryHarder)
+          .setIsPure(false)
+          .setBinarizer(Binarizer::LocalAverage)
+          .setMaxNumberOfSymbols(maxSymbols);
+
+        try{
+            const auto results = m_binarizerRace
+              ? raceBinarizers(passImage, readerOptions)
+              : ReadBarcodes(passImage, readerOptions);
+
+            for (const auto& result : results) {
+                if (result.isValid()) {
+                    barcodes.append(toSBarcodeResult(result, sourceRect,
+                                                     QSizeF(passImage.width(), passImage.height()), frameSize));
+                }
+            }
+        }
+        catch(std::exception& e) {
+            error = "ZXing exception: " + QString::fromLocal8Bit(e.what());
+            return true;
+        }
+
+        return !barcodes.isEmpty();
+    };
+
+    for (const auto &pass : k_decodePasses) {
+        if (!pass.pyramid) {
+            if (tryDecode(image, pass)) {
+                break;
+            }
+
+            continue;
+        }
+
+        // Pyramid works on luminance only, other formats start at full resolution
+        if (image.format() != ImageFormat::Lum) {
+            continue;
+        }
+
+        if (!pyramidBuilt) {
+            SCODES_MEASURE(pyramidTime);
+            pyramid.build({ image.data(0, 0), image.width(), image.height(), image.rowStride(), image.pixStride() },
+                          k_pyramidLevels, k_minDownscaledSize);
+            pyramidBuilt = true;
+        }
+
+        bool stop = false;
+
+        for (int i = pyramid.levelCount() - 1; i >= 0 && !stop; --i) {
+            const auto level = pyramid.level(i);
+            stop = tryDecode(ImageView(level.data, level.width, level.height, ImageFormat::Lum, level.rowStride), pass);
+        }
+
+        if (stop) {
+            break;
+        }
+    }
+
+    return barcodes;
+}
+
+QList<SBarcodeResult> SBarcodeDecoder::readScanlines(const ZXing::ImageView &image, ZXing::BarcodeFormats formats,
+                                                     const QRect &sourceRect, const QSize &frameSize,
+                                                     int maxSymbols, const QDeadlineTimer &deadline,
+                                                     QString &error) const
+{
+    // Scanline buffers are reused by all decoders running on the same thread
+    thread_local SCodes::ScanlineImage scanlines;
+
+    SCODES_TRACE("SBarcodeDecoder::readScanlines");
+
+    const SCodes::LuminanceImage luminance { image.data(0, 0), image.width(), image.height(), image.rowStride(),
+                                             image.pixStride() };
+    const qreal scaleX = sourceRect.width() / qreal(image.width());
+    const qreal scaleY = sourceRect.height() / qreal(image.height());
+
+    // Bands are a few lines high, so every line is scanned in both directions, the global histogram binarizer
+    // thresholds each line on its own
     const auto readerOptions = ReaderOptions()
       .setFormats(formats)
       .setTryHarder(true)
-      .setTryRotate(true)
+      .setTryRotate(false)
+      .setTryDownscale(false)
       .setIsPure(false)
-      .setBinarizer(Binarizer::LocalAverage);
+      .setBinarizer(Binarizer::GlobalHistogram)
+      .setMaxNumberOfSymbols(maxSymbols);
+
+    QList<SBarcodeResult> barcodes;
+
+    for (const bool vertical : { false, true }) {
+        if (vertical && (!m_verticalScanlines || deadline.hasExpired())) {
+            break;
+        }
 
-    try{
-        const auto result = ReadBarcode(capturedImage, readerOptions);
+        if (barcodes.size() >= maxSymbols) {
+            break;
+        }
+
+        scanlines.build(luminance, m_scanlineCount, vertical);
+        const auto thin = scanlines.image();
 
-        if (result.isValid()) {
-            setCaptured(result.text());
+        if (thin.height == 0) {
+            continue;
+        }
+
+        try {
+            const auto results = ReadBarcodes(ImageView(thin.data, thin.width, thin.height, ImageFormat::Lum,
+                                                        thin.rowStride), readerOptions);
+
+            for (const auto &result : results) {
+                if (!result.isValid()) {
+                    continue;
+                }
+
+                const auto barcode = toSBarcodeResult(result, [&](const QPointF &point) {
+                    const QPointF source = scanlines.toSource(point);
+                    return QPointF((sourceRect.x() + source.x() * scaleX) / frameSize.width(),
+                                   (sourceRect.y() + source.y() * scaleY) / frameSize.height());
+                });
+
+                // A barcode crossed by the bands of both directions is reported once
+                const bool known = std::any_of(barcodes.cbegin(), barcodes.cend(), [&](const SBarcodeResult &other) {
+                    return SCodes::isSameBarcode(other, barcode, frameSize);
+                });
+
+                if (!known) {
+                    barcodes.append(barcode);
+                }
+            }
+        }
+        catch(std::exception& e) {
+            error = "ZXing exception: " + QString::fromLocal8Bit(e.what());
+            break;
         }
     }
-    catch(std::exception& e) {
-        emit errorOccured("ZXing exception: " + QString::fromLocal8Bit(e.what()));
+
+    return barcodes;
+}
+
+QList<SBarcodeResult> SBarcodeDecoder::processTiled(const QImage &capturedImage, ZXing::BarcodeFormats formats,
+                                                    const QSize &tileSize, int overlap, int threadCount)
+{
+    auto decodeGuard = qScopeGuard([=](){setIsDecoding(false);});
+    setIsDecoding(true);
+    SCODES_MEASURE(time);
+
+    if (capturedImage.isNull() || tileSize.isEmpty()) {
+        return {};
     }
+
+    const QImage image = capturedImage.format() == QImage::Format_Grayscale8
+      ? capturedImage
+      : capturedImage.convertToFormat(QImage::Format_Grayscale8);
+    const ImageView view(image.bits(), image.width(), image.height(), ImgFmtFromQImg(image), int(image.bytesPerLine()));
+
+    // Overlap must stay smaller than the tile, otherwise tiling would never advance
+    overlap = qBound(0, overlap, qMin(tileSize.width(), tileSize.height()) / 2);
+
+    const QVector<QRect> tiles = SCodes::tileRects(image.size(), tileSize, overlap);
+    const int tileCount = tiles.size();
+    std::vector<QList<SBarcodeResult> > tileResults(size_t(tileCount));
+    std::vector<QString> tileErrors(size_t(tileCount));
+
+    auto job = std::make_shared<TileJob>();
+
+    // Claims tiles until none is left. Tasks starting after the last tile was claimed return without touching
+    // anything else, they may run after this method returned
+    auto decodeTiles = [&, job, tileCount]() {
+        for (int i = job->next++; i < tileCount; i = job->next++) {
+            const QRect &tile = tiles.at(i);
+            const ImageView tileView(view.data(tile.x(), tile.y()), tile.width(), tile.height(), view.format(),
+                                     view.rowStride(), view.pixStride());
+
+            // Every tile can hold several barcodes, the limit is applied and hits are recorded after merging
+            tileResults[size_t(i)] = readBarcodes(tileView, formats, tile, image.size(), 0xff, tileErrors[size_t(i)],
+                                                  false);
+
+            QMutexLocker locker(&job->mutex);
+
+            if (++job->finished == tileCount) {
+                job->done.wakeAll();
+            }
+        }
+    };
+
+    // Tiles are decoded by the shared decode pool, the calling thread takes its share so it never waits for
+    // workers that are busy, or for itself when called from a worker
+    const int threads = qMin(tileCount, threadCount > 0 ? threadCount : SCodes::DecodePool::instance().workerCount());
+
+    for (int i = 1; i < threads; ++i) {
+        SCodes::DecodePool::instance().submit(decodeTiles);
+    }
+
+    decodeTiles();
+
+    {
+        QMutexLocker locker(&job->mutex);
+
+        while (job->finished < tileCount) {
+            job->done.wait(&job->mutex);
+        }
+    }
+
+    for (const auto &error : tileErrors) {
+        if (!error.isEmpty()) {
+            emit errorOccured(error);
+            break;
+        }
+    }
+
+    QList<SBarcodeResult> barcodes = SCodes::mergeTileResults(tileResults, image.size());
+
+    if (!m_multiResult && barcodes.size() > 1) {
+        barcodes = barcodes.mid(0, 1);
+    }
+
+    recordHits(barcodes);
+
+    // The image counts as one frame for the consensus and repeat suppression, like images passed to process()
+    reportResults(barcodes);
+
+    return barcodes;
 }
 
+#ifndef SCODES_CORE_ONLY
 QImage SBarcodeDecoder::videoFrameToImage(const QVideoFrame &videoFrame, const QRect &captureRect) const
 {
+    SCODES_TRACE("SBarcodeDecoder::videoFrameToImage");
 
     #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 
@@ -194,28 +1169,18 @@ QImage SBarcodeDecoder::videoFrameToImage(const QVideoFrame &videoFrame, const Q
     }
 
     if (handleType == QAbstractVideoBuffer::GLTextureHandle) {
-        QImage image(videoFrame.width(), videoFrame.height(), QImage::Format_ARGB32);
-
-        GLuint textureId = static_cast<GLuint>(videoFrame.handle().toInt());
-
-        QOpenGLContext *ctx = QOpenGLContext::currentContext();
-
-        QOpenGLFunctions *f = ctx->functions();
-
-        GLuint fbo;
+        const QRect frameRect(QPoint(0, 0), videoFrame.size());
+        const QRect rect = captureRect.isEmpty() ? frameRect : captureRect.intersected(frameRect);
 
-        f->glGenFramebuffers(1, &fbo);
+        if (rect.isEmpty()) {
+            return QImage();
+        }
 
-        GLint prevFbo;
+        QImage image(rect.size(), QImage::Format_ARGB32);
 
-        f->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFbo);
-        f->glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        f->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
-        f->glReadPixels(0, 0, videoFrame.width(), videoFrame.height(), GL_RGBA, GL_UNSIGNED_BYTE, image.bits());
-        f->glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>( prevFbo ) );
-        f->glDeleteFramebuffers(1,&fbo);
+        readTexture(static_cast<GLuint>(videoFrame.handle().toInt()), rect, image.bits());
 
-        return image.rgbSwapped().copy(captureRect);
+        return image.rgbSwapped();
     }
 
     #else
@@ -227,12 +1192,226 @@ QImage SBarcodeDecoder::videoFrameToImage(const QVideoFrame &videoFrame, const Q
 
 }
 
+QImage SBarcodeDecoder::videoFrameToLuminance(const QVideoFrame &videoFrame, const QRect &captureRect)
+{
+    SCODES_TRACE("SBarcodeDecoder::videoFrameToLuminance");
+
+    const QRect frameRect(QPoint(0, 0), videoFrame.size());
+    const QRect rect = captureRect.isEmpty() ? frameRect : captureRect.intersected(frameRect);
+
+    if (rect.isEmpty()) {
+        return QImage();
+    }
+
+    SCodes::LatencyTimer conversionTimer(SCodes::DecodeMetrics::instance().conversionTime);
+
+    QImage luminance = m_bufferPool.image(rect.size(), QImage::Format_Grayscale8);
+
+    int offset = 0;
+    int pixStride = 1;
+    int red = 0;
+    int green = 0;
+    int blue = 0;
+
+    const bool isLuminance = luminanceLayout(videoFrame.pixelFormat(), offset, pixStride);
+    const bool isRgb = !isLuminance && rgbLayout(videoFrame.pixelFormat(), red, green, blue);
+
+    // QVideoFrame is explicitly shared, mapping the copy maps the same buffer
+    QVideoFrame frame(videoFrame);
+
+    if ((isLuminance || isRgb) && frame.map(k_mapReadOnly)) {
+        auto unmapGuard = qScopeGuard([&frame](){ frame.unmap(); });
+
+        const uchar *bits = frame.bits(0);
+        const int rowStride = frame.bytesPerLine(0);
+
+        if (bits != nullptr && rowStride > 0) {
+            if (isLuminance) {
+                copyLuminance(bits + offset + rect.y() * rowStride + rect.x() * pixStride, rowStride, pixStride,
+                              luminance);
+            } else {
+                rgbToLuminance(bits + rect.y() * rowStride + rect.x() * 4, rowStride, red, green, blue, luminance);
+            }
+
+            return luminance;
+        }
+    }
+
+    #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    if (videoFrame.handleType() == QAbstractVideoBuffer::GLTextureHandle) {
+        QImage pixels = m_bufferPool.image(rect.size(), QImage::Format_RGBA8888);
+
+        readTexture(static_cast<GLuint>(videoFrame.handle().toInt()), rect, pixels.bits());
+        rgbToLuminance(pixels.constBits(), pixels.bytesPerLine(), 0, 1, 2, luminance);
+
+        return luminance;
+    }
+    #endif
+
+    // Remaining formats go through Qt's own conversion, which allocates
+    const QImage image = videoFrameToImage(videoFrame, rect);
+
+    if (image.isNull()) {
+        return QImage();
+    }
+
+    rgbToLuminance(image.constBits(), image.bytesPerLine(), k_argb32Red, k_argb32Green, k_argb32Blue, luminance);
+
+    return luminance;
+}
+#endif
+
 void SBarcodeDecoder::setResolution(int w, int h)
 {
-    m_resolution = QSize{w,h};
+    setResolution(QSize{w,h});
 }
 
 void SBarcodeDecoder::setResolution(const QSize& newRes)
 {
     m_resolution = newRes;
 }
+
+void SBarcodeDecoder::reserveFrameBuffers(const QSize &size, QImage::Format format)
+{
+    if (size.isEmpty()) {
+        return;
+    }
+
+    // Same scanline alignment as the images handed out by the pool
+    const int depth = QImage::toPixelFormat(format).bitsPerPixel();
+    const size_t bytesPerLine = size_t((size.width() * depth + 31) / 32) * 4;
+
+    m_bufferPool.reserve(k_pooledFrameBuffers, bytesPerLine * size_t(size.height()));
+}
+
+bool SBarcodeDecoder::multiResult() const
+{
+    return m_multiResult;
+}
+
+void SBarcodeDecoder::setMultiResult(bool multiResult)
+{
+    m_multiResult = multiResult;
+}
+
+bool SBarcodeDecoder::binarizerRace() const
+{
+    return m_binarizerRace;
+}
+
+void SBarcodeDecoder::setBinarizerRace(bool binarizerRace)
+{
+    m_binarizerRace = binarizerRace;
+}
+
+int SBarcodeDecoder::decodeTimeBudget() const
+{
+    return m_decodeTimeBudget;
+}
+
+void SBarcodeDecoder::setDecodeTimeBudget(int milliseconds)
+{
+    m_decodeTimeBudget = qMax(0, milliseconds);
+}
+
+int SBarcodeDecoder::scanlineCount() const
+{
+    return m_scanlineCount;
+}
+
+void SBarcodeDecoder::setScanlineCount(int count)
+{
+    m_scanlineCount = qMax(0, count);
+}
+
+bool SBarcodeDecoder::verticalScanlines() const
+{
+    return m_verticalScanlines;
+}
+
+void SBarcodeDecoder::setVerticalScanlines(bool vertical)
+{
+    m_verticalScanlines = vertical;
+}
+
+bool SBarcodeDecoder::learnedFormats() const
+{
+    return m_learnedFormats;
+}
+
+void SBarcodeDecoder::setLearnedFormats(bool learned)
+{
+    if (m_learnedFormats == learned) {
+        return;
+    }
+
+    // Statistics are read when learning starts and written back when it stops
+    if (learned) {
+        m_formatPriorities.load();
+        m_prioritiesSaveTimer.start();
+    } else {
+        m_prioritiesSaveTimer.stop();
+        m_formatPriorities.saveChanges();
+    }
+
+    m_learnedFormats = learned;
+}
+
+QString SBarcodeDecoder::learnedFormatsKey() const
+{
+    return m_formatPriorities.settingsKey();
+}
+
+void SBarcodeDecoder::setLearnedFormatsKey(const QString &key)
+{
+    if (m_formatPriorities.settingsKey() == key) {
+        return;
+    }
+
+    if (m_learnedFormats) {
+        m_formatPriorities.save();
+        m_formatPriorities.setSettingsKey(key);
+        m_formatPriorities.load();
+    } else {
+        m_formatPriorities.setSettingsKey(key);
+    }
+}
+
+void SBarcodeDecoder::resetLearnedFormats()
+{
+    m_formatPriorities.reset();
+
+    if (m_learnedFormats) {
+        m_formatPriorities.save();
+    }
+}
+
+int SBarcodeDecoder::consensusFrames() const
+{
+    return m_resultFilter.requiredFrames();
+}
+
+void SBarcodeDecoder::setConsensusFrames(int frames)
+{
+    m_resultFilter.setRequiredFrames(frames);
+}
+
+int SBarcodeDecoder::consensusWindow() const
+{
+    return m_resultFilter.windowFrames();
+}
+
+void SBarcodeDecoder::setConsensusWindow(int frames)
+{
+    m_resultFilter.setWindowFrames(frames);
+}
+
+int SBarcodeDecoder::repeatInterval() const
+{
+    return m_resultFilter.repeatInterval();
+}
+
+void SBarcodeDecoder::setRepeatInterval(int milliseconds)
+{
+    m_resultFilter.setRepeatInterval(milliseconds);
+}
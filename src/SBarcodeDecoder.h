@@ -2,12 +2,27 @@
 #define QR_DECODER_H
 
 #include <QObject>
+#include <QImage>
+#include <QDeadlineTimer>
+#include <QTimer>
+
+// Core only builds (see SCODES_BUILD_TOOLS) decode images only and don't depend on Qt Multimedia
+#ifndef SCODES_CORE_ONLY
 #include <QVideoFrame>
 
 #include <QOpenGLContext>
 #include <QOpenGLFunctions>
+#endif
+
+#include <atomic>
 
+#include "ImageView.h"
 #include "SBarcodeFormat.h"
+#include "SBarcodeResult.h"
+#include "private/FormatPriorities.h"
+#include "private/FrameBufferPool.h"
+#include "private/FrameGate.h"
+#include "private/ResultFilter.h"
 
 // Default camera resolution width/height
 #define DEFAULT_RES_W 1080
@@ -28,6 +43,12 @@ public:
      */
     explicit SBarcodeDecoder(QObject *parent = nullptr);
 
+    /*!
+     * \fn ~SBarcodeDecoder()
+     * \brief Destructor, saves the learned format statistics.
+     */
+    ~SBarcodeDecoder() override;
+
     /*!
      * \fn void clean()
      * \brief Sets the captured barcode string to empty.
@@ -46,6 +67,7 @@ public:
      */
     QString captured() const;
 
+#ifndef SCODES_CORE_ONLY
     /*!
      * \fn static QImage videoFrameToImage(QVideoFrame &videoFrame, const QRect &captureRect)
      * \brief Returns image from video frame.
@@ -54,6 +76,18 @@ public:
      */
     QImage videoFrameToImage(const QVideoFrame &videoFrame, const QRect &captureRect) const;
 
+    /*!
+     * \fn QImage videoFrameToLuminance(const QVideoFrame &videoFrame, const QRect &captureRect)
+     * \brief Returns Grayscale8 image of the capture area, backed by a pooled buffer. Frames with luminance or
+     * 32 bit RGB planes and OpenGL textures (Qt5) are converted without any allocation once the pool is warmed
+     * up, the remaining formats are converted by QVideoFrame::toImage(), which allocates. Can be called from any
+     * thread.
+     * \param const QVideoFrame &videoFrame - frame of video data.
+     * \param const QRect &captureRect - capture area rectangle in frame pixels, empty rectangle means whole frame.
+     */
+    QImage videoFrameToLuminance(const QVideoFrame &videoFrame, const QRect &captureRect);
+#endif
+
     /*!
      * \fn void setResolution(const int &w, const int &h)
      * \brief Update camera resolution values
@@ -63,14 +97,273 @@ public:
     void setResolution(const QSize&);
     [[deprecated("Use QSize overload instead")]] void setResolution(int w, int h);
 
+    /*!
+     * \fn void reserveFrameBuffers(const QSize &size, QImage::Format format)
+     * \brief Preallocates the pooled buffers of images converted from frames, for the images the caller's frame
+     * path actually converts to. Can be called from any thread.
+     * \param const QSize &size - size of the converted images, usually the capture area.
+     * \param QImage::Format format - format of the largest converted image, Grayscale8 for luminance.
+     */
+    void reserveFrameBuffers(const QSize &size, QImage::Format format);
+
+    /*!
+     * \fn bool multiResult() const
+     * \brief Returns true if all barcodes in a frame are decoded, not only the first one.
+     */
+    bool multiResult() const;
+
+    /*!
+     * \fn void setMultiResult(bool multiResult)
+     * \brief Enables decoding of all barcodes in a frame. Can be called from any thread.
+     * \param bool multiResult - true to decode all barcodes, false to stop after the first one.
+     */
+    void setMultiResult(bool multiResult);
+
+    /*!
+     * \fn bool binarizerRace() const
+     * \brief Returns true if binarizers race against each other on every decoding pass.
+     */
+    bool binarizerRace() const;
+
+    /*!
+     * \fn void setBinarizerRace(bool binarizerRace)
+     * \brief Enables decoding every pass with local average, global histogram and fixed threshold binarizers
+     * concurrently on a thread pool. The first binarizer finding a barcode wins, the others are cancelled.
+     * Helps with low contrast labels on multi-core devices. Can be called from any thread.
+     * \param bool binarizerRace - true to race binarizers, false to use local average binarizer only.
+     */
+    void setBinarizerRace(bool binarizerRace);
+
+    /*!
+     * \fn int decodeTimeBudget() const
+     * \brief Returns the time in milliseconds after which no further decoding pass is started for a frame.
+     */
+    int decodeTimeBudget() const;
+
+    /*!
+     * \fn void setDecodeTimeBudget(int milliseconds)
+     * \brief Limits the time spent on a single frame. Decoding starts with a cheap pass on a downscaled image
+     * and escalates to more expensive passes only if nothing was found, until the budget is used up.
+     * Can be called from any thread.
+     * \param int milliseconds - time budget, 0 means no limit and all passes are always tried.
+     */
+    void setDecodeTimeBudget(int milliseconds);
+
+    /*!
+     * \fn int scanlineCount() const
+     * \brief Returns number of scanline bands decoded instead of the whole image for linear formats.
+     */
+    int scanlineCount() const;
+
+    /*!
+     * \fn void setScanlineCount(int count)
+     * \brief Enables the scanline mode. When all requested formats are 1D, only the given number of thin
+     * horizontal bands spread over the image are decoded, instead of running the decoding ladder on the whole
+     * image. Can be called from any thread.
+     * \param int count - number of bands, 0 disables the scanline mode.
+     */
+    void setScanlineCount(int count);
+
+    /*!
+     * \fn bool verticalScanlines() const
+     * \brief Returns true if vertical bands are decoded in the scanline mode as well.
+     */
+    bool verticalScanlines() const;
+
+    /*!
+     * \fn void setVerticalScanlines(bool vertical)
+     * \brief Adds vertical bands to the scanline mode, for barcodes rotated by 90 degrees. Can be called from
+     * any thread.
+     * \param bool vertical - true to decode vertical bands too.
+     */
+    void setVerticalScanlines(bool vertical);
+
+    /*!
+     * \fn bool learnedFormats() const
+     * \brief Returns true if the formats decoded most often are tried first.
+     */
+    bool learnedFormats() const;
+
+    /*!
+     * \fn void setLearnedFormats(bool learned)
+     * \brief Enables learned format priorities. Hits are counted per format and, once there are enough of them,
+     * every image is decoded with the few formats covering most hits first. The remaining formats are only tried
+     * if nothing was found. Not used in multi result mode, all formats are needed there. The statistics are
+     * loaded from QSettings when enabled and saved periodically by the thread owning the decoder, when disabled
+     * and on destruction, never by the decoding threads. Must be called from the thread owning the decoder.
+     * \param bool learned - true to try the most likely formats first.
+     */
+    void setLearnedFormats(bool learned);
+
+    /*!
+     * \fn QString learnedFormatsKey() const
+     * \brief Returns the QSettings key of the learned format statistics.
+     */
+    QString learnedFormatsKey() const;
+
+    /*!
+     * \fn void setLearnedFormatsKey(const QString &key)
+     * \brief Sets the QSettings key of the learned format statistics, so decoders scanning different barcodes
+     * keep separate statistics. Can be called from any thread.
+     * \param const QString &key - settings key (default "SCodes/formatHits"), empty to keep statistics in memory.
+     */
+    void setLearnedFormatsKey(const QString &key);
+
+    /*!
+     * \fn void resetLearnedFormats()
+     * \brief Forgets the learned format statistics, e.g. when the scanned barcodes change.
+     */
+    void resetLearnedFormats();
+
+    /*!
+     * \fn int consensusFrames() const
+     * \brief Returns number of frames a barcode has to be decoded in before it is reported.
+     */
+    int consensusFrames() const;
+
+    /*!
+     * \fn void setConsensusFrames(int frames)
+     * \brief Sets number of frames out of the last consensusWindow frames a barcode has to be decoded in before
+     * it is reported by capturedChanged and resultsCaptured signals. Suppresses misreads of single frames.
+     * Can be called from any thread.
+     * \param int frames - number of agreeing frames, 1 reports every decoded barcode.
+     */
+    void setConsensusFrames(int frames);
+
+    /*!
+     * \fn int consensusWindow() const
+     * \brief Returns number of last frames in which the agreeing frames are counted.
+     */
+    int consensusWindow() const;
+
+    /*!
+     * \fn void setConsensusWindow(int frames)
+     * \brief Sets number of last frames in which the agreeing frames are counted. Can be called from any thread.
+     * \param int frames - number of frames.
+     */
+    void setConsensusWindow(int frames);
+
+    /*!
+     * \fn int repeatInterval() const
+     * \brief Returns time in milliseconds within which the same barcode is not reported again.
+     */
+    int repeatInterval() const;
+
+    /*!
+     * \fn void setRepeatInterval(int milliseconds)
+     * \brief Suppresses reports of a barcode seen again within the interval since it was last seen.
+     * Can be called from any thread.
+     * \param int milliseconds - time interval, 0 reports the barcode in every frame.
+     */
+    void setRepeatInterval(int milliseconds);
+
+    /*!
+     * \fn SCodes::FrameGate &frameGate()
+     * \brief Returns the gate rejecting blurred and moving frames, to set its thresholds and read its counters.
+     */
+    SCodes::FrameGate &frameGate();
+    const SCodes::FrameGate &frameGate() const;
+
+#ifndef SCODES_CORE_ONLY
+    /*!
+     * \fn bool acceptFrame(const QVideoFrame &videoFrame, const QRect &captureRect)
+     * \brief Measures sharpness and motion of the capture area on a sparse grid of samples, before any conversion
+     * of the frame. Returns false if the frame should not be decoded. Frames which can't be mapped for reading or
+     * have no luminance or 32 bit RGB plane always pass, so does every frame while the gate has no threshold set.
+     * \param const QVideoFrame &videoFrame - frame of video data.
+     * \param const QRect &captureRect - capture area rectangle in frame pixels, empty rectangle means whole frame.
+     */
+    bool acceptFrame(const QVideoFrame &videoFrame, const QRect &captureRect);
+#endif
+
+    /*!
+     * \fn QList<SBarcodeResult> read(const QImage &image, ZXing::BarcodeFormats formats, QString *error) const
+     * \brief Decodes the image without emitting any signal or changing the decoding state, so it can be called
+     * from several threads at once. Honours multiResult, binarizerRace and decodeTimeBudget settings.
+     * \param const QImage &image - image to be decoded.
+     * \param ZXing::BarcodeFormats formats - barcode formats.
+     * \param QString *error - optionally set to the error message if ZXing failed.
+     * \return decoded barcodes with positions normalized to the image.
+     */
+    QList<SBarcodeResult> read(const QImage &image, ZXing::BarcodeFormats formats, QString *error = nullptr) const;
+
+#ifndef SCODES_CORE_ONLY
+    /*!
+     * \fn QList<SBarcodeResult> readFrame(const QVideoFrame &videoFrame, const QRect &captureRect, ZXing::BarcodeFormats formats, QString *error)
+     * \brief Decodes the capture area of a video frame like processFrame, but without emitting any signal or
+     * passing the results through the result filter, so frames can be decoded on several threads at once.
+     * \param const QVideoFrame &videoFrame - frame of video data.
+     * \param const QRect &captureRect - capture area rectangle in frame pixels, empty rectangle means whole frame.
+     * \param ZXing::BarcodeFormats formats - barcode formats.
+     * \param QString *error - optionally set to the error message if ZXing failed.
+     * \return decoded barcodes, positions normalized to the frame.
+     */
+    QList<SBarcodeResult> readFrame(const QVideoFrame &videoFrame, const QRect &captureRect,
+                                    ZXing::BarcodeFormats formats, QString *error = nullptr);
+#endif
+
+    /*!
+     * \fn void reportResults(const QList<SBarcodeResult> &results)
+     * \brief Passes results of a frame through the result filter and emits capturedChanged and resultsCaptured
+     * for the barcodes to be reported. Results have to be passed in frame order and not concurrently.
+     * \param const QList<SBarcodeResult> &results - barcodes decoded from the frame, empty if nothing was found.
+     */
+    void reportResults(const QList<SBarcodeResult> &results);
+
 public slots:
     /*!
-     * \fn void process(const QImage capturedImage, ZXing::BarcodeFormats formats)
+     * \fn QList<SBarcodeResult> process(const QImage capturedImage, ZXing::BarcodeFormats formats)
      * \brief Processes the image to scan the given barcode format types.
      * \param const QImage capturedImage - captured image.
      * \param ZXing::BarcodeFormats formats - barcode formats.
+     * \return decoded barcodes, positions normalized to the image.
+     */
+    QList<SBarcodeResult> process(const QImage& capturedImage, ZXing::BarcodeFormats formats);
+
+    /*!
+     * \fn QList<SBarcodeResult> process(const QImage &capturedImage, ZXing::BarcodeFormats formats, const QRect &sourceRect, const QSize &frameSize)
+     * \brief Processes the image cropped from a frame, reporting positions in the coordinates of the whole frame.
+     * \param const QImage &capturedImage - captured image.
+     * \param ZXing::BarcodeFormats formats - barcode formats.
+     * \param const QRect &sourceRect - area of the frame covered by the image, in frame pixels.
+     * \param const QSize &frameSize - size of the full frame, used to normalize barcode positions.
+     * \return decoded barcodes, positions normalized to the frame.
+     */
+    QList<SBarcodeResult> process(const QImage &capturedImage, ZXing::BarcodeFormats formats,
+                                  const QRect &sourceRect, const QSize &frameSize);
+
+#ifndef SCODES_CORE_ONLY
+    /*!
+     * \fn QList<SBarcodeResult> processFrame(const QVideoFrame &videoFrame, const QRect &captureRect, ZXing::BarcodeFormats formats)
+     * \brief Processes the capture area of a video frame. Frames whose first plane holds the luminance samples
+     * (planar YUV such as NV12, NV21, YUV420P, YV12, P010 and P016, packed YUYV and UYVY, Y8 and Y16) are mapped
+     * read-only and decoded in place, other frames are decoded from the pooled luminance image of
+     * videoFrameToLuminance.
+     * \param const QVideoFrame &videoFrame - frame of video data.
+     * \param const QRect &captureRect - capture area rectangle in frame pixels, empty rectangle means whole frame.
+     * \param ZXing::BarcodeFormats formats - barcode formats.
+     * \return decoded barcodes, empty list if nothing was found.
      */
-    void process(const QImage& capturedImage, ZXing::BarcodeFormats formats);
+    QList<SBarcodeResult> processFrame(const QVideoFrame &videoFrame, const QRect &captureRect, ZXing::BarcodeFormats formats);
+#endif
+
+    /*!
+     * \fn QList<SBarcodeResult> processTiled(const QImage &capturedImage, ZXing::BarcodeFormats formats, const QSize &tileSize, int overlap, int threadCount)
+     * \brief Processes a large image split into overlapping tiles, decoded concurrently by the calling thread and
+     * the shared decode pool. Barcodes found twice in the tile overlaps are reported once. A barcode is only found
+     * if it fits within a single tile, so the overlap should be larger than the biggest expected barcode. The merged
+     * barcodes are reported through the result filter, like those of process().
+     * \param const QImage &capturedImage - image to be decoded.
+     * \param ZXing::BarcodeFormats formats - barcode formats.
+     * \param const QSize &tileSize - size of a single tile in pixels.
+     * \param int overlap - number of pixels shared by neighbouring tiles.
+     * \param int threadCount - maximum number of threads decoding tiles, 0 means one per decode pool worker.
+     * \return decoded barcodes with positions normalized to the whole image, including those held back by the
+     * result filter.
+     */
+    QList<SBarcodeResult> processTiled(const QImage &capturedImage, ZXing::BarcodeFormats formats,
+                                       const QSize &tileSize = QSize(1024, 1024), int overlap = 256,
+                                       int threadCount = 0);
 
 signals:
     /*!
@@ -85,6 +378,12 @@ signals:
      */
     void capturedChanged(const QString &captured);
 
+    /*!
+     * \brief This signal is emitted once per decoded image with all barcodes found in it.
+     * \param const QList<SBarcodeResult> &results - decoded barcodes, positions are normalized to the full frame.
+     */
+    void resultsCaptured(const QList<SBarcodeResult> &results);
+
     void errorOccured(const QString& errorString);
 
 private:
@@ -99,6 +398,61 @@ private:
     QString m_captured = "";
     QSize m_resolution;
 
+    /*!
+     * \brief Decode all barcodes in a frame instead of the first one
+     */
+    std::atomic<bool> m_multiResult { false };
+
+    /*!
+     * \brief Decode with several binarizers concurrently
+     */
+    std::atomic<bool> m_binarizerRace { false };
+
+    /*!
+     * \brief Time in milliseconds after which no further decoding pass is started, 0 for no limit
+     */
+    std::atomic<int> m_decodeTimeBudget { 0 };
+
+    /*!
+     * \brief Number of scanline bands decoded for linear formats, 0 to decode the whole image
+     */
+    std::atomic<int> m_scanlineCount { 0 };
+
+    /*!
+     * \brief Decode vertical scanline bands as well
+     */
+    std::atomic<bool> m_verticalScanlines { false };
+
+    /*!
+     * \brief Try the formats decoded most often first
+     */
+    std::atomic<bool> m_learnedFormats { false };
+
+    /*!
+     * \brief Hit statistics of the formats, updated by the const decoding methods
+     */
+    mutable SCodes::FormatPriorities m_formatPriorities;
+
+    /*!
+     * \brief Saves changed format statistics while learning, decoding threads only count the hits
+     */
+    QTimer m_prioritiesSaveTimer;
+
+    /*!
+     * \brief Consensus and repeat suppression of results reported for consecutive frames
+     */
+    SCodes::ResultFilter m_resultFilter;
+
+    /*!
+     * \brief Rejects blurred and moving frames before decoding
+     */
+    SCodes::FrameGate m_frameGate;
+
+    /*!
+     * \brief Recycled buffers of images converted from frames
+     */
+    SCodes::FrameBufferPool m_bufferPool;
+
     /*!
      * \fn void setCaptured(const QString &captured)
      * \brief Sets captured barcode string.
@@ -106,6 +460,72 @@ private:
      */
     void setCaptured(const QString &captured);
 
+    /*!
+     * \fn QList<SBarcodeResult> decode(const ZXing::ImageView &image, ZXing::BarcodeFormats formats, const QRect &sourceRect, const QSize &frameSize)
+     * \brief Runs ZXing on the image view and reports the results passing the result filter.
+     * \param const ZXing::ImageView &image - view of the pixels to be decoded.
+     * \param ZXing::BarcodeFormats formats - barcode formats.
+     * \param const QRect &sourceRect - area of the frame covered by the image view, in frame pixels.
+     * \param const QSize &frameSize - size of the full frame, used to normalize barcode positions.
+     * \return all decoded barcodes, including the filtered ones.
+     */
+    QList<SBarcodeResult> decode(const ZXing::ImageView &image, ZXing::BarcodeFormats formats,
+                                 const QRect &sourceRect, const QSize &frameSize);
+
+    /*!
+     * \fn QList<SBarcodeResult> readBarcodes(const ZXing::ImageView &image, ZXing::BarcodeFormats formats, const QRect &sourceRect, const QSize &frameSize, int maxSymbols, QString &error, bool record) const
+     * \brief Decodes the image view with the scanline mode or the decoding ladder, trying the learned likely
+     * formats first, without reporting anything. Safe to call concurrently.
+     * \param const ZXing::ImageView &image - view of the pixels to be decoded.
+     * \param ZXing::BarcodeFormats formats - barcode formats.
+     * \param const QRect &sourceRect - area of the frame covered by the image view, in frame pixels.
+     * \param const QSize &frameSize - size of the full frame, used to normalize barcode positions.
+     * \param int maxSymbols - maximum number of barcodes to be decoded.
+     * \param QString &error - set to the error message if ZXing failed.
+     * \param bool record - false if the caller records the hits itself, e.g. once results of all tiles are merged.
+     */
+    QList<SBarcodeResult> readBarcodes(const ZXing::ImageView &image, ZXing::BarcodeFormats formats,
+                                       const QRect &sourceRect, const QSize &frameSize,
+                                       int maxSymbols, QString &error, bool record = true) const;
+
+    /*!
+     * \fn void recordHits(const QList<SBarcodeResult> &barcodes) const
+     * \brief Counts the decoded barcodes in the decode metrics and the learned format statistics.
+     */
+    void recordHits(const QList<SBarcodeResult> &barcodes) const;
+
+    /*!
+     * \fn QList<SBarcodeResult> readLadder(const ZXing::ImageView &image, ZXing::BarcodeFormats formats, const QRect &sourceRect, const QSize &frameSize, int maxSymbols, const QDeadlineTimer &deadline, QString &error) const
+     * \brief Runs the decoding ladder on the image view, from the cheapest pass on the luminance pyramid to the
+     * most expensive one, until a barcode is found or the deadline has passed. Safe to call concurrently.
+     * \param const ZXing::ImageView &image - view of the pixels to be decoded.
+     * \param ZXing::BarcodeFormats formats - barcode formats.
+     * \param const QRect &sourceRect - area of the frame covered by the image view, in frame pixels.
+     * \param const QSize &frameSize - size of the full frame, used to normalize barcode positions.
+     * \param int maxSymbols - maximum number of barcodes to be decoded.
+     * \param const QDeadlineTimer &deadline - no pass is started once it has passed, shared by all reads of a decode.
+     * \param QString &error - set to the error message if ZXing failed.
+     */
+    QList<SBarcodeResult> readLadder(const ZXing::ImageView &image, ZXing::BarcodeFormats formats,
+                                     const QRect &sourceRect, const QSize &frameSize, int maxSymbols,
+                                     const QDeadlineTimer &deadline, QString &error) const;
+
+    /*!
+     * \fn QList<SBarcodeResult> readScanlines(const ZXing::ImageView &image, ZXing::BarcodeFormats formats, const QRect &sourceRect, const QSize &frameSize, int maxSymbols, const QDeadlineTimer &deadline, QString &error) const
+     * \brief Decodes the scanline bands of a luminance image view, used by readBarcodes for linear formats.
+     * Barcodes found by both the horizontal and the vertical bands are reported once. Safe to call concurrently.
+     * \param const ZXing::ImageView &image - view of the luminance samples to be decoded.
+     * \param ZXing::BarcodeFormats formats - linear barcode formats.
+     * \param const QRect &sourceRect - area of the frame covered by the image view, in frame pixels.
+     * \param const QSize &frameSize - size of the full frame, used to normalize barcode positions.
+     * \param int maxSymbols - maximum number of barcodes to be decoded.
+     * \param const QDeadlineTimer &deadline - the vertical bands are skipped once it has passed.
+     * \param QString &error - set to the error message if ZXing failed.
+     */
+    QList<SBarcodeResult> readScanlines(const ZXing::ImageView &image, ZXing::BarcodeFormats formats,
+                                        const QRect &sourceRect, const QSize &frameSize,
+                                        int maxSymbols, const QDeadlineTimer &deadline, QString &error) const;
+
     /*!
      * \fn void setIsDecoding(bool isDecoding)
      * \brief Sets decoding state.
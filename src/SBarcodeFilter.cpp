@@ -5,11 +5,93 @@
 #include <QVideoFilterRunnable>
 
 #include "SBarcodeDecoder.h"
+#include "private/DecodeMetrics.h"
+#include "private/GlLumaReader.h"
+#include "private/Trace.h"
 #include "private/debug.h"
 
-void processImage(SBarcodeDecoder *decoder, const QImage &image, ZXing::BarcodeFormats formats)
+void processImage(SBarcodeDecoder *decoder, SCodes::RoiTracker *roiTracker, const QImage &image, const QRect &region,
+                  const QSize &frameSize, ZXing::BarcodeFormats formats, quint64 frameId)
 {
-    decoder->process(image, formats);
+    SCodes::TraceFrame traceFrame(frameId);
+    SCODES_TRACE("processImage");
+
+    // The cropped image covers the region of the frame, positions are mapped back to the whole frame
+    const auto results = decoder->process(image, formats, region, frameSize);
+    roiTracker->update(results, frameSize);
+    ++SCodes::DecodeMetrics::instance().framesProcessed;
+
+    // Marks when the GUI thread got to the queued results, they are delivered just before
+    if (SCodes::Trace::isEnabled() && !results.isEmpty()) {
+        QMetaObject::invokeMethod(decoder, [frameId]() {
+            const auto now = SCodes::Trace::now();
+            SCodes::Trace::record("SBarcodeFilter::resultsDelivered", now, now, frameId);
+        }, Qt::QueuedConnection);
+    }
+}
+
+/*!
+ * \fn void notifyFrameGate(SBarcodeFilter *filter)
+ * \brief Emits frameGateChanged on the filter's thread, so the gate properties are never read by QML bindings
+ * running on a worker. Not delivered once the filter is destroyed.
+ */
+void notifyFrameGate(SBarcodeFilter *filter)
+{
+    QMetaObject::invokeMethod(filter, [filter]() { emit filter->frameGateChanged(); }, Qt::QueuedConnection);
+}
+
+/*!
+ * \fn void processTexture(SBarcodeFilter *filter, const QImage &luminance, const QRect &region, const QSize &frameSize, ZXing::BarcodeFormats formats, quint64 frameId)
+ * \brief Gates and decodes luminance read from an OpenGL texture frame, runs on a worker thread.
+ */
+void processTexture(SBarcodeFilter *filter, const QImage &luminance, const QRect &region, const QSize &frameSize,
+                    ZXing::BarcodeFormats formats, quint64 frameId)
+{
+    SBarcodeDecoder *decoder = filter->getDecoder();
+
+    // Texture frames can't be measured before the readback, the luminance of the region is measured instead
+    if (decoder->frameGate().isEnabled() && !luminance.isNull()) {
+        const bool accepted = decoder->frameGate().accept({ luminance.constBits(), luminance.width(),
+                                                            luminance.height(), int(luminance.bytesPerLine()), 1 });
+        notifyFrameGate(filter);
+
+        if (!accepted) {
+            ++SCodes::DecodeMetrics::instance().framesDropped;
+            return;
+        }
+    }
+
+    processImage(decoder, filter->roiTracker(), luminance, region, frameSize, formats, frameId);
+}
+
+/*!
+ * \fn void processVideoFrame(SBarcodeFilter *filter, const QVideoFrame &frame, const QRect &area, ZXing::BarcodeFormats formats, quint64 frameId)
+ * \brief Gates, converts and decodes the capture area of a frame in CPU memory, runs on a worker thread.
+ */
+void processVideoFrame(SBarcodeFilter *filter, const QVideoFrame &frame, const QRect &area,
+                       ZXing::BarcodeFormats formats, quint64 frameId)
+{
+    SCodes::TraceFrame traceFrame(frameId);
+    SCODES_TRACE("processVideoFrame");
+
+    SBarcodeDecoder *decoder = filter->getDecoder();
+
+    // Blurred or moving frames are dropped before the conversion
+    if (decoder->frameGate().isEnabled()) {
+        const bool accepted = decoder->acceptFrame(frame, area);
+        notifyFrameGate(filter);
+
+        if (!accepted) {
+            ++SCodes::DecodeMetrics::instance().framesDropped;
+            return;
+        }
+    }
+
+    const QRect region = filter->roiTracker()->region(area);
+
+    // Luminance of the region only, converted into a recycled buffer
+    processImage(decoder, filter->roiTracker(), decoder->videoFrameToLuminance(frame, region), region, frame.size(),
+                 formats, frameId);
 }
 
 /*!
@@ -42,34 +124,115 @@ public:
         Q_UNUSED(surfaceFormat);
         Q_UNUSED(flags);
 
+        SCodes::DecodeMetrics &metrics = SCodes::DecodeMetrics::instance();
+        ++metrics.framesReceived;
+
+        // Frames are numbered on the render thread, the number links the spans of the frame in the trace
+        const quint64 frameId = ++_frameCount;
+        SCodes::TraceFrame traceFrame(frameId);
+        SCODES_TRACE("SBarcodeFilterRunnable::run");
+
+        const QRect frameRect(QPoint(0, 0), input->size());
+        const QRect captureRect = _filter->captureRect().toRect();
+        const QRect area        = captureRect.isEmpty() ? frameRect : captureRect;
+        const GLuint texture = input->handleType() == QAbstractVideoBuffer::GLTextureHandle
+          ? static_cast<GLuint>(input->handle().toInt())
+          : 0;
+        const bool gpuLuminance = texture != 0 && _lumaReader.initialize();
+
+        // The capture area is converted into pooled buffers, textures through an RGBA readback unless the GPU
+        // converts them, which uses buffers of its own
+        if (!gpuLuminance) {
+            reserveFrameBuffers(area.intersected(frameRect).size(),
+                                texture != 0 ? QImage::Format_RGBA8888 : QImage::Format_Grayscale8);
+        }
+
+        // Readback of every texture is started right away, so the one taken below is a single frame old
+        if (gpuLuminance && _lumaReader.isAsync()) {
+            _lumaReader.start(texture, input->size(), _filter->roiTracker()->region(area).intersected(frameRect));
+        }
+
         if (_filter->getDecoder()->isDecoding()) {
+            ++metrics.framesDropped;
             return *input;
         }
 
+        // Gating, conversion and decoding of one frame at a time, they share the decoder's gate and buffers
         if (_filter->getImageFuture().isRunning()) {
+            ++metrics.framesDropped;
+            return *input;
+        }
+
+        // Frames in CPU memory are only referenced here, gating, conversion and cropping run on the worker
+        // We can copy QVideoFrame as it's explicitly shared, the buffer lives as long as any copy
+        if (texture == 0) {
+            _filter->setImageFuture(
+              QtConcurrent::run(processVideoFrame, _filter, *input, area, _filter->zxingFormat(), frameId));
+
             return *input;
         }
 
-        const QImage croppedCapturedImage =
-            _filter->getDecoder()->videoFrameToImage(*input, _filter->captureRect().toRect());
-        _filter->getImageFuture() =
-          QtConcurrent::run(processImage, _filter->getDecoder(), croppedCapturedImage,
-            SCodes::toZXingFormat(_filter->format()));
+        QRect region = _filter->roiTracker()->region(area);
+        QSize frameSize = input->size();
+        QImage croppedCapturedImage;
+
+        // Textures can only be read on the render thread, so just the luminance of the region is read here. It is
+        // converted on the GPU, without stalling the render thread if the previous frame's readback can be taken
+        if (gpuLuminance && _lumaReader.isAsync()) {
+            // The taken luminance belongs to an earlier frame, its region and size are used for the positions
+            if (!_lumaReader.take(croppedCapturedImage, region, frameSize)) {
+                ++metrics.framesDropped;
+                return *input;
+            }
+        } else if (gpuLuminance
+                   && _lumaReader.read(texture, input->size(), region.intersected(frameRect), croppedCapturedImage)) {
+            region = region.intersected(frameRect);
+        } else {
+            croppedCapturedImage = _filter->getDecoder()->videoFrameToLuminance(*input, region);
+        }
 
+        _filter->setImageFuture(
+          QtConcurrent::run(processTexture, _filter, croppedCapturedImage, region, frameSize,
+                            _filter->zxingFormat(), frameId));
 
         return *input;
     }
 
 private:
+    /*!
+     * \fn void reserveFrameBuffers(const QSize &size, QImage::Format format)
+     * \brief Preallocates the decoder's frame buffers whenever the size or format of the converted images changes.
+     */
+    void reserveFrameBuffers(const QSize &size, QImage::Format format)
+    {
+        if (size == _reservedSize && format == _reservedFormat) {
+            return;
+        }
+
+        _filter->getDecoder()->reserveFrameBuffers(size, format);
+        _reservedSize   = size;
+        _reservedFormat = format;
+    }
+
     SBarcodeFilter *_filter;
+    quint64 _frameCount = 0;
+    QSize _reservedSize;
+    QImage::Format _reservedFormat = QImage::Format_Invalid;
+    /// Converts OpenGL textures of the render thread to luminance, lives and dies on that thread
+    SCodes::GlLumaReader _lumaReader;
 };
 
 
 SBarcodeFilter::SBarcodeFilter(QObject *parent)
     : QAbstractVideoFilter{parent},
-    _decoder{new SBarcodeDecoder}
+    _decoder{new SBarcodeDecoder},
+    _resultsModel{new SBarcodeResultsModel(this)}
 {
     connect(_decoder, &SBarcodeDecoder::capturedChanged, this, &SBarcodeFilter::setCaptured);
+    connect(_decoder, &SBarcodeDecoder::resultsCaptured, this, [this](const QList<SBarcodeResult> &results){
+        _resultsModel->append(results);
+        emit resultsCaptured(toVariantList(results));
+    });
 
     connect(this, &QAbstractVideoFilter::activeChanged, this, [this](){
         if (this->isActive()) {
@@ -78,6 +241,12 @@ SBarcodeFilter::SBarcodeFilter(QObject *parent)
     });
 }
 
+SBarcodeFilter::~SBarcodeFilter()
+{
+    // The worker refers to this filter, its decoder and region tracker
+    _imageFuture.waitForFinished();
+}
+
 QVideoFilterRunnable *SBarcodeFilter::createFilterRunnable()
 {
     sDebug() << "FILTER CREATED!";
@@ -119,6 +288,7 @@ void SBarcodeFilter::setCaptureRect(const QRectF &captureRect)
     }
 
     m_captureRect = captureRect;
+    m_roiTracker.reset();
 
     emit captureRectChanged(m_captureRect);
 }
@@ -128,11 +298,21 @@ SBarcodeDecoder *SBarcodeFilter::getDecoder() const
     return _decoder;
 }
 
+SBarcodeResultsModel *SBarcodeFilter::resultsModel() const
+{
+    return _resultsModel;
+}
+
 QFuture<void> SBarcodeFilter::getImageFuture() const
 {
     return _imageFuture;
 }
 
+void SBarcodeFilter::setImageFuture(const QFuture<void> &future)
+{
+    _imageFuture = future;
+}
+
 const SCodes::SBarcodeFormats &SBarcodeFilter::format() const
 {
     return m_format;
@@ -144,6 +324,206 @@ void SBarcodeFilter::setFormat(const SCodes::SBarcodeFormats &format)
 
     if (m_format != format) {
         m_format = format;
+        m_zxingFormat = SCodes::toZXingFormat(m_format);
         emit formatChanged(m_format);
     }
 }
+
+ZXing::BarcodeFormats SBarcodeFilter::zxingFormat() const
+{
+    return m_zxingFormat;
+}
+
+bool SBarcodeFilter::multiResult() const
+{
+    return _decoder->multiResult();
+}
+
+void SBarcodeFilter::setMultiResult(bool multiResult)
+{
+    if (_decoder->multiResult() != multiResult) {
+        _decoder->setMultiResult(multiResult);
+        emit multiResultChanged(multiResult);
+    }
+}
+
+int SBarcodeFilter::decodeTimeBudget() const
+{
+    return _decoder->decodeTimeBudget();
+}
+
+void SBarcodeFilter::setDecodeTimeBudget(int milliseconds)
+{
+    if (_decoder->decodeTimeBudget() != milliseconds) {
+        _decoder->setDecodeTimeBudget(milliseconds);
+        emit decodeTimeBudgetChanged(_decoder->decodeTimeBudget());
+    }
+}
+
+int SBarcodeFilter::scanlineCount() const
+{
+    return _decoder->scanlineCount();
+}
+
+void SBarcodeFilter::setScanlineCount(int count)
+{
+    if (_decoder->scanlineCount() != count) {
+        _decoder->setScanlineCount(count);
+        emit scanlineCountChanged(_decoder->scanlineCount());
+    }
+}
+
+bool SBarcodeFilter::verticalScanlines() const
+{
+    return _decoder->verticalScanlines();
+}
+
+void SBarcodeFilter::setVerticalScanlines(bool vertical)
+{
+    if (_decoder->verticalScanlines() != vertical) {
+        _decoder->setVerticalScanlines(vertical);
+        emit verticalScanlinesChanged(vertical);
+    }
+}
+
+bool SBarcodeFilter::learnedFormats() const
+{
+    return _decoder->learnedFormats();
+}
+
+void SBarcodeFilter::setLearnedFormats(bool learned)
+{
+    if (_decoder->learnedFormats() != learned) {
+        _decoder->setLearnedFormats(learned);
+        emit learnedFormatsChanged(learned);
+    }
+}
+
+bool SBarcodeFilter::binarizerRace() const
+{
+    return _decoder->binarizerRace();
+}
+
+void SBarcodeFilter::setBinarizerRace(bool binarizerRace)
+{
+    if (_decoder->binarizerRace() != binarizerRace) {
+        _decoder->setBinarizerRace(binarizerRace);
+        emit binarizerRaceChanged(binarizerRace);
+    }
+}
+
+bool SBarcodeFilter::roiTracking() const
+{
+    return m_roiTracker.isEnabled();
+}
+
+void SBarcodeFilter::setRoiTracking(bool roiTracking)
+{
+    if (m_roiTracker.isEnabled() != roiTracking) {
+        m_roiTracker.setEnabled(roiTracking);
+        emit roiTrackingChanged(roiTracking);
+    }
+}
+
+int SBarcodeFilter::roiMaxMisses() const
+{
+    return m_roiTracker.maxMisses();
+}
+
+void SBarcodeFilter::setRoiMaxMisses(int roiMaxMisses)
+{
+    if (m_roiTracker.maxMisses() != roiMaxMisses) {
+        m_roiTracker.setMaxMisses(roiMaxMisses);
+        emit roiMaxMissesChanged(m_roiTracker.maxMisses());
+    }
+}
+
+int SBarcodeFilter::consensusFrames() const
+{
+    return _decoder->consensusFrames();
+}
+
+void SBarcodeFilter::setConsensusFrames(int frames)
+{
+    if (_decoder->consensusFrames() != frames) {
+        _decoder->setConsensusFrames(frames);
+        emit consensusFramesChanged(_decoder->consensusFrames());
+    }
+}
+
+int SBarcodeFilter::consensusWindow() const
+{
+    return _decoder->consensusWindow();
+}
+
+void SBarcodeFilter::setConsensusWindow(int frames)
+{
+    if (_decoder->consensusWindow() != frames) {
+        _decoder->setConsensusWindow(frames);
+        emit consensusWindowChanged(_decoder->consensusWindow());
+    }
+}
+
+int SBarcodeFilter::repeatInterval() const
+{
+    return _decoder->repeatInterval();
+}
+
+void SBarcodeFilter::setRepeatInterval(int milliseconds)
+{
+    if (_decoder->repeatInterval() != milliseconds) {
+        _decoder->setRepeatInterval(milliseconds);
+        emit repeatIntervalChanged(_decoder->repeatInterval());
+    }
+}
+
+qreal SBarcodeFilter::sharpnessThreshold() const
+{
+    return _decoder->frameGate().sharpnessThreshold();
+}
+
+void SBarcodeFilter::setSharpnessThreshold(qreal threshold)
+{
+    if (_decoder->frameGate().sharpnessThreshold() != threshold) {
+        _decoder->frameGate().setSharpnessThreshold(threshold);
+        emit sharpnessThresholdChanged(_decoder->frameGate().sharpnessThreshold());
+    }
+}
+
+qreal SBarcodeFilter::motionThreshold() const
+{
+    return _decoder->frameGate().motionThreshold();
+}
+
+void SBarcodeFilter::setMotionThreshold(qreal threshold)
+{
+    if (_decoder->frameGate().motionThreshold() != threshold) {
+        _decoder->frameGate().setMotionThreshold(threshold);
+        emit motionThresholdChanged(_decoder->frameGate().motionThreshold());
+    }
+}
+
+qreal SBarcodeFilter::frameSharpness() const
+{
+    return _decoder->frameGate().sharpness();
+}
+
+qreal SBarcodeFilter::frameMotion() const
+{
+    return _decoder->frameGate().motion();
+}
+
+int SBarcodeFilter::blurredFrames() const
+{
+    return _decoder->frameGate().blurredFrames();
+}
+
+int SBarcodeFilter::movingFrames() const
+{
+    return _decoder->frameGate().movingFrames();
+}
+
+SCodes::RoiTracker *SBarcodeFilter::roiTracker()
+{
+    return &m_roiTracker;
+}
@@ -7,6 +7,8 @@
 
 #include "SBarcodeDecoder.h"
 #include "SBarcodeFormat.h"
+#include "SBarcodeResultsModel.h"
+#include "private/RoiTracker.h"
 
 /*!
  * \brief The SBarcodeFilter class is a custom class that allows image processing with the cooperation of QML VideoOutput type.
@@ -15,8 +17,26 @@ class SBarcodeFilter : public QAbstractVideoFilter
 {
     Q_OBJECT
     Q_PROPERTY(QString captured READ captured NOTIFY capturedChanged)
+    Q_PROPERTY(SBarcodeResultsModel* resultsModel READ resultsModel CONSTANT)
     Q_PROPERTY(QRectF captureRect READ captureRect WRITE setCaptureRect NOTIFY captureRectChanged)
     Q_PROPERTY(SCodes::SBarcodeFormats format READ format WRITE setFormat NOTIFY formatChanged)
+    Q_PROPERTY(bool multiResult READ multiResult WRITE setMultiResult NOTIFY multiResultChanged)
+    Q_PROPERTY(bool binarizerRace READ binarizerRace WRITE setBinarizerRace NOTIFY binarizerRaceChanged)
+    Q_PROPERTY(int decodeTimeBudget READ decodeTimeBudget WRITE setDecodeTimeBudget NOTIFY decodeTimeBudgetChanged)
+    Q_PROPERTY(int scanlineCount READ scanlineCount WRITE setScanlineCount NOTIFY scanlineCountChanged)
+    Q_PROPERTY(bool verticalScanlines READ verticalScanlines WRITE setVerticalScanlines NOTIFY verticalScanlinesChanged)
+    Q_PROPERTY(bool learnedFormats READ learnedFormats WRITE setLearnedFormats NOTIFY learnedFormatsChanged)
+    Q_PROPERTY(bool roiTracking READ roiTracking WRITE setRoiTracking NOTIFY roiTrackingChanged)
+    Q_PROPERTY(int roiMaxMisses READ roiMaxMisses WRITE setRoiMaxMisses NOTIFY roiMaxMissesChanged)
+    Q_PROPERTY(int consensusFrames READ consensusFrames WRITE setConsensusFrames NOTIFY consensusFramesChanged)
+    Q_PROPERTY(int consensusWindow READ consensusWindow WRITE setConsensusWindow NOTIFY consensusWindowChanged)
+    Q_PROPERTY(int repeatInterval READ repeatInterval WRITE setRepeatInterval NOTIFY repeatIntervalChanged)
+    Q_PROPERTY(qreal sharpnessThreshold READ sharpnessThreshold WRITE setSharpnessThreshold NOTIFY sharpnessThresholdChanged)
+    Q_PROPERTY(qreal motionThreshold READ motionThreshold WRITE setMotionThreshold NOTIFY motionThresholdChanged)
+    Q_PROPERTY(qreal frameSharpness READ frameSharpness NOTIFY frameGateChanged)
+    Q_PROPERTY(qreal frameMotion READ frameMotion NOTIFY frameGateChanged)
+    Q_PROPERTY(int blurredFrames READ blurredFrames NOTIFY frameGateChanged)
+    Q_PROPERTY(int movingFrames READ movingFrames NOTIFY frameGateChanged)
 
 public:
 
@@ -27,12 +47,24 @@ public:
      */
     explicit SBarcodeFilter(QObject *parent = nullptr);
 
+    /*!
+     * \fn ~SBarcodeFilter()
+     * \brief Destructor, waits for the frame being decoded, the worker refers to the filter.
+     */
+    ~SBarcodeFilter() override;
+
     /*!
      * \fn QString captured() const
      * \brief Returns the captured barcode string.
      */
     QString captured() const;
 
+    /*!
+     * \fn SBarcodeResultsModel *resultsModel() const
+     * \brief Returns the list model of reported barcodes, owned by the filter.
+     */
+    SBarcodeResultsModel *resultsModel() const;
+
     /*!
      * \fn QRectF captureRect() const
      * \brief Returns the capture area rectangle.
@@ -58,6 +90,14 @@ public:
      */
     QFuture<void> getImageFuture() const;
 
+    /*!
+     * \fn void setImageFuture(const QFuture<void> &future)
+     * \brief Keeps the future of the frame being processed, the next frame is dispatched once it finished and the
+     * destructor waits for it.
+     * \param const QFuture<void> &future - future of the worker processing the frame.
+     */
+    void setImageFuture(const QFuture<void> &future);
+
     /*!
      * \fn QVideoFilterRunnable *createFilterRunnable() override
      * \brief Returns instance of the SBarcodeFilterRunnable subclass.
@@ -77,6 +117,215 @@ public:
      */
     void setFormat(const SCodes::SBarcodeFormats &format);
 
+    /*!
+     * \fn ZXing::BarcodeFormats zxingFormat() const
+     * \brief Returns the barcode format translated to ZXing formats, computed when the format is set.
+     */
+    ZXing::BarcodeFormats zxingFormat() const;
+
+    /*!
+     * \fn bool multiResult() const
+     * \brief Returns true if all barcodes in a frame are decoded.
+     */
+    bool multiResult() const;
+
+    /*!
+     * \fn void setMultiResult(bool multiResult)
+     * \brief Enables decoding of all barcodes in a frame, reported by resultsCaptured signal.
+     * \param bool multiResult - true to decode all barcodes, false to stop after the first one.
+     */
+    void setMultiResult(bool multiResult);
+
+    /*!
+     * \fn bool binarizerRace() const
+     * \brief Returns true if several binarizers are raced on every frame.
+     */
+    bool binarizerRace() const;
+
+    /*!
+     * \fn void setBinarizerRace(bool binarizerRace)
+     * \brief Enables decoding every frame with several binarizers concurrently.
+     * \param bool binarizerRace - true to race binarizers.
+     */
+    void setBinarizerRace(bool binarizerRace);
+
+    /*!
+     * \fn int decodeTimeBudget() const
+     * \brief Returns the time in milliseconds after which no further decoding pass is started for a frame.
+     */
+    int decodeTimeBudget() const;
+
+    /*!
+     * \fn void setDecodeTimeBudget(int milliseconds)
+     * \brief Sets the time budget for decoding a single frame.
+     * \param int milliseconds - time budget, 0 means no limit.
+     */
+    void setDecodeTimeBudget(int milliseconds);
+
+    /*!
+     * \fn int scanlineCount() const
+     * \brief Returns number of scanline bands decoded when format holds 1D formats only.
+     */
+    int scanlineCount() const;
+
+    /*!
+     * \fn void setScanlineCount(int count)
+     * \brief Sets number of thin horizontal bands decoded instead of the whole frame when format holds 1D formats
+     * only.
+     * \param int count - number of bands, 0 decodes the whole frame.
+     */
+    void setScanlineCount(int count);
+
+    /*!
+     * \fn bool verticalScanlines() const
+     * \brief Returns true if vertical bands are decoded in the scanline mode as well.
+     */
+    bool verticalScanlines() const;
+
+    /*!
+     * \fn void setVerticalScanlines(bool vertical)
+     * \brief Adds vertical bands to the scanline mode, for barcodes rotated by 90 degrees.
+     * \param bool vertical - true to decode vertical bands too.
+     */
+    void setVerticalScanlines(bool vertical);
+
+    /*!
+     * \fn bool learnedFormats() const
+     * \brief Returns true if the formats decoded most often are tried first.
+     */
+    bool learnedFormats() const;
+
+    /*!
+     * \fn void setLearnedFormats(bool learned)
+     * \brief Tries the formats decoded most often first and the rest of format only after a miss. Hit statistics
+     * are kept in QSettings between runs.
+     * \param bool learned - true to try the most likely formats first.
+     */
+    void setLearnedFormats(bool learned);
+
+    /*!
+     * \fn bool roiTracking() const
+     * \brief Returns true if only the area around the last decoded barcodes is decoded in the following frames.
+     */
+    bool roiTracking() const;
+
+    /*!
+     * \fn void setRoiTracking(bool roiTracking)
+     * \brief Enables tracking of the region of interest around the last decoded barcodes.
+     * \param bool roiTracking - true to track the region of interest.
+     */
+    void setRoiTracking(bool roiTracking);
+
+    /*!
+     * \fn int roiMaxMisses() const
+     * \brief Returns number of frames without barcode after which the whole capture area is decoded again.
+     */
+    int roiMaxMisses() const;
+
+    /*!
+     * \fn void setRoiMaxMisses(int roiMaxMisses)
+     * \brief Sets number of frames without barcode after which the whole capture area is decoded again.
+     * \param int roiMaxMisses - number of frames.
+     */
+    void setRoiMaxMisses(int roiMaxMisses);
+
+    /*!
+     * \fn int consensusFrames() const
+     * \brief Returns number of frames a barcode has to be decoded in before it is reported.
+     */
+    int consensusFrames() const;
+
+    /*!
+     * \fn void setConsensusFrames(int frames)
+     * \brief Sets number of frames out of the last consensusWindow frames a barcode has to be decoded in.
+     * \param int frames - number of agreeing frames.
+     */
+    void setConsensusFrames(int frames);
+
+    /*!
+     * \fn int consensusWindow() const
+     * \brief Returns number of last frames in which the agreeing frames are counted.
+     */
+    int consensusWindow() const;
+
+    /*!
+     * \fn void setConsensusWindow(int frames)
+     * \brief Sets number of last frames in which the agreeing frames are counted.
+     * \param int frames - number of frames.
+     */
+    void setConsensusWindow(int frames);
+
+    /*!
+     * \fn int repeatInterval() const
+     * \brief Returns time in milliseconds within which the same barcode is not reported again.
+     */
+    int repeatInterval() const;
+
+    /*!
+     * \fn void setRepeatInterval(int milliseconds)
+     * \brief Sets time in milliseconds within which the same barcode is not reported again.
+     * \param int milliseconds - time interval, 0 reports the barcode in every frame.
+     */
+    void setRepeatInterval(int milliseconds);
+
+    /*!
+     * \fn qreal sharpnessThreshold() const
+     * \brief Returns the minimum sharpness of decoded frames.
+     */
+    qreal sharpnessThreshold() const;
+
+    /*!
+     * \fn void setSharpnessThreshold(qreal threshold)
+     * \brief Sets the minimum sharpness (mean squared luminance gradient) of decoded frames, blurred frames are
+     * skipped before conversion.
+     * \param qreal threshold - sharpness threshold, 0 disables the check.
+     */
+    void setSharpnessThreshold(qreal threshold);
+
+    /*!
+     * \fn qreal motionThreshold() const
+     * \brief Returns the maximum motion of decoded frames.
+     */
+    qreal motionThreshold() const;
+
+    /*!
+     * \fn void setMotionThreshold(qreal threshold)
+     * \brief Sets the maximum motion (mean absolute luminance difference to the previous measured frame, 0-255)
+     * of decoded frames, moving frames are skipped before conversion.
+     * \param qreal threshold - motion threshold, 0 disables the check.
+     */
+    void setMotionThreshold(qreal threshold);
+
+    /*!
+     * \fn qreal frameSharpness() const
+     * \brief Returns sharpness of the last measured frame.
+     */
+    qreal frameSharpness() const;
+
+    /*!
+     * \fn qreal frameMotion() const
+     * \brief Returns motion of the last measured frame.
+     */
+    qreal frameMotion() const;
+
+    /*!
+     * \fn int blurredFrames() const
+     * \brief Returns number of frames skipped as blurred.
+     */
+    int blurredFrames() const;
+
+    /*!
+     * \fn int movingFrames() const
+     * \brief Returns number of frames skipped as moving.
+     */
+    int movingFrames() const;
+
+    /*!
+     * \fn SCodes::RoiTracker *roiTracker()
+     * \brief Returns the region of interest tracker.
+     */
+    SCodes::RoiTracker *roiTracker();
+
 signals:
 
     /*!
@@ -97,6 +346,96 @@ signals:
      */
     void formatChanged(const SCodes::SBarcodeFormats &format);
 
+    /*!
+     * \brief This signal is emitted with all barcodes decoded from a single frame, positions normalized to the frame.
+     * \param const QVariantList &results - list of SBarcodeResult.
+     */
+    void resultsCaptured(const QVariantList &results);
+
+    /*!
+     * \brief This signal is emitted when multi result mode is switched.
+     * \param bool multiResult - multi result mode.
+     */
+    void multiResultChanged(bool multiResult);
+
+    /*!
+     * \brief This signal is emitted when binarizer race is switched.
+     * \param bool binarizerRace - binarizer race mode.
+     */
+    void binarizerRaceChanged(bool binarizerRace);
+
+    /*!
+     * \brief This signal is emitted when decoding time budget is changed.
+     * \param int milliseconds - time budget.
+     */
+    void decodeTimeBudgetChanged(int milliseconds);
+
+    /*!
+     * \brief This signal is emitted when number of scanline bands is changed.
+     * \param int count - number of bands.
+     */
+    void scanlineCountChanged(int count);
+
+    /*!
+     * \brief This signal is emitted when vertical scanline bands are switched.
+     * \param bool vertical - vertical bands state.
+     */
+    void verticalScanlinesChanged(bool vertical);
+
+    /*!
+     * \brief This signal is emitted when learned format priorities are switched.
+     * \param bool learned - learned format priorities state.
+     */
+    void learnedFormatsChanged(bool learned);
+
+    /*!
+     * \brief This signal is emitted when region of interest tracking is switched.
+     * \param bool roiTracking - tracking state.
+     */
+    void roiTrackingChanged(bool roiTracking);
+
+    /*!
+     * \brief This signal is emitted when number of frames without barcode before leaving the region is changed.
+     * \param int roiMaxMisses - number of frames.
+     */
+    void roiMaxMissesChanged(int roiMaxMisses);
+
+    /*!
+     * \brief This signal is emitted when number of agreeing frames is changed.
+     * \param int frames - number of agreeing frames.
+     */
+    void consensusFramesChanged(int frames);
+
+    /*!
+     * \brief This signal is emitted when number of frames in which agreeing frames are counted is changed.
+     * \param int frames - number of frames.
+     */
+    void consensusWindowChanged(int frames);
+
+    /*!
+     * \brief This signal is emitted when repeat suppression interval is changed.
+     * \param int milliseconds - time interval.
+     */
+    void repeatIntervalChanged(int milliseconds);
+
+    /*!
+     * \brief This signal is emitted when sharpness threshold is changed.
+     * \param qreal threshold - sharpness threshold.
+     */
+    void sharpnessThresholdChanged(qreal threshold);
+
+    /*!
+     * \brief This signal is emitted when motion threshold is changed.
+     * \param qreal threshold - motion threshold.
+     */
+    void motionThresholdChanged(qreal threshold);
+
+    /*!
+     * \brief This signal is emitted on the filter's thread after every frame measured by the sharpness and motion
+     * gate, the frames are measured on worker threads.
+     */
+    void frameGateChanged();
+
 private slots:
 
     /*!
@@ -119,9 +458,15 @@ private:
 
     SBarcodeDecoder *_decoder;
 
+    SBarcodeResultsModel *_resultsModel;
+
     QFuture<void> _imageFuture;
 
     SCodes::SBarcodeFormats m_format = SCodes::SBarcodeFormat::Basic;
+
+    ZXing::BarcodeFormats m_zxingFormat = SCodes::toZXingFormat(SCodes::SBarcodeFormats(SCodes::SBarcodeFormat::Basic));
+
+    SCodes::RoiTracker m_roiTracker;
 };
 
 #endif // QRSCANNERFILTER_H
@@ -1,11 +1,21 @@
 #include "SBarcodeFormat.h"
 
+#include <QtAlgorithms>
+
+#include <array>
+
 /*!
- *  Provide access to ZXing::BarcodeFormat's with SCodes::SBarcodeFormat keys
+ *  Provide access to ZXing::BarcodeFormat's with SCodes::SBarcodeFormat keys. Single formats are listed by their
+ *  bit index after None, so they are looked up without searching
  */
 namespace {
-const QMap<SCodes::SBarcodeFormat, ZXing::BarcodeFormat> k_formatsTranslations
-{
+struct FormatTranslation {
+    SCodes::SBarcodeFormat format;
+    ZXing::BarcodeFormat zxingFormat;
+};
+
+constexpr std::array<FormatTranslation, 21> k_formatsTranslations
+{{
     { SCodes::SBarcodeFormat::None, ZXing::BarcodeFormat::None },
     { SCodes::SBarcodeFormat::Aztec, ZXing::BarcodeFormat::Aztec },
     { SCodes::SBarcodeFormat::Codabar, ZXing::BarcodeFormat::Codabar },
@@ -27,12 +37,44 @@ const QMap<SCodes::SBarcodeFormat, ZXing::BarcodeFormat> k_formatsTranslations
     { SCodes::SBarcodeFormat::RMQRCode, ZXing::BarcodeFormat::RMQRCode },
     { SCodes::SBarcodeFormat::DXFilmEdge, ZXing::BarcodeFormat::DXFilmEdge },
     { SCodes::SBarcodeFormat::Any, ZXing::BarcodeFormat::Any },
-};
+}};
+
+static_assert(int(k_formatsTranslations.size()) == SCodes::k_singleFormatCount + 2,
+              "Every single format must be listed between None and Any");
+
+/*!
+ * \fn constexpr bool isOrderedByBit()
+ * \brief Returns true if every single format of the table is stored at its bit index plus one.
+ */
+constexpr bool isOrderedByBit()
+{
+    for (int i = 0; i < SCodes::k_singleFormatCount; ++i) {
+        if (int(k_formatsTranslations[size_t(i + 1)].format) != (1 << i)) {
+            return false;
+        }
+    }
+
+    return k_formatsTranslations.front().format == SCodes::SBarcodeFormat::None
+           && k_formatsTranslations.back().format == SCodes::SBarcodeFormat::Any;
+}
+
+static_assert(isOrderedByBit(), "Single formats must be listed by their bit index");
 }
 
 ZXing::BarcodeFormat SCodes::toZXingFormat(SBarcodeFormat format)
 {
-    return k_formatsTranslations[format];
+    const uint value = uint(format);
+
+    if (format == SBarcodeFormat::Any) {
+        return ZXing::BarcodeFormat::Any;
+    }
+
+    // Combined formats other than Any have no single ZXing counterpart
+    if (value == 0 || (value & (value - 1)) != 0 || value >= (1u << k_singleFormatCount)) {
+        return ZXing::BarcodeFormat::None;
+    }
+
+    return k_formatsTranslations[size_t(qCountTrailingZeroBits(value) + 1)].zxingFormat;
 }
 
 QString SCodes::toString(SBarcodeFormat format)
@@ -42,15 +84,14 @@ QString SCodes::toString(SBarcodeFormat format)
 
 SCodes::SBarcodeFormat SCodes::fromString(const QString &formatName)
 {
-    const auto zxingFormat = ZXing::BarcodeFormatFromString(formatName.toStdString());
-
-    QMapIterator<SCodes::SBarcodeFormat, ZXing::BarcodeFormat> it(k_formatsTranslations);
-
-    while (it.hasNext()) {
-        it.next();
+    return fromZXingFormat(ZXing::BarcodeFormatFromString(formatName.toStdString()));
+}
 
-        if (it.value() == zxingFormat) {
-            return it.key();
+SCodes::SBarcodeFormat SCodes::fromZXingFormat(ZXing::BarcodeFormat zxingFormat)
+{
+    for (const auto &translation : k_formatsTranslations) {
+        if (translation.zxingFormat == zxingFormat) {
+            return translation.format;
         }
     }
 
@@ -61,21 +102,35 @@ ZXing::BarcodeFormats SCodes::toZXingFormat(SBarcodeFormats formats)
 {
     ZXing::BarcodeFormats zXingformats;
 
-    int formatEnumIndex = SCodes::staticMetaObject.indexOfEnumerator("SBarcodeFormat");
+    // Any is the only combined format with a ZXing counterpart, it is added when all single formats are set
+    for (const auto &translation : k_formatsTranslations) {
+        if (translation.format != SBarcodeFormat::None && formats.testFlag(translation.format)) {
+            zXingformats |= translation.zxingFormat;
+        }
+    }
 
-    QMetaEnum sBarcodeFormatEnumMeta = SCodes::staticMetaObject.enumerator(formatEnumIndex);
+    return zXingformats;
+}
 
-    for (int i = 0; i < sBarcodeFormatEnumMeta.keyCount(); ++i) {
-        const auto key = sBarcodeFormatEnumMeta.key(i);
+bool SCodes::isLinearOnly(ZXing::BarcodeFormats formats)
+{
+    const SBarcodeFormats linearFormats(SBarcodeFormat::OneDCodes);
+    bool linear = false;
 
-        const auto value = sBarcodeFormatEnumMeta.keyToValue(key);
+    // Single formats are listed between None and Any in the translation table
+    for (int i = 1; i <= k_singleFormatCount; ++i) {
+        const auto &translation = k_formatsTranslations[size_t(i)];
 
-        const auto enumValue = static_cast<SCodes::SBarcodeFormat>(value);
+        if (!formats.testFlag(translation.zxingFormat)) {
+            continue;
+        }
 
-        if (formats.testFlag(enumValue)) {
-            zXingformats |= toZXingFormat(enumValue);
+        if (!linearFormats.testFlag(translation.format)) {
+            return false;
         }
+
+        linear = true;
     }
 
-    return zXingformats;
+    return linear;
 }
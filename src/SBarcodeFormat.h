@@ -1,7 +1,13 @@
 #ifndef SBARCODEFORMAT_H
 #define SBARCODEFORMAT_H
 
+#ifdef SCODES_CORE_ONLY
+#include <QObject>
+#else
 #include <qqml.h>
+#endif
+
+#include <QtAlgorithms>
 
 #include "BarcodeFormat.h"
 
@@ -44,6 +50,14 @@ Q_DECLARE_FLAGS(SBarcodeFormats, SBarcodeFormat)
 Q_DECLARE_OPERATORS_FOR_FLAGS(SBarcodeFormats)
 Q_FLAG_NS(SBarcodeFormats)
 
+/*!
+ *  Number of single formats, one bit of SBarcodeFormat each, so per format tables are indexed by the bit index
+ */
+constexpr int k_singleFormatCount = int(qPopulationCount(quint32(SBarcodeFormat::Any)));
+
+static_assert(int(SBarcodeFormat::Any) == (1 << k_singleFormatCount) - 1,
+              "Single formats must use the lowest bits and be part of SBarcodeFormat::Any");
+
 /*!
  * \fn ZXing::BarcodeFormat toZXingFormat(SBarcodeFormat format)
  * \brief Returns ZXing barcode format for given SCode barcode format.
@@ -58,6 +72,20 @@ ZXing::BarcodeFormat toZXingFormat(SBarcodeFormat format);
  */
 ZXing::BarcodeFormats toZXingFormat(SBarcodeFormats formats);
 
+/*!
+ * \fn bool isLinearOnly(ZXing::BarcodeFormats formats)
+ * \brief Returns true if the formats contain at least one of SBarcodeFormat::OneDCodes and no 2D format.
+ * \param ZXing::BarcodeFormats formats - ZXing barcode formats.
+ */
+bool isLinearOnly(ZXing::BarcodeFormats formats);
+
+/*!
+ * \fn SBarcodeFormat fromZXingFormat(ZXing::BarcodeFormat format)
+ * \brief Returns SCodes barcode format for given ZXing barcode format.
+ * \param ZXing::BarcodeFormat format - ZXing barcode format.
+ */
+SBarcodeFormat fromZXingFormat(ZXing::BarcodeFormat format);
+
 /*!
  * \fn QString toString(SBarcodeFormat format)
  * \brief Returns format string for given SCode barcode format.
@@ -10,7 +10,7 @@
 #endif
 #endif
 
-#include "MultiFormatWriter.h"
+#include "private/BarcodeEncoder.h"
 
 SBarcodeGenerator::SBarcodeGenerator(QQuickItem *parent)
     : QQuickItem(parent)
@@ -31,23 +31,8 @@ bool SBarcodeGenerator::generate(const QString &inputString)
                 }
             }
 
-            ZXing::MultiFormatWriter writer = ZXing::MultiFormatWriter(SCodes::toZXingFormat(m_format))
-                                                  .setMargin(m_margin)
-                                                  .setEccLevel(m_eccLevel);
-
-            auto qrCodeMatrix = writer.encode(inputString.toStdString(), m_width, m_height);
-
-            QImage image(m_width, m_height, QImage::Format_ARGB32);
-
-            for (int y = 0; y < m_height; ++y) {
-                for (int x = 0; x < m_width; ++x) {
-                    if (qrCodeMatrix.get(x, y)) {
-                        image.setPixelColor(x, y, m_foregroundColor);
-                    } else {
-                        image.setPixelColor(x, y, m_backgroundColor);
-                    }
-                }
-            }
+            QImage image = SCodes::encodeBarcode(m_format, inputString, m_width, m_height, m_margin, m_eccLevel,
+                                                 m_foregroundColor, m_backgroundColor);
 
             // Center images works only on QR codes.
             if (m_format == SCodes::SBarcodeFormat::QRCode) {
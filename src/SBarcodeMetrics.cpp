@@ -0,0 +1,180 @@
+#include "SBarcodeMetrics.h"
+
+#include <QFile>
+
+#include "private/DecodeMetrics.h"
+#include "private/Trace.h"
+
+namespace {
+/*!
+ *  Default refresh interval of the properties in milliseconds
+ */
+constexpr int k_defaultUpdateInterval = 1000;
+
+/*!
+ * \fn SBarcodeMetrics::Latency summarize(const SCodes::LatencyHistogram &histogram)
+ * \brief Returns summary of the histogram converted to milliseconds.
+ */
+SBarcodeMetrics::Latency summarize(const SCodes::LatencyHistogram &histogram)
+{
+    SBarcodeMetrics::Latency latency;
+    latency.count = histogram.count();
+    latency.mean  = histogram.mean() / 1000.0;
+    latency.p50   = histogram.percentile(0.5) / 1000.0;
+    latency.p90   = histogram.percentile(0.9) / 1000.0;
+    latency.p99   = histogram.percentile(0.99) / 1000.0;
+    latency.max   = histogram.max() / 1000.0;
+
+    return latency;
+}
+}
+
+SBarcodeMetrics::SBarcodeMetrics(QObject *parent)
+    : QObject(parent)
+    , m_snapshot(snapshot())
+{
+    connect(&m_timer, &QTimer::timeout, this, &SBarcodeMetrics::refresh);
+    m_timer.start(k_defaultUpdateInterval);
+}
+
+SBarcodeMetrics::Snapshot SBarcodeMetrics::snapshot()
+{
+    const auto &metrics = SCodes::DecodeMetrics::instance();
+
+    Snapshot snapshot;
+    snapshot.framesReceived  = metrics.framesReceived.load(std::memory_order_relaxed);
+    snapshot.framesProcessed = metrics.framesProcessed.load(std::memory_order_relaxed);
+    snapshot.framesDropped   = metrics.framesDropped.load(std::memory_order_relaxed);
+    snapshot.conversionTime  = summarize(metrics.conversionTime);
+    snapshot.decodeTime      = summarize(metrics.decodeTime);
+
+    for (int i = 0; i < SCodes::k_singleFormatCount; ++i) {
+        if (const quint64 hits = metrics.hits(i)) {
+            snapshot.formatHits.insert(static_cast<SCodes::SBarcodeFormat>(1 << i), hits);
+        }
+    }
+
+    return snapshot;
+}
+
+void SBarcodeMetrics::resetAll()
+{
+    SCodes::DecodeMetrics::instance().reset();
+}
+
+QByteArray SBarcodeMetrics::traceJson()
+{
+    return QByteArray::fromStdString(SCodes::Trace::toJson());
+}
+
+qint64 SBarcodeMetrics::framesReceived() const
+{
+    return qint64(m_snapshot.framesReceived);
+}
+
+qint64 SBarcodeMetrics::framesProcessed() const
+{
+    return qint64(m_snapshot.framesProcessed);
+}
+
+qint64 SBarcodeMetrics::framesDropped() const
+{
+    return qint64(m_snapshot.framesDropped);
+}
+
+qreal SBarcodeMetrics::conversionTimeP50() const
+{
+    return m_snapshot.conversionTime.p50;
+}
+
+qreal SBarcodeMetrics::conversionTimeP99() const
+{
+    return m_snapshot.conversionTime.p99;
+}
+
+qreal SBarcodeMetrics::decodeTimeP50() const
+{
+    return m_snapshot.decodeTime.p50;
+}
+
+qreal SBarcodeMetrics::decodeTimeP99() const
+{
+    return m_snapshot.decodeTime.p99;
+}
+
+QVariantMap SBarcodeMetrics::formatHits() const
+{
+    QVariantMap hits;
+
+    for (auto it = m_snapshot.formatHits.cbegin(); it != m_snapshot.formatHits.cend(); ++it) {
+        hits.insert(SCodes::toString(it.key()), qint64(it.value()));
+    }
+
+    return hits;
+}
+
+int SBarcodeMetrics::updateInterval() const
+{
+    return m_timer.isActive() ? m_timer.interval() : 0;
+}
+
+void SBarcodeMetrics::setUpdateInterval(int milliseconds)
+{
+    milliseconds = qMax(0, milliseconds);
+
+    if (updateInterval() == milliseconds) {
+        return;
+    }
+
+    if (milliseconds > 0) {
+        m_timer.start(milliseconds);
+    } else {
+        m_timer.stop();
+    }
+
+    emit updateIntervalChanged(milliseconds);
+}
+
+bool SBarcodeMetrics::tracing() const
+{
+    return SCodes::Trace::isEnabled();
+}
+
+void SBarcodeMetrics::setTracing(bool tracing)
+{
+    if (SCodes::Trace::isEnabled() == tracing) {
+        return;
+    }
+
+    SCodes::Trace::setEnabled(tracing);
+    emit tracingChanged(tracing);
+}
+
+bool SBarcodeMetrics::saveTrace(const QString &filePath) const
+{
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    const QByteArray json = traceJson();
+    return file.write(json) == json.size();
+}
+
+void SBarcodeMetrics::clearTrace()
+{
+    SCodes::Trace::clear();
+}
+
+void SBarcodeMetrics::refresh()
+{
+    m_snapshot = snapshot();
+    emit updated();
+}
+
+void SBarcodeMetrics::reset()
+{
+    resetAll();
+    refresh();
+}
@@ -0,0 +1,151 @@
+#ifndef SBARCODEMETRICS_H
+#define SBARCODEMETRICS_H
+
+#include <QMap>
+#include <QObject>
+#include <QTimer>
+#include <QVariantMap>
+
+#ifndef SCODES_CORE_ONLY
+#include <qqml.h>
+#endif
+
+#include "SBarcodeFormat.h"
+
+/*!
+ * \brief The SBarcodeMetrics class exposes decoding metrics collected by all scanners, filters and decoders of the
+ * process. Counting is always on and lock-free, the object only reads the shared registry, periodically for QML
+ * bindings or on demand through snapshot().
+ */
+class SBarcodeMetrics : public QObject
+{
+    Q_OBJECT
+#ifndef SCODES_CORE_ONLY
+    QML_ELEMENT
+#endif
+
+    /// Frames delivered by the camera while scanning
+    Q_PROPERTY(qint64 framesReceived READ framesReceived NOTIFY updated)
+    /// Frames decoded
+    Q_PROPERTY(qint64 framesProcessed READ framesProcessed NOTIFY updated)
+    /// Frames never decoded, because they were replaced by newer ones, too old, blurred or moving
+    Q_PROPERTY(qint64 framesDropped READ framesDropped NOTIFY updated)
+    /// Median time in milliseconds of converting a frame to luminance
+    Q_PROPERTY(qreal conversionTimeP50 READ conversionTimeP50 NOTIFY updated)
+    /// 99th percentile of the conversion time in milliseconds
+    Q_PROPERTY(qreal conversionTimeP99 READ conversionTimeP99 NOTIFY updated)
+    /// Median time in milliseconds of decoding a single image
+    Q_PROPERTY(qreal decodeTimeP50 READ decodeTimeP50 NOTIFY updated)
+    /// 99th percentile of the decoding time in milliseconds
+    Q_PROPERTY(qreal decodeTimeP99 READ decodeTimeP99 NOTIFY updated)
+    /// Number of decoded barcodes by format name, formats without any barcode are left out
+    Q_PROPERTY(QVariantMap formatHits READ formatHits NOTIFY updated)
+    /// Interval in milliseconds in which the properties are refreshed (default 1000, 0 - only by refresh())
+    Q_PROPERTY(int updateInterval READ updateInterval WRITE setUpdateInterval NOTIFY updateIntervalChanged)
+    /// Set to true to record spans of the frame pipeline for saveTrace(), shared by the whole process (default false)
+    Q_PROPERTY(bool tracing READ tracing WRITE setTracing NOTIFY tracingChanged)
+
+public:
+    /*!
+     * \brief Summary of recorded durations, in milliseconds
+     */
+    struct Latency {
+        quint64 count = 0;
+        double mean   = 0.0;
+        double p50    = 0.0;
+        double p90    = 0.0;
+        double p99    = 0.0;
+        double max    = 0.0;
+    };
+
+    /*!
+     * \brief Values of all metrics read at one moment
+     */
+    struct Snapshot {
+        quint64 framesReceived  = 0;
+        quint64 framesProcessed = 0;
+        quint64 framesDropped   = 0;
+        Latency conversionTime;
+        Latency decodeTime;
+        /// Decoded barcodes by format, formats without any barcode are left out
+        QMap<SCodes::SBarcodeFormat, quint64> formatHits;
+    };
+
+    /*!
+     * \fn explicit SBarcodeMetrics(QObject *parent)
+     * \brief Constructor.
+     * \param QObject *parent - a pointer to the parent object.
+     */
+    explicit SBarcodeMetrics(QObject *parent = nullptr);
+
+    /*!
+     * \fn static Snapshot snapshot()
+     * \brief Returns current values of all metrics. Can be called from any thread.
+     */
+    static Snapshot snapshot();
+
+    /*!
+     * \fn static void resetAll()
+     * \brief Sets all metrics of the process to zero. Can be called from any thread.
+     */
+    static void resetAll();
+
+    /*!
+     * \fn static QByteArray traceJson()
+     * \brief Returns the spans recorded while tracing as Chrome trace event JSON, to be opened in
+     * chrome://tracing or ui.perfetto.dev. Spans of the same frame are linked by flow events across threads.
+     * Every thread keeps its latest spans only. Can be called from any thread.
+     */
+    static QByteArray traceJson();
+
+    qint64 framesReceived() const;
+    qint64 framesProcessed() const;
+    qint64 framesDropped() const;
+    qreal conversionTimeP50() const;
+    qreal conversionTimeP99() const;
+    qreal decodeTimeP50() const;
+    qreal decodeTimeP99() const;
+    QVariantMap formatHits() const;
+    int updateInterval() const;
+    void setUpdateInterval(int milliseconds);
+    bool tracing() const;
+    void setTracing(bool tracing);
+
+    /*!
+     * \fn bool saveTrace(const QString &filePath) const
+     * \brief Writes traceJson() to the file.
+     * \param const QString &filePath - path of the file.
+     * \return false if the file could not be written.
+     */
+    Q_INVOKABLE bool saveTrace(const QString &filePath) const;
+
+    /*!
+     * \fn void clearTrace()
+     * \brief Forgets all recorded spans.
+     */
+    Q_INVOKABLE void clearTrace();
+
+public slots:
+    /*!
+     * \fn void refresh()
+     * \brief Reads the metrics and updates the properties.
+     */
+    void refresh();
+
+    /*!
+     * \fn void reset()
+     * \brief Sets all metrics of the process to zero and updates the properties.
+     */
+    void reset();
+
+signals:
+    void updated();
+    void updateIntervalChanged(int milliseconds);
+    void tracingChanged(bool tracing);
+
+private:
+    Snapshot m_snapshot;
+    QTimer m_timer;
+};
+
+#endif // SBARCODEMETRICS_H
@@ -0,0 +1,28 @@
+#include "SBarcodeResult.h"
+
+QVariantList SBarcodeResult::positionPoints() const
+{
+    QVariantList points;
+
+    for (const auto &point : position) {
+        points.append(point);
+    }
+
+    return points;
+}
+
+bool SBarcodeResult::isValid() const
+{
+    return format != SCodes::SBarcodeFormat::None;
+}
+
+QVariantList toVariantList(const QList<SBarcodeResult> &results)
+{
+    QVariantList list;
+
+    for (const auto &result : results) {
+        list.append(QVariant::fromValue(result));
+    }
+
+    return list;
+}
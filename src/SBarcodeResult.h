@@ -0,0 +1,68 @@
+#ifndef SBARCODERESULT_H
+#define SBARCODERESULT_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMetaType>
+#include <QPolygonF>
+#include <QString>
+#include <QVariantList>
+
+#include "SBarcodeFormat.h"
+
+/*!
+ * \brief The SBarcodeResult class describes a single barcode found in an image.
+ */
+class SBarcodeResult
+{
+    Q_GADGET
+    Q_PROPERTY(QString text MEMBER text)
+    Q_PROPERTY(SCodes::SBarcodeFormat format MEMBER format)
+    Q_PROPERTY(QByteArray bytes MEMBER bytes)
+    Q_PROPERTY(QVariantList position READ positionPoints)
+
+public:
+    /*!
+     * \brief Human readable content of the barcode
+     */
+    QString text;
+
+    /*!
+     * \brief Format of the barcode
+     */
+    SCodes::SBarcodeFormat format = SCodes::SBarcodeFormat::None;
+
+    /*!
+     * \brief Raw content of the barcode
+     */
+    QByteArray bytes;
+
+    /*!
+     * \brief Corners of the barcode (top left, top right, bottom right, bottom left) in normalized frame
+     * coordinates (0.0-1.0)
+     */
+    QPolygonF position;
+
+    /*!
+     * \fn QVariantList positionPoints() const
+     * \brief Returns the corners of the barcode as list of points, to be used from QML.
+     */
+    QVariantList positionPoints() const;
+
+    /*!
+     * \fn bool isValid() const
+     * \brief Returns true if result holds a decoded barcode.
+     */
+    bool isValid() const;
+};
+
+/*!
+ * \fn QVariantList toVariantList(const QList<SBarcodeResult> &results)
+ * \brief Returns results wrapped in QVariant, to be passed to QML.
+ * \param const QList<SBarcodeResult> &results - decoded barcodes.
+ */
+QVariantList toVariantList(const QList<SBarcodeResult> &results);
+
+Q_DECLARE_METATYPE(SBarcodeResult)
+
+#endif // SBARCODERESULT_H
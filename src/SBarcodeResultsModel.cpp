@@ -0,0 +1,198 @@
+#include "SBarcodeResultsModel.h"
+
+#include <QMutexLocker>
+
+#include <iterator>
+
+namespace {
+/*!
+ *  Default maximum number of rows
+ */
+constexpr int k_defaultCapacity = 1000;
+
+/*!
+ *  Default time in milliseconds results are collected for before insertion
+ */
+constexpr int k_defaultBatchInterval = 100;
+}
+
+SBarcodeResultsModel::SBarcodeResultsModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_capacity(k_defaultCapacity)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(k_defaultBatchInterval);
+    connect(&m_flushTimer, &QTimer::timeout, this, &SBarcodeResultsModel::flush);
+}
+
+int SBarcodeResultsModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(m_entries.size());
+}
+
+QVariant SBarcodeResultsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= int(m_entries.size())) {
+        return QVariant();
+    }
+
+    const Entry &entry = m_entries[size_t(index.row())];
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case TextRole:
+        return entry.result.text;
+    case FormatRole:
+        return QVariant::fromValue(entry.result.format);
+    case TimestampRole:
+        return entry.timestamp;
+    case PositionRole:
+        return entry.result.positionPoints();
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> SBarcodeResultsModel::roleNames() const
+{
+    return {
+        { TextRole, "text" },
+        { FormatRole, "format" },
+        { TimestampRole, "timestamp" },
+        { PositionRole, "position" },
+    };
+}
+
+int SBarcodeResultsModel::count() const
+{
+    return int(m_entries.size());
+}
+
+int SBarcodeResultsModel::capacity() const
+{
+    return m_capacity;
+}
+
+void SBarcodeResultsModel::setCapacity(int capacity)
+{
+    capacity = qMax(1, capacity);
+
+    if (m_capacity == capacity) {
+        return;
+    }
+
+    m_capacity = capacity;
+
+    if (int(m_entries.size()) > m_capacity) {
+        removeOldest(int(m_entries.size()) - m_capacity);
+        emit countChanged();
+    }
+
+    emit capacityChanged(m_capacity);
+}
+
+int SBarcodeResultsModel::batchInterval() const
+{
+    return m_flushTimer.interval();
+}
+
+void SBarcodeResultsModel::setBatchInterval(int milliseconds)
+{
+    milliseconds = qMax(0, milliseconds);
+
+    if (m_flushTimer.interval() == milliseconds) {
+        return;
+    }
+
+    m_flushTimer.setInterval(milliseconds);
+    emit batchIntervalChanged(milliseconds);
+}
+
+void SBarcodeResultsModel::append(const QList<SBarcodeResult> &results)
+{
+    if (results.isEmpty()) {
+        return;
+    }
+
+    const QDateTime timestamp = QDateTime::currentDateTime();
+    QMutexLocker locker(&m_pendingMutex);
+
+    for (const auto &result : results) {
+        m_pending.push_back({ result, timestamp });
+    }
+
+    // The first result of a batch starts the timer on the thread of the model, later ones just join the batch
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QMetaObject::invokeMethod(&m_flushTimer, qOverload<>(&QTimer::start), Qt::QueuedConnection);
+    }
+}
+
+QVariant SBarcodeResultsModel::get(int row) const
+{
+    if (row < 0 || row >= int(m_entries.size())) {
+        return QVariant();
+    }
+
+    return QVariant::fromValue(m_entries[size_t(row)].result);
+}
+
+void SBarcodeResultsModel::clear()
+{
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        m_pending.clear();
+    }
+
+    if (m_entries.empty()) {
+        return;
+    }
+
+    beginResetModel();
+    m_entries.clear();
+    endResetModel();
+    emit countChanged();
+}
+
+void SBarcodeResultsModel::flush()
+{
+    std::vector<Entry> batch;
+
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        batch.swap(m_pending);
+        m_flushScheduled = false;
+    }
+
+    if (batch.empty()) {
+        return;
+    }
+
+    // Results which would be removed right away are never inserted
+    auto first = batch.cbegin();
+
+    if (int(batch.size()) > m_capacity) {
+        first += ptrdiff_t(batch.size()) - m_capacity;
+    }
+
+    const int inserted = int(std::distance(first, batch.cend()));
+    const int overflow = int(m_entries.size()) + inserted - m_capacity;
+
+    if (overflow > 0) {
+        removeOldest(overflow);
+    }
+
+    const int row = int(m_entries.size());
+    beginInsertRows(QModelIndex(), row, row + inserted - 1);
+    m_entries.insert(m_entries.end(), first, batch.cend());
+    endInsertRows();
+
+    emit countChanged();
+}
+
+void SBarcodeResultsModel::removeOldest(int count)
+{
+    beginRemoveRows(QModelIndex(), 0, count - 1);
+    m_entries.erase(m_entries.begin(), m_entries.begin() + count);
+    endRemoveRows();
+}
@@ -0,0 +1,121 @@
+#ifndef SBARCODERESULTSMODEL_H
+#define SBARCODERESULTSMODEL_H
+
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QMutex>
+#include <QTimer>
+
+#ifndef SCODES_CORE_ONLY
+#include <qqml.h>
+#endif
+
+#include <deque>
+#include <vector>
+
+#include "SBarcodeResult.h"
+
+/*!
+ * \brief The SBarcodeResultsModel class is a list model of reported barcodes, oldest first, to be shown by QML
+ * views while scanning. Results are collected from any thread and inserted in batches on the thread of the model,
+ * so views get a single row insertion for all barcodes reported within batchInterval. The oldest rows are removed
+ * once capacity is exceeded. Every SBarcodeScanner and SBarcodeFilter owns one as its resultsModel property.
+ */
+class SBarcodeResultsModel : public QAbstractListModel
+{
+    Q_OBJECT
+#ifndef SCODES_CORE_ONLY
+    QML_ELEMENT
+    QML_UNCREATABLE("SBarcodeResultsModel is provided by the resultsModel property of a scanner")
+#endif
+
+    /// Number of rows
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    /// Maximum number of rows, the oldest rows are removed when exceeded (default 1000)
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+    /// Time in milliseconds results are collected for before they are inserted at once (default 100, 0 - next event loop iteration)
+    Q_PROPERTY(int batchInterval READ batchInterval WRITE setBatchInterval NOTIFY batchIntervalChanged)
+
+public:
+    enum Roles {
+        TextRole = Qt::UserRole + 1,
+        FormatRole,
+        TimestampRole,
+        PositionRole
+    };
+    Q_ENUM(Roles)
+
+    /*!
+     * \fn explicit SBarcodeResultsModel(QObject *parent)
+     * \brief Constructor.
+     * \param QObject *parent - a pointer to the parent object.
+     */
+    explicit SBarcodeResultsModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const;
+    int capacity() const;
+    void setCapacity(int capacity);
+    int batchInterval() const;
+    void setBatchInterval(int milliseconds);
+
+    /*!
+     * \fn void append(const QList<SBarcodeResult> &results)
+     * \brief Queues results for the next batch, stamped with the current time. Can be called from any thread.
+     * \param const QList<SBarcodeResult> &results - reported barcodes.
+     */
+    void append(const QList<SBarcodeResult> &results);
+
+    /*!
+     * \fn QVariant get(int row) const
+     * \brief Returns the SBarcodeResult of the row, invalid variant for rows out of range.
+     * \param int row - row index.
+     */
+    Q_INVOKABLE QVariant get(int row) const;
+
+public slots:
+    /*!
+     * \fn void clear()
+     * \brief Removes all rows and discards results waiting for the next batch.
+     */
+    void clear();
+
+signals:
+    void countChanged();
+    void capacityChanged(int capacity);
+    void batchIntervalChanged(int milliseconds);
+
+private:
+    struct Entry {
+        SBarcodeResult result;
+        QDateTime timestamp;
+    };
+
+    /*!
+     * \fn void flush()
+     * \brief Moves the waiting results into the model with a single insertion, removing rows over capacity.
+     */
+    void flush();
+
+    /*!
+     * \fn void removeOldest(int count)
+     * \brief Removes the first count rows.
+     */
+    void removeOldest(int count);
+
+    std::deque<Entry> m_entries;
+    int m_capacity;
+
+    /// Results waiting for the next batch, filled from any thread
+    std::vector<Entry> m_pending;
+    /// Guards m_pending and m_flushScheduled
+    QMutex m_pendingMutex;
+    bool m_flushScheduled = false;
+    /// Single-shot timer inserting the waiting results
+    QTimer m_flushTimer;
+};
+
+#endif // SBARCODERESULTSMODEL_H
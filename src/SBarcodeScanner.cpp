@@ -1,9 +1,13 @@
 #include "SBarcodeScanner.h"
 #include <QMediaDevices>
+#include "private/DecodeMetrics.h"
+#include "private/DecodePool.h"
+#include "private/Trace.h"
 #include "private/debug.h"
 SBarcodeScanner::SBarcodeScanner(QObject* parent)
     : QVideoSink(parent)
     , m_camera(nullptr)
+    , m_resultsModel(new SBarcodeResultsModel(this))
     , m_scanning{true}
 {
     // Print error message if error occurs
@@ -17,17 +21,24 @@ SBarcodeScanner::SBarcodeScanner(QObject* parent)
     // Connect cameraAvaliable property. Utilise implicit conversion from pointer to bool.
     connect(this, &SBarcodeScanner::cameraChanged, this, &SBarcodeScanner::setCameraAvailable);
 
-    
-    m_decoder.moveToThread(&workerThread);
+    // Frames are decoded on the decode pool shared by all scanners, the decoder reports from its threads
     connect(&m_decoder, &SBarcodeDecoder::capturedChanged, this, &SBarcodeScanner::setCaptured, Qt::QueuedConnection);
+    connect(&m_decoder, &SBarcodeDecoder::resultsCaptured, this, [this](const QList<SBarcodeResult> &results){
+        m_resultsModel->append(results);
+        emit resultsCaptured(toVariantList(results));
+    }, Qt::QueuedConnection);
     connect(&m_decoder, &SBarcodeDecoder::errorOccured, this, &SBarcodeScanner::errorOccured, Qt::QueuedConnection);
-    workerThread.start();
 }
 
 SBarcodeScanner::~SBarcodeScanner()
 {
-    workerThread.quit();
-    workerThread.wait();
+    // Decoding tasks refer to this scanner, the waiting frame is discarded and running tasks are waited for
+    disconnect(this, &QVideoSink::videoFrameChanged, this, &SBarcodeScanner::tryProcessFrame);
+
+    SCodes::FrameMailbox::Frame pendingFrame;
+    m_mailbox.take(pendingFrame);
+
+    m_mailbox.waitForConsumers();
 }
 
 SBarcodeDecoder* SBarcodeScanner::getDecoder()
@@ -52,26 +63,115 @@ void SBarcodeScanner::classBegin()
 
 void SBarcodeScanner::tryProcessFrame(const QVideoFrame& frame)
 {
-    if(!m_scanning || m_frameProcessingInProgress) {
+    if(!m_scanning) {
         return;
     }
-    // Set the guard variable to not process more than 1 frame at the time
-    m_frameProcessingInProgress = true;
 
-    // Scale the normalized rectangle for camera resolution
-    auto r = m_camera->cameraFormat().resolution();
+    ++SCodes::DecodeMetrics::instance().framesReceived;
+    SCodes::TraceScope trace("SBarcodeScanner::tryProcessFrame");
+
+    if (m_recordingWriter.isOpen() && !m_recordingWriter.write(frame, m_recordingClock.nsecsElapsed() / 1000)) {
+        m_recordingWriter.close();
+        emit errorOccured("Frame recording stopped: " + m_recordingWriter.errorString());
+    }
+
+    // Scale the normalized rectangle for frame resolution
+    auto r = frame.size();
     auto cRect = QRectF{m_captureRect.x()*r.width(),
             m_captureRect.y()*r.height(),
             m_captureRect.width()*r.width(),
                        m_captureRect.height()*r.height()}.toRect();
 
-    // Invoke processing asynchronously, potential result will be reported by capturedChanged signal
+    // The mailbox keeps only the newest frame, a pool worker picks it up as soon as one is free
     // We can copy QVideoFrame as it's explicitly shared (just like std::shared_ptr)
-    // Note the releasing the guard variable
-    QMetaObject::invokeMethod(&m_decoder, [=](){
-        m_decoder.process(m_decoder.videoFrameToImage(frame, cRect),SCodes::toZXingFormat(SCodes::SBarcodeFormat::Basic));
-        m_frameProcessingInProgress = false;
-    });
+    if (m_mailbox.post(frame, cRect)) {
+        ++SCodes::DecodeMetrics::instance().framesDropped;
+        emit frameCountersChanged();
+    }
+
+    // The mailbox sequence identifies the frame in the trace, on the decoding thread as well
+    trace.setFrame(m_mailbox.sequence());
+
+    // Several frames may be decoded at once, up to one per pool worker
+    if (m_mailbox.tryScheduleConsumer(SCodes::DecodePool::instance().workerCount())) {
+        SCodes::DecodePool::instance().submit([this](){ processMailbox(); });
+    }
+}
+
+void SBarcodeScanner::processMailbox()
+{
+    SCodes::FrameMailbox::Frame mailboxFrame;
+
+    while (m_mailbox.take(mailboxFrame)) {
+        const qint64 maxFrameAge = m_maxFrameAge;
+
+        if (maxFrameAge > 0 && m_mailbox.timestamp() - mailboxFrame.timestamp > maxFrameAge * 1000000) {
+            m_mailbox.drop();
+            ++SCodes::DecodeMetrics::instance().framesDropped;
+            emit frameCountersChanged();
+            continue;
+        }
+
+        decodeFrame(mailboxFrame);
+        break;
+    }
+
+    // Every task decodes a single frame, so frames of other scanners get their turn on the pool
+    if (m_mailbox.finishConsumer(SCodes::DecodePool::instance().workerCount())) {
+        SCodes::DecodePool::instance().submit([this](){ processMailbox(); });
+    }
+}
+
+void SBarcodeScanner::decodeFrame(const SCodes::FrameMailbox::Frame &mailboxFrame)
+{
+    SCodes::TraceFrame traceFrame(mailboxFrame.sequence);
+    SCODES_TRACE("SBarcodeScanner::decodeFrame");
+
+    const QVideoFrame &frame = mailboxFrame.frame;
+    const QSize r = frame.size();
+    const QRect area = mailboxFrame.captureRect.isEmpty() ? QRect(QPoint(0, 0), r) : mailboxFrame.captureRect;
+
+    // Results are reported in frame order, whichever thread finishes decoding first
+    const auto report = [this, r](quint64 sequence, const QList<SBarcodeResult> &results) {
+        SCodes::TraceFrame reportedFrame(sequence);
+        m_roiTracker.update(results, r);
+        m_decoder.reportResults(results);
+
+        // Marks when the GUI thread got to the queued results, they are delivered just before
+        if (SCodes::Trace::isEnabled() && !results.isEmpty()) {
+            QMetaObject::invokeMethod(this, [sequence]() {
+                const auto now = SCodes::Trace::now();
+                SCodes::Trace::record("SBarcodeScanner::resultsDelivered", now, now, sequence);
+            }, Qt::QueuedConnection);
+        }
+    };
+
+    m_sequencer.begin(mailboxFrame.sequence);
+
+    // Blurred or moving frames are dropped before any conversion, so the worker is free for the next one
+    if (m_decoder.frameGate().isEnabled()) {
+        const bool accepted = m_decoder.acceptFrame(frame, area);
+        emit frameGateChanged();
+
+        if (!accepted) {
+            ++SCodes::DecodeMetrics::instance().framesDropped;
+            m_sequencer.discard(mailboxFrame.sequence, report);
+            return;
+        }
+    }
+
+    // Planar frames are decoded straight from their luminance plane, without converting to QImage
+    // With ROI tracking only the area around the last decoded barcodes is passed, until it misses too often
+    QString error;
+    const auto results = m_decoder.readFrame(frame, m_roiTracker.region(area), m_zxingFormats, &error);
+
+    ++SCodes::DecodeMetrics::instance().framesProcessed;
+
+    if (!error.isEmpty()) {
+        emit errorOccured(error);
+    }
+
+    m_sequencer.finish(mailboxFrame.sequence, results, report);
 }
 
 void SBarcodeScanner::setCameraAvailable(bool available)
@@ -113,13 +213,9 @@ QCamera *SBarcodeScanner::makeDefaultCamera()
         return nullptr;
     }
 
-    /// Pick best format - most pixels
-    std::sort(supportedFormats.begin(),supportedFormats.end(),[](const auto& f1, const auto& f2){
-        QSize r1 = f1.resolution();
-        QSize r2 = f2.resolution();
-        return r1.height()*r1.width() < r2.height()*r2.width();
-    });
-    auto format = supportedFormats.last();
+    // Pick the format cheapest to decode at the wanted resolution and frame rate, not the one with most pixels
+    const auto format = SCodes::selectCameraFormat(supportedFormats, m_cameraFormatPolicy);
+    sDebug() << "Selected format:" << SCodes::describeCameraFormat(format);
 
     camera->setFocusMode(QCamera::FocusModeAuto);
     camera->setCameraFormat(format);
@@ -128,6 +224,10 @@ QCamera *SBarcodeScanner::makeDefaultCamera()
 
 void SBarcodeScanner::setCaptured(const QString& captured)
 {
+    if (m_captured == captured) {
+        return;
+    }
+
     m_captured = captured;
     emit capturedChanged(m_captured);
 }
@@ -137,6 +237,11 @@ QString SBarcodeScanner::captured() const
     return m_captured;
 }
 
+SBarcodeResultsModel *SBarcodeScanner::resultsModel() const
+{
+    return m_resultsModel;
+}
+
 QRectF SBarcodeScanner::captureRect() const
 {
     return m_captureRect;
@@ -149,6 +254,7 @@ void SBarcodeScanner::setCaptureRect(const QRectF& captureRect)
     }
 
     m_captureRect = captureRect;
+    m_roiTracker.reset();
     sDebug() << "Capture Rectangle changed:" << m_captureRect;
     emit captureRectChanged(m_captureRect);
 }
@@ -184,18 +290,97 @@ void SBarcodeScanner::setCamera(QCamera *newCamera)
         connect(newCamera,&QCamera::errorOccurred,this,[this](auto err,const auto& string){
             errorOccured("Camera error:" + string);
         });
-        m_decoder.setResolution(format.resolution());
+        connect(newCamera,&QCamera::cameraFormatChanged,this,[this](){
+            setDecoderFormat(m_camera->cameraFormat());
+            emit cameraFormatChanged();
+        });
+        setDecoderFormat(format);
         m_capture.setCamera(newCamera);
         m_camera = newCamera;
         m_camera->start();
     }
     sDebug() << "New Camera set: " << m_camera
-            << "\nFormat:\n"
-            << "  Pixel format:" << m_camera->cameraFormat().pixelFormat() << '\n'
-            << "  Resolution:" << m_camera->cameraFormat().resolution() << '\n'
-            << "  FPS:" << m_camera->cameraFormat().minFrameRate() << "-" << m_camera->cameraFormat().maxFrameRate();
+            << "Format:" << SCodes::describeCameraFormat(cameraFormat());
 
     emit cameraChanged(m_camera);
+    emit cameraFormatChanged();
+}
+
+void SBarcodeScanner::setDecoderFormat(const QCameraFormat &format)
+{
+    m_decoder.setResolution(format.resolution());
+
+    // Frames decoded in place never take a pooled buffer, others are converted to luminance of up to frame size
+    if (!SCodes::isDecodedInPlace(format.pixelFormat())) {
+        m_decoder.reserveFrameBuffers(format.resolution(), QImage::Format_Grayscale8);
+    }
+}
+
+QSize SBarcodeScanner::targetResolution() const
+{
+    return m_cameraFormatPolicy.targetResolution;
+}
+
+void SBarcodeScanner::setTargetResolution(const QSize &resolution)
+{
+    if (m_cameraFormatPolicy.targetResolution == resolution) {
+        return;
+    }
+
+    m_cameraFormatPolicy.targetResolution = resolution;
+    applyCameraFormatPolicy();
+    emit cameraFormatPolicyChanged();
+}
+
+qreal SBarcodeScanner::minFrameRate() const
+{
+    return m_cameraFormatPolicy.minFrameRate;
+}
+
+void SBarcodeScanner::setMinFrameRate(qreal frameRate)
+{
+    if (qFuzzyCompare(m_cameraFormatPolicy.minFrameRate + 1, frameRate + 1)) {
+        return;
+    }
+
+    m_cameraFormatPolicy.minFrameRate = frameRate;
+    applyCameraFormatPolicy();
+    emit cameraFormatPolicyChanged();
+}
+
+bool SBarcodeScanner::preferLumaFormats() const
+{
+    return m_cameraFormatPolicy.preferLumaFormats;
+}
+
+void SBarcodeScanner::setPreferLumaFormats(bool prefer)
+{
+    if (m_cameraFormatPolicy.preferLumaFormats == prefer) {
+        return;
+    }
+
+    m_cameraFormatPolicy.preferLumaFormats = prefer;
+    applyCameraFormatPolicy();
+    emit cameraFormatPolicyChanged();
+}
+
+QCameraFormat SBarcodeScanner::cameraFormat() const
+{
+    return m_camera ? m_camera->cameraFormat() : QCameraFormat();
+}
+
+void SBarcodeScanner::applyCameraFormatPolicy()
+{
+    if (m_camera.isNull() || m_camera->parent() != this) {
+        return;
+    }
+
+    const auto format = SCodes::selectCameraFormat(m_camera->cameraDevice().videoFormats(), m_cameraFormatPolicy);
+
+    if (!format.isNull() && format != m_camera->cameraFormat()) {
+        sDebug() << "Camera format policy changed, selected format:" << SCodes::describeCameraFormat(format);
+        m_camera->setCameraFormat(format);
+    }
 }
 
 void SBarcodeScanner::setForwardVideoSink(QVideoSink *newSink)
@@ -214,3 +399,304 @@ void SBarcodeScanner::setForwardVideoSink(QVideoSink *newSink)
     m_forwardVideoSink = newSink;
     forwardVideoSinkChanged(m_forwardVideoSink);
 }
+
+SCodes::SBarcodeFormats SBarcodeScanner::format() const
+{
+    return m_format;
+}
+
+void SBarcodeScanner::setFormat(const SCodes::SBarcodeFormats &format)
+{
+    if (m_format == format) {
+        return;
+    }
+
+    sDebug() << "set format " << format << ", old format " << m_format;
+
+    // Translated once here instead of for every frame
+    m_format = format;
+    m_zxingFormats = SCodes::toZXingFormat(m_format);
+    emit formatChanged(m_format);
+}
+
+bool SBarcodeScanner::multiResult() const
+{
+    return m_decoder.multiResult();
+}
+
+void SBarcodeScanner::setMultiResult(bool multiResult)
+{
+    if (m_decoder.multiResult() == multiResult) {
+        return;
+    }
+
+    m_decoder.setMultiResult(multiResult);
+    emit multiResultChanged(multiResult);
+}
+
+int SBarcodeScanner::decodeTimeBudget() const
+{
+    return m_decoder.decodeTimeBudget();
+}
+
+void SBarcodeScanner::setDecodeTimeBudget(int milliseconds)
+{
+    if (m_decoder.decodeTimeBudget() == milliseconds) {
+        return;
+    }
+
+    m_decoder.setDecodeTimeBudget(milliseconds);
+    emit decodeTimeBudgetChanged(m_decoder.decodeTimeBudget());
+}
+
+int SBarcodeScanner::scanlineCount() const
+{
+    return m_decoder.scanlineCount();
+}
+
+void SBarcodeScanner::setScanlineCount(int count)
+{
+    if (m_decoder.scanlineCount() == count) {
+        return;
+    }
+
+    m_decoder.setScanlineCount(count);
+    emit scanlineCountChanged(m_decoder.scanlineCount());
+}
+
+bool SBarcodeScanner::verticalScanlines() const
+{
+    return m_decoder.verticalScanlines();
+}
+
+void SBarcodeScanner::setVerticalScanlines(bool vertical)
+{
+    if (m_decoder.verticalScanlines() == vertical) {
+        return;
+    }
+
+    m_decoder.setVerticalScanlines(vertical);
+    emit verticalScanlinesChanged(vertical);
+}
+
+bool SBarcodeScanner::learnedFormats() const
+{
+    return m_decoder.learnedFormats();
+}
+
+void SBarcodeScanner::setLearnedFormats(bool learned)
+{
+    if (m_decoder.learnedFormats() == learned) {
+        return;
+    }
+
+    m_decoder.setLearnedFormats(learned);
+    emit learnedFormatsChanged(learned);
+}
+
+bool SBarcodeScanner::binarizerRace() const
+{
+    return m_decoder.binarizerRace();
+}
+
+void SBarcodeScanner::setBinarizerRace(bool binarizerRace)
+{
+    if (m_decoder.binarizerRace() == binarizerRace) {
+        return;
+    }
+
+    m_decoder.setBinarizerRace(binarizerRace);
+    emit binarizerRaceChanged(binarizerRace);
+}
+
+bool SBarcodeScanner::roiTracking() const
+{
+    return m_roiTracker.isEnabled();
+}
+
+void SBarcodeScanner::setRoiTracking(bool roiTracking)
+{
+    if (m_roiTracker.isEnabled() == roiTracking) {
+        return;
+    }
+
+    m_roiTracker.setEnabled(roiTracking);
+    emit roiTrackingChanged(roiTracking);
+}
+
+int SBarcodeScanner::roiMaxMisses() const
+{
+    return m_roiTracker.maxMisses();
+}
+
+void SBarcodeScanner::setRoiMaxMisses(int roiMaxMisses)
+{
+    if (m_roiTracker.maxMisses() == roiMaxMisses) {
+        return;
+    }
+
+    m_roiTracker.setMaxMisses(roiMaxMisses);
+    emit roiMaxMissesChanged(m_roiTracker.maxMisses());
+}
+
+int SBarcodeScanner::consensusFrames() const
+{
+    return m_decoder.consensusFrames();
+}
+
+void SBarcodeScanner::setConsensusFrames(int frames)
+{
+    if (m_decoder.consensusFrames() == frames) {
+        return;
+    }
+
+    m_decoder.setConsensusFrames(frames);
+    emit consensusFramesChanged(m_decoder.consensusFrames());
+}
+
+int SBarcodeScanner::consensusWindow() const
+{
+    return m_decoder.consensusWindow();
+}
+
+void SBarcodeScanner::setConsensusWindow(int frames)
+{
+    if (m_decoder.consensusWindow() == frames) {
+        return;
+    }
+
+    m_decoder.setConsensusWindow(frames);
+    emit consensusWindowChanged(m_decoder.consensusWindow());
+}
+
+int SBarcodeScanner::repeatInterval() const
+{
+    return m_decoder.repeatInterval();
+}
+
+void SBarcodeScanner::setRepeatInterval(int milliseconds)
+{
+    if (m_decoder.repeatInterval() == milliseconds) {
+        return;
+    }
+
+    m_decoder.setRepeatInterval(milliseconds);
+    emit repeatIntervalChanged(m_decoder.repeatInterval());
+}
+
+qreal SBarcodeScanner::sharpnessThreshold() const
+{
+    return m_decoder.frameGate().sharpnessThreshold();
+}
+
+void SBarcodeScanner::setSharpnessThreshold(qreal threshold)
+{
+    if (m_decoder.frameGate().sharpnessThreshold() == threshold) {
+        return;
+    }
+
+    m_decoder.frameGate().setSharpnessThreshold(threshold);
+    emit sharpnessThresholdChanged(m_decoder.frameGate().sharpnessThreshold());
+}
+
+qreal SBarcodeScanner::motionThreshold() const
+{
+    return m_decoder.frameGate().motionThreshold();
+}
+
+void SBarcodeScanner::setMotionThreshold(qreal threshold)
+{
+    if (m_decoder.frameGate().motionThreshold() == threshold) {
+        return;
+    }
+
+    m_decoder.frameGate().setMotionThreshold(threshold);
+    emit motionThresholdChanged(m_decoder.frameGate().motionThreshold());
+}
+
+qreal SBarcodeScanner::frameSharpness() const
+{
+    return m_decoder.frameGate().sharpness();
+}
+
+qreal SBarcodeScanner::frameMotion() const
+{
+    return m_decoder.frameGate().motion();
+}
+
+int SBarcodeScanner::blurredFrames() const
+{
+    return m_decoder.frameGate().blurredFrames();
+}
+
+int SBarcodeScanner::movingFrames() const
+{
+    return m_decoder.frameGate().movingFrames();
+}
+
+int SBarcodeScanner::maxFrameAge() const
+{
+    return m_maxFrameAge;
+}
+
+void SBarcodeScanner::setMaxFrameAge(int milliseconds)
+{
+    milliseconds = qMax(0, milliseconds);
+
+    if (m_maxFrameAge == milliseconds) {
+        return;
+    }
+
+    m_maxFrameAge = milliseconds;
+    emit maxFrameAgeChanged(milliseconds);
+}
+
+int SBarcodeScanner::replacedFrames() const
+{
+    return m_mailbox.replacedFrames();
+}
+
+int SBarcodeScanner::droppedFrames() const
+{
+    return m_mailbox.droppedFrames();
+}
+
+int SBarcodeScanner::workerCount() const
+{
+    return SCodes::DecodePool::instance().workerCount();
+}
+
+void SBarcodeScanner::setWorkerCount(int count)
+{
+    const int previousCount = SCodes::DecodePool::instance().workerCount();
+    SCodes::DecodePool::instance().setWorkerCount(count);
+
+    if (SCodes::DecodePool::instance().workerCount() != previousCount) {
+        emit workerCountChanged(SCodes::DecodePool::instance().workerCount());
+    }
+}
+
+QString SBarcodeScanner::recordingPath() const
+{
+    return m_recordingPath;
+}
+
+void SBarcodeScanner::setRecordingPath(const QString &path)
+{
+    if (m_recordingPath == path) {
+        return;
+    }
+
+    m_recordingWriter.close();
+    m_recordingPath = path;
+
+    if (!path.isEmpty()) {
+        if (m_recordingWriter.open(path)) {
+            m_recordingClock.start();
+        } else {
+            emit errorOccured("Can't write frame recording " + path + ": " + m_recordingWriter.errorString());
+        }
+    }
+
+    emit recordingPathChanged(m_recordingPath);
+}
@@ -14,6 +14,12 @@
 #include <QOpenGLFunctions>
 
 #include "SBarcodeDecoder.h"
+#include "SBarcodeResultsModel.h"
+#include "private/CameraFormatPolicy.h"
+#include "private/FrameMailbox.h"
+#include "private/FrameRecording.h"
+#include "private/ResultSequencer.h"
+#include "private/RoiTracker.h"
 /*!
  * \brief The SBarcodeScanner class processes the video input from Camera,
  */
@@ -33,6 +39,62 @@ class SBarcodeScanner : public QVideoSink, public QQmlParserStatus
     Q_PROPERTY(bool cameraAvailable READ cameraAvailable NOTIFY cameraAvailableChanged)
     /// Optional property if you want to set your own camera as an video input for scanning. Default video input is chosen by default.
     Q_PROPERTY(QCamera* camera MEMBER m_camera WRITE setCamera NOTIFY cameraChanged)
+    /// Resolution the default camera format should cover, larger formats only slow decoding down (default 1280x720, invalid size for the largest format)
+    Q_PROPERTY(QSize targetResolution READ targetResolution WRITE setTargetResolution NOTIFY cameraFormatPolicyChanged)
+    /// Frame rate the default camera format should reach, slower formats are taken only if there is no other (default 15)
+    Q_PROPERTY(qreal minFrameRate READ minFrameRate WRITE setMinFrameRate NOTIFY cameraFormatPolicyChanged)
+    /// Set to true to prefer camera formats decoded in place, like NV12 or YUYV, over RGB and MJPEG (default true)
+    Q_PROPERTY(bool preferLumaFormats READ preferLumaFormats WRITE setPreferLumaFormats NOTIFY cameraFormatPolicyChanged)
+    /// Format the camera delivers frames in, chosen by the policy above for the default camera
+    Q_PROPERTY(QCameraFormat cameraFormat READ cameraFormat NOTIFY cameraFormatChanged)
+    /// List model of the reported barcodes, with text, format, timestamp and position roles
+    Q_PROPERTY(SBarcodeResultsModel* resultsModel READ resultsModel CONSTANT)
+    /// Barcode formats to be decoded, combination of SCodes.SBarcodeFormat values (default SCodes.Basic)
+    Q_PROPERTY(SCodes::SBarcodeFormats format READ format WRITE setFormat NOTIFY formatChanged)
+    /// Set to true to decode all barcodes in a frame, they are reported by resultsCaptured signal (default false)
+    Q_PROPERTY(bool multiResult READ multiResult WRITE setMultiResult NOTIFY multiResultChanged)
+    /// Set to true to decode every frame with several binarizers concurrently, the first one finding a barcode wins (default false)
+    Q_PROPERTY(bool binarizerRace READ binarizerRace WRITE setBinarizerRace NOTIFY binarizerRaceChanged)
+    /// Time in milliseconds after which no further, more expensive decoding pass is started for a frame (default 0 - no limit)
+    Q_PROPERTY(int decodeTimeBudget READ decodeTimeBudget WRITE setDecodeTimeBudget NOTIFY decodeTimeBudgetChanged)
+    /// Number of thin horizontal bands decoded instead of the whole frame when only 1D formats are scanned (default 0 - whole frame)
+    Q_PROPERTY(int scanlineCount READ scanlineCount WRITE setScanlineCount NOTIFY scanlineCountChanged)
+    /// Set to true to decode vertical bands as well in the scanline mode, for barcodes rotated by 90 degrees (default false)
+    Q_PROPERTY(bool verticalScanlines READ verticalScanlines WRITE setVerticalScanlines NOTIFY verticalScanlinesChanged)
+    /// Set to true to try the formats decoded most often first, the statistics are kept in QSettings (default false)
+    Q_PROPERTY(bool learnedFormats READ learnedFormats WRITE setLearnedFormats NOTIFY learnedFormatsChanged)
+    /// Set to true to decode only the area around the last decoded barcodes in the following frames (default false)
+    Q_PROPERTY(bool roiTracking READ roiTracking WRITE setRoiTracking NOTIFY roiTrackingChanged)
+    /// Number of frames without barcode after which the whole captureRect is decoded again (default 5)
+    Q_PROPERTY(int roiMaxMisses READ roiMaxMisses WRITE setRoiMaxMisses NOTIFY roiMaxMissesChanged)
+    /// Number of frames out of the last consensusWindow frames a barcode has to be decoded in before it is reported (default 1)
+    Q_PROPERTY(int consensusFrames READ consensusFrames WRITE setConsensusFrames NOTIFY consensusFramesChanged)
+    /// Number of last frames in which the agreeing frames are counted (default 1)
+    Q_PROPERTY(int consensusWindow READ consensusWindow WRITE setConsensusWindow NOTIFY consensusWindowChanged)
+    /// Time in milliseconds within which a barcode still seen by the camera is not reported again (default 0 - report every frame)
+    Q_PROPERTY(int repeatInterval READ repeatInterval WRITE setRepeatInterval NOTIFY repeatIntervalChanged)
+    /// Frames with lower sharpness (mean squared luminance gradient) are skipped without decoding (default 0 - disabled)
+    Q_PROPERTY(qreal sharpnessThreshold READ sharpnessThreshold WRITE setSharpnessThreshold NOTIFY sharpnessThresholdChanged)
+    /// Frames differing more from the previous one (mean absolute luminance difference, 0-255) are skipped without decoding (default 0 - disabled)
+    Q_PROPERTY(qreal motionThreshold READ motionThreshold WRITE setMotionThreshold NOTIFY motionThresholdChanged)
+    /// Sharpness of the last measured frame, to tune sharpnessThreshold
+    Q_PROPERTY(qreal frameSharpness READ frameSharpness NOTIFY frameGateChanged)
+    /// Motion of the last measured frame, to tune motionThreshold
+    Q_PROPERTY(qreal frameMotion READ frameMotion NOTIFY frameGateChanged)
+    /// Number of frames skipped as blurred
+    Q_PROPERTY(int blurredFrames READ blurredFrames NOTIFY frameGateChanged)
+    /// Number of frames skipped as moving
+    Q_PROPERTY(int movingFrames READ movingFrames NOTIFY frameGateChanged)
+    /// Frames waiting longer for the decoder are dropped, in milliseconds (default 0 - no limit)
+    Q_PROPERTY(int maxFrameAge READ maxFrameAge WRITE setMaxFrameAge NOTIFY maxFrameAgeChanged)
+    /// Number of frames replaced by a newer one while the decoder was busy
+    Q_PROPERTY(int replacedFrames READ replacedFrames NOTIFY frameCountersChanged)
+    /// Number of frames dropped for exceeding maxFrameAge
+    Q_PROPERTY(int droppedFrames READ droppedFrames NOTIFY frameCountersChanged)
+    /// Number of threads decoding frames, shared by all scanners in the process (default 0 - one per CPU core)
+    Q_PROPERTY(int workerCount READ workerCount WRITE setWorkerCount NOTIFY workerCountChanged)
+    /// File every scanned frame is appended to, for replaying with SFrameReplaySource (default empty - not recording)
+    Q_PROPERTY(QString recordingPath READ recordingPath WRITE setRecordingPath NOTIFY recordingPathChanged)
 
 public:
     explicit SBarcodeScanner(QObject *parent = nullptr);
@@ -52,19 +114,92 @@ public:
     QRectF captureRect() const;
     void setCaptureRect(const QRectF &captureRect);
     QString captured() const;
+    SBarcodeResultsModel *resultsModel() const;
     bool cameraAvailable() const;
     void setCamera(QCamera *newCamera);
     void setForwardVideoSink(QVideoSink* sink);
+    QSize targetResolution() const;
+    void setTargetResolution(const QSize &resolution);
+    qreal minFrameRate() const;
+    void setMinFrameRate(qreal frameRate);
+    bool preferLumaFormats() const;
+    void setPreferLumaFormats(bool prefer);
+    QCameraFormat cameraFormat() const;
+    SCodes::SBarcodeFormats format() const;
+    void setFormat(const SCodes::SBarcodeFormats &format);
+    bool multiResult() const;
+    void setMultiResult(bool multiResult);
+    int decodeTimeBudget() const;
+    void setDecodeTimeBudget(int milliseconds);
+    int scanlineCount() const;
+    void setScanlineCount(int count);
+    bool verticalScanlines() const;
+    void setVerticalScanlines(bool vertical);
+    bool learnedFormats() const;
+    void setLearnedFormats(bool learned);
+    bool binarizerRace() const;
+    void setBinarizerRace(bool binarizerRace);
+    bool roiTracking() const;
+    void setRoiTracking(bool roiTracking);
+    int roiMaxMisses() const;
+    void setRoiMaxMisses(int roiMaxMisses);
+    int consensusFrames() const;
+    void setConsensusFrames(int frames);
+    int consensusWindow() const;
+    void setConsensusWindow(int frames);
+    int repeatInterval() const;
+    void setRepeatInterval(int milliseconds);
+    qreal sharpnessThreshold() const;
+    void setSharpnessThreshold(qreal threshold);
+    qreal motionThreshold() const;
+    void setMotionThreshold(qreal threshold);
+    qreal frameSharpness() const;
+    qreal frameMotion() const;
+    int blurredFrames() const;
+    int movingFrames() const;
+    int maxFrameAge() const;
+    void setMaxFrameAge(int milliseconds);
+    int replacedFrames() const;
+    int droppedFrames() const;
+    int workerCount() const;
+    void setWorkerCount(int count);
+    QString recordingPath() const;
+    void setRecordingPath(const QString &path);
 public slots:
 
 signals:
     void cameraChanged(QCamera *);
+    void cameraFormatPolicyChanged();
+    void cameraFormatChanged();
 
     /// This signal emitted for running process in a thread
     void process(const QImage &image);
     void forwardVideoSinkChanged(QVideoSink*);
     void captureRectChanged(const QRectF &captureRect);
     void capturedChanged(const QString &captured);
+    /// This signal is emitted with all barcodes decoded from a single frame, as list of SBarcodeResult
+    void resultsCaptured(const QVariantList &results);
+    void formatChanged(const SCodes::SBarcodeFormats &format);
+    void multiResultChanged(bool multiResult);
+    void decodeTimeBudgetChanged(int milliseconds);
+    void scanlineCountChanged(int count);
+    void verticalScanlinesChanged(bool vertical);
+    void learnedFormatsChanged(bool learned);
+    void binarizerRaceChanged(bool binarizerRace);
+    void roiTrackingChanged(bool roiTracking);
+    void roiMaxMissesChanged(int roiMaxMisses);
+    void consensusFramesChanged(int frames);
+    void consensusWindowChanged(int frames);
+    void repeatIntervalChanged(int milliseconds);
+    void sharpnessThresholdChanged(qreal threshold);
+    void motionThresholdChanged(qreal threshold);
+    /// This signal is emitted from the decode pool after every frame measured by the sharpness and motion gate
+    void frameGateChanged();
+    void maxFrameAgeChanged(int milliseconds);
+    /// This signal is emitted whenever a frame is replaced or dropped, possibly from the decode pool
+    void frameCountersChanged();
+    void workerCountChanged(int count);
+    void recordingPathChanged(const QString &path);
     void cameraAvailableChanged();
     void errorOccured(const QString& errorString);
 protected:
@@ -74,18 +209,35 @@ private:
     SBarcodeDecoder m_decoder;
     /// Camera object used to capture video, set automatically to device described by QMediaDevices::defaultVideoInput()
     QPointer<QCamera> m_camera;
+    /// Resolution, frame rate and pixel formats wanted from the default camera
+    SCodes::CameraFormatPolicy m_cameraFormatPolicy;
     /// VideoSink to forward the captured frame to. Normally this should be VideoOutput.videoSink
     QPointer<QVideoSink> m_forwardVideoSink;
     /// Subsection of videoframe to capture, in normalized coordinates
     QRectF m_captureRect;
     /// Last captured string from QrCode
     QString m_captured = "";
+    /// Reported barcodes for list views, child of the scanner
+    SBarcodeResultsModel *m_resultsModel;
     /// QMediaCaptureSession instance to actually perform the camera recording
     QMediaCaptureSession m_capture;
-    /// Separate thread for Qr code processing and detection
-    QThread workerThread;
-    /// Guard variable that prevents us from queueuing up the frames for processing
-    QAtomicInteger<bool> m_frameProcessingInProgress=false;
+    /// Barcode formats to be decoded
+    SCodes::SBarcodeFormats m_format = SCodes::SBarcodeFormat::Basic;
+    /// ZXing translation of m_format, computed when the format changes and read by the decode pool
+    std::atomic<ZXing::BarcodeFormats> m_zxingFormats { SCodes::toZXingFormat(SCodes::SBarcodeFormats(SCodes::SBarcodeFormat::Basic)) };
+    /// Single slot holding the newest frame until a pool worker is free, so frames never queue up
+    SCodes::FrameMailbox m_mailbox;
+    /// Orders results of frames decoded concurrently on the decode pool
+    SCodes::ResultSequencer m_sequencer;
+    /// Maximum time in milliseconds a frame may wait in the mailbox, 0 for no limit
+    std::atomic<int> m_maxFrameAge { 0 };
+    /// Region of interest around the last decoded barcodes, updated from the decode pool
+    SCodes::RoiTracker m_roiTracker;
+    /// Writes received frames to recordingPath, on the thread delivering them
+    SCodes::FrameRecordingWriter m_recordingWriter;
+    QString m_recordingPath;
+    /// Timestamps of recorded frames, started with the recording
+    QElapsedTimer m_recordingClock;
 
     bool m_scanning = true;
     bool m_cameraAvailable = false;
@@ -96,8 +248,12 @@ private:
      * \param const QString &captured - captured string
      */
     void setCaptured(const QString &captured);
-    /// Try process captured frame, if previous frame is already processed - skip it
+    /// Post captured frame to the mailbox and schedule a decoding task, a frame still waiting there is replaced
     void tryProcessFrame(const QVideoFrame &frame);
+    /// Decode the newest frame from the mailbox, runs on the decode pool
+    void processMailbox();
+    /// Decode a single frame and report its results in frame order, runs on the decode pool
+    void decodeFrame(const SCodes::FrameMailbox::Frame &mailboxFrame);
 
     /*!
      * \fn void setCameraAvailable(bool available)
@@ -105,6 +261,20 @@ private:
      * \param bool available - camera availability status
      */
     void setCameraAvailable(bool available);
+
+    /*!
+     * \fn void applyCameraFormatPolicy()
+     * \brief Selects the format of the default camera again after the policy changed. A camera set by the user
+     * keeps its format.
+     */
+    void applyCameraFormatPolicy();
+
+    /*!
+     * \fn void setDecoderFormat(const QCameraFormat &format)
+     * \brief Passes the resolution of the camera format to the decoder and preallocates the buffers its frames
+     * are converted into, if they are not decoded in place.
+     */
+    void setDecoderFormat(const QCameraFormat &format);
 };
 
 #endif // SBARCODESCANNER_H
@@ -12,10 +12,18 @@ INCLUDEPATH += \
 
 equals(QT_MAJOR_VERSION, 6) {
     HEADERS += \
-        $$PWD/SBarcodeScanner.h
+        $$PWD/SBarcodeScanner.h \
+        $$PWD/SFrameReplaySource.h \
+        $$PWD/private/CameraFormatPolicy.h \
+        $$PWD/private/FrameMailbox.h \
+        $$PWD/private/FrameRecording.h
 
     SOURCES += \
-        $$PWD/SBarcodeScanner.cpp
+        $$PWD/SBarcodeScanner.cpp \
+        $$PWD/SFrameReplaySource.cpp \
+        $$PWD/private/CameraFormatPolicy.cpp \
+        $$PWD/private/FrameMailbox.cpp \
+        $$PWD/private/FrameRecording.cpp
     android {
         QT += gui-private
     }
@@ -23,10 +31,12 @@ equals(QT_MAJOR_VERSION, 6) {
 
 equals(QT_MAJOR_VERSION, 5) {
     HEADERS += \
-        $$PWD/SBarcodeFilter.h
+        $$PWD/SBarcodeFilter.h \
+        $$PWD/private/GlLumaReader.h
 
     SOURCES += \
-        $$PWD/SBarcodeFilter.cpp
+        $$PWD/SBarcodeFilter.cpp \
+        $$PWD/private/GlLumaReader.cpp
 
     android {
         QT += androidextras
@@ -34,9 +44,27 @@ equals(QT_MAJOR_VERSION, 5) {
 }
 
 HEADERS += \
+    $$PWD/SBarcodeBatchDecoder.h \
     $$PWD/SBarcodeDecoder.h \
     $$PWD/SBarcodeFormat.h \
     $$PWD/SBarcodeGenerator.h \
+    $$PWD/SBarcodeMetrics.h \
+    $$PWD/SBarcodeResult.h \
+    $$PWD/SBarcodeResultsModel.h \
+    $$PWD/private/BarcodeEncoder.h \
+    $$PWD/private/debug.h \
+    $$PWD/private/DecodeMetrics.h \
+    $$PWD/private/DecodePool.h \
+    $$PWD/private/FormatPriorities.h \
+    $$PWD/private/FrameBufferPool.h \
+    $$PWD/private/FrameGate.h \
+    $$PWD/private/LuminancePyramid.h \
+    $$PWD/private/ResultFilter.h \
+    $$PWD/private/ResultSequencer.h \
+    $$PWD/private/RoiTracker.h \
+    $$PWD/private/ScanlineImage.h \
+    $$PWD/private/Tiling.h \
+    $$PWD/private/Trace.h \
     $$PWD/qvideoframeconversionhelper_p.h \
     $$PWD/zxing-cpp/core/src/BarcodeFormat.h \
     $$PWD/zxing-cpp/core/src/BinaryBitmap.h \
@@ -192,9 +220,26 @@ HEADERS += \
     $$PWD/zxing-cpp/core/src/qrcode/QRWriter.h
 
 SOURCES += \
+    $$PWD/SBarcodeBatchDecoder.cpp \
     $$PWD/SBarcodeDecoder.cpp \
     $$PWD/SBarcodeFormat.cpp \
     $$PWD/SBarcodeGenerator.cpp \
+    $$PWD/SBarcodeMetrics.cpp \
+    $$PWD/SBarcodeResult.cpp \
+    $$PWD/SBarcodeResultsModel.cpp \
+    $$PWD/private/BarcodeEncoder.cpp \
+    $$PWD/private/DecodeMetrics.cpp \
+    $$PWD/private/DecodePool.cpp \
+    $$PWD/private/FormatPriorities.cpp \
+    $$PWD/private/FrameBufferPool.cpp \
+    $$PWD/private/FrameGate.cpp \
+    $$PWD/private/LuminancePyramid.cpp \
+    $$PWD/private/ResultFilter.cpp \
+    $$PWD/private/ResultSequencer.cpp \
+    $$PWD/private/RoiTracker.cpp \
+    $$PWD/private/ScanlineImage.cpp \
+    $$PWD/private/Tiling.cpp \
+    $$PWD/private/Trace.cpp \
     $$PWD/zxing-cpp/core/src/BarcodeFormat.cpp \
     $$PWD/zxing-cpp/core/src/BinaryBitmap.cpp \
     $$PWD/zxing-cpp/core/src/BitArray.cpp \
@@ -0,0 +1,194 @@
+#include "SFrameReplaySource.h"
+
+#include "SBarcodeScanner.h"
+#include "private/debug.h"
+
+#include <limits>
+
+SFrameReplaySource::SFrameReplaySource(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &SFrameReplaySource::deliverFrame);
+}
+
+QUrl SFrameReplaySource::source() const
+{
+    return m_source;
+}
+
+void SFrameReplaySource::setSource(const QUrl &source)
+{
+    if (m_source == source) {
+        return;
+    }
+
+    stop();
+    m_source = source;
+
+    const QString path = source.isLocalFile() ? source.toLocalFile() : source.toString();
+
+    if (!path.isEmpty() && !m_recording.open(path)) {
+        emit errorOccured("Can't open frame recording " + path + ": " + m_recording.errorString());
+    } else if (path.isEmpty()) {
+        m_recording.close();
+    }
+
+    sDebug() << "Frame recording" << path << "has" << m_recording.frameCount() << "frames";
+    emit sourceChanged();
+}
+
+QVideoSink *SFrameReplaySource::videoSink() const
+{
+    return m_videoSink;
+}
+
+void SFrameReplaySource::setVideoSink(QVideoSink *sink)
+{
+    if (m_videoSink == sink) {
+        return;
+    }
+
+    m_videoSink = sink;
+    emit videoSinkChanged();
+}
+
+bool SFrameReplaySource::realTime() const
+{
+    return m_realTime;
+}
+
+void SFrameReplaySource::setRealTime(bool realTime)
+{
+    if (m_realTime == realTime) {
+        return;
+    }
+
+    m_realTime = realTime;
+    emit realTimeChanged(m_realTime);
+}
+
+int SFrameReplaySource::loops() const
+{
+    return m_loops;
+}
+
+void SFrameReplaySource::setLoops(int loops)
+{
+    if (m_loops == loops) {
+        return;
+    }
+
+    m_loops = loops;
+    emit loopsChanged(m_loops);
+}
+
+bool SFrameReplaySource::running() const
+{
+    return m_running;
+}
+
+int SFrameReplaySource::frameCount() const
+{
+    return m_recording.frameCount();
+}
+
+int SFrameReplaySource::deliveredFrames() const
+{
+    return m_deliveredFrames;
+}
+
+void SFrameReplaySource::start()
+{
+    stop();
+
+    if (m_recording.frameCount() == 0) {
+        emit errorOccured("Frame recording has no frames");
+        return;
+    }
+
+    if (m_videoSink.isNull()) {
+        emit errorOccured("No video sink to replay frames into");
+        return;
+    }
+
+    // Frames of the camera would be mixed with the recorded ones
+    if (auto scanner = qobject_cast<SBarcodeScanner *>(m_videoSink)) {
+        scanner->setCamera(nullptr);
+    }
+
+    m_position = 0;
+    m_loop = 0;
+    m_deliveredFrames = 0;
+    emit deliveredFramesChanged();
+
+    setRunning(true);
+    m_timer.start(0);
+}
+
+void SFrameReplaySource::stop()
+{
+    m_timer.stop();
+    setRunning(false);
+}
+
+void SFrameReplaySource::deliverFrame()
+{
+    if (m_videoSink.isNull()) {
+        stop();
+        return;
+    }
+
+    if (m_position == 0) {
+        m_loopClock.start();
+    }
+
+    const QVideoFrame frame = m_recording.frame(m_position);
+
+    if (frame.isValid()) {
+        m_videoSink->setVideoFrame(frame);
+    } else {
+        emit errorOccured(QStringLiteral("Frame %1 of the recording has unsupported pixel format").arg(m_position));
+    }
+
+    ++m_deliveredFrames;
+    emit deliveredFramesChanged();
+
+    const int frameCount = m_recording.frameCount();
+
+    if (++m_position == frameCount) {
+        m_position = 0;
+
+        if (m_loops >= 0 && ++m_loop >= m_loops) {
+            setRunning(false);
+            emit finished();
+            return;
+        }
+    }
+
+    int delay = 0;
+
+    if (m_realTime && frameCount > 1) {
+        const qint64 first = m_recording.timestamp(0);
+
+        // The next loop starts one frame interval after the last frame
+        const qint64 due = m_position > 0 ? m_recording.timestamp(m_position) - first
+                                          : m_recording.timestamp(1) - first;
+        const qint64 elapsed = m_position > 0 ? m_loopClock.nsecsElapsed() / 1000 : 0;
+
+        delay = int(qBound<qint64>(0, (due - elapsed + 500) / 1000, std::numeric_limits<int>::max()));
+    }
+
+    m_timer.start(delay);
+}
+
+void SFrameReplaySource::setRunning(bool running)
+{
+    if (m_running == running) {
+        return;
+    }
+
+    m_running = running;
+    emit runningChanged(m_running);
+}
@@ -0,0 +1,112 @@
+#ifndef SFRAMEREPLAYSOURCE_H
+#define SFRAMEREPLAYSOURCE_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QUrl>
+#include <QVideoSink>
+#include <qqml.h>
+
+#include "private/FrameRecording.h"
+
+/*!
+ * \brief The SFrameReplaySource class feeds frames of a recording into a video sink, usually SBarcodeScanner, in
+ * place of a camera. Frames are read from the memory-mapped recording and delivered on the thread of this object,
+ * either at their recorded timestamps or as fast as possible. Recordings are written by the recordingPath
+ * property of SBarcodeScanner.
+ */
+class SFrameReplaySource : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    /// Recording file, path or local file URL
+    Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
+    /// Sink receiving the frames, e.g. SBarcodeScanner. A scanner's camera is released when the replay starts
+    Q_PROPERTY(QVideoSink* videoSink READ videoSink WRITE setVideoSink NOTIFY videoSinkChanged)
+    /// Set to true to deliver frames at the recorded timestamps, false to deliver them as fast as possible (default true)
+    Q_PROPERTY(bool realTime READ realTime WRITE setRealTime NOTIFY realTimeChanged)
+    /// Number of times the recording is played, -1 to repeat until stopped (default 1)
+    Q_PROPERTY(int loops READ loops WRITE setLoops NOTIFY loopsChanged)
+    /// Set to true while frames are delivered
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    /// Number of frames in the recording
+    Q_PROPERTY(int frameCount READ frameCount NOTIFY sourceChanged)
+    /// Number of frames delivered since start()
+    Q_PROPERTY(int deliveredFrames READ deliveredFrames NOTIFY deliveredFramesChanged)
+
+public:
+    /*!
+     * \fn explicit SFrameReplaySource(QObject *parent)
+     * \brief Constructor.
+     * \param QObject *parent - a pointer to the parent object.
+     */
+    explicit SFrameReplaySource(QObject *parent = nullptr);
+
+    QUrl source() const;
+    void setSource(const QUrl &source);
+    QVideoSink *videoSink() const;
+    void setVideoSink(QVideoSink *sink);
+    bool realTime() const;
+    void setRealTime(bool realTime);
+    int loops() const;
+    void setLoops(int loops);
+    bool running() const;
+    int frameCount() const;
+    int deliveredFrames() const;
+
+public slots:
+    /*!
+     * \fn void start()
+     * \brief Starts delivering frames from the first one.
+     */
+    void start();
+
+    /*!
+     * \fn void stop()
+     * \brief Stops delivering frames.
+     */
+    void stop();
+
+signals:
+    void sourceChanged();
+    void videoSinkChanged();
+    void realTimeChanged(bool realTime);
+    void loopsChanged(int loops);
+    void runningChanged(bool running);
+    void deliveredFramesChanged();
+    /// This signal is emitted when the last loop of the recording has been delivered
+    void finished();
+    void errorOccured(const QString &errorString);
+
+private:
+    /*!
+     * \fn void deliverFrame()
+     * \brief Passes the current frame to the sink and schedules the next one.
+     */
+    void deliverFrame();
+
+    /*!
+     * \fn void setRunning(bool running)
+     * \brief Sets running state and emits runningChanged.
+     */
+    void setRunning(bool running);
+
+    QUrl m_source;
+    QPointer<QVideoSink> m_videoSink;
+    SCodes::FrameRecording m_recording;
+    /// Fires when the next frame is due
+    QTimer m_timer;
+    /// Time since the start of the current loop
+    QElapsedTimer m_loopClock;
+    bool m_realTime = true;
+    int m_loops = 1;
+    bool m_running = false;
+    int m_position = 0;
+    int m_loop = 0;
+    int m_deliveredFrames = 0;
+};
+
+#endif // SFRAMEREPLAYSOURCE_H
@@ -0,0 +1,51 @@
+#include "BarcodeEncoder.h"
+
+#include "BitMatrix.h"
+#include "MultiFormatWriter.h"
+
+bool SCodes::canEncode(SBarcodeFormat format)
+{
+    switch (format) {
+    case SBarcodeFormat::Aztec:
+    case SBarcodeFormat::Codabar:
+    case SBarcodeFormat::Code39:
+    case SBarcodeFormat::Code93:
+    case SBarcodeFormat::Code128:
+    case SBarcodeFormat::DataMatrix:
+    case SBarcodeFormat::EAN8:
+    case SBarcodeFormat::EAN13:
+    case SBarcodeFormat::ITF:
+    case SBarcodeFormat::PDF417:
+    case SBarcodeFormat::QRCode:
+    case SBarcodeFormat::UPCA:
+    case SBarcodeFormat::UPCE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+QImage SCodes::encodeBarcode(SBarcodeFormat format, const QString &text, int width, int height, int margin,
+                             int eccLevel, const QColor &foreground, const QColor &background)
+{
+    ZXing::MultiFormatWriter writer = ZXing::MultiFormatWriter(toZXingFormat(format))
+                                        .setMargin(margin)
+                                        .setEccLevel(eccLevel);
+
+    const ZXing::BitMatrix matrix = writer.encode(text.toStdString(), width, height);
+
+    QImage image(matrix.width(), matrix.height(), QImage::Format_ARGB32);
+    const QRgb dark  = foreground.rgba();
+    const QRgb light = background.rgba();
+
+    // Whole scanlines are written, setPixelColor() per pixel is an order of magnitude slower
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = matrix.get(x, y) ? dark : light;
+        }
+    }
+
+    return image;
+}
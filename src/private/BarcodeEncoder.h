@@ -0,0 +1,39 @@
+/*!
+ * This file contains the barcode encoder shared by SBarcodeGenerator and the benchmark corpus.
+ */
+#ifndef BARCODEENCODER_H
+#define BARCODEENCODER_H
+
+#include <QColor>
+#include <QImage>
+#include <QString>
+
+#include "SBarcodeFormat.h"
+
+namespace SCodes {
+/*!
+ * \fn bool canEncode(SBarcodeFormat format)
+ * \brief Returns true if ZXing has a writer for the format.
+ * \param SBarcodeFormat format - single barcode format.
+ */
+bool canEncode(SBarcodeFormat format);
+
+/*!
+ * \fn QImage encodeBarcode(SBarcodeFormat format, const QString &text, int width, int height, int margin, int eccLevel, const QColor &foreground, const QColor &background)
+ * \brief Encodes the text and renders it as ARGB32 image. Modules are scaled by the largest integer factor
+ * fitting the size, width and height of 0 give one pixel per module, linear barcodes are one pixel high then.
+ * Throws std::exception subclasses if the text can't be encoded in the format.
+ * \param SBarcodeFormat format - single barcode format.
+ * \param const QString &text - content of the barcode.
+ * \param int width - minimum image width in pixels.
+ * \param int height - minimum image height in pixels.
+ * \param int margin - quiet zone, see ZXing::MultiFormatWriter::setMargin.
+ * \param int eccLevel - error correction level, see ZXing::MultiFormatWriter::setEccLevel.
+ * \param const QColor &foreground - color of the dark modules.
+ * \param const QColor &background - color of the light modules.
+ */
+QImage encodeBarcode(SBarcodeFormat format, const QString &text, int width, int height, int margin, int eccLevel,
+                     const QColor &foreground = Qt::black, const QColor &background = Qt::white);
+}
+
+#endif // BARCODEENCODER_H
@@ -0,0 +1,125 @@
+#include "CameraFormatPolicy.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace {
+/*!
+ *  Formats covering the target with up to this many times its pixels count as a close fit
+ */
+constexpr qint64 k_closeFitAreaFactor = 2;
+
+/*!
+ * \fn int pixelFormatCost(QVideoFrameFormat::PixelFormat pixelFormat)
+ * \brief Returns rank of the pixel format by the work needed to get luminance out of it, lower is cheaper.
+ * Formats with a luminance plane, or luminance samples interleaved at a fixed stride, are decoded in place. 32 bit
+ * RGB needs a color conversion pass, other formats go through Qt's conversion to an image and MJPEG decompression
+ * first. Matches the frame layouts SBarcodeDecoder reads directly.
+ */
+int pixelFormatCost(QVideoFrameFormat::PixelFormat pixelFormat)
+{
+    switch (pixelFormat) {
+    case QVideoFrameFormat::Format_NV12:
+    case QVideoFrameFormat::Format_NV21:
+    case QVideoFrameFormat::Format_YUV420P:
+    case QVideoFrameFormat::Format_YUV422P:
+    case QVideoFrameFormat::Format_YV12:
+    case QVideoFrameFormat::Format_IMC1:
+    case QVideoFrameFormat::Format_IMC2:
+    case QVideoFrameFormat::Format_IMC3:
+    case QVideoFrameFormat::Format_IMC4:
+    case QVideoFrameFormat::Format_Y8:
+    case QVideoFrameFormat::Format_Y16:
+    case QVideoFrameFormat::Format_P010:
+    case QVideoFrameFormat::Format_P016:
+    case QVideoFrameFormat::Format_YUYV:
+    case QVideoFrameFormat::Format_UYVY:
+        return 0;
+    case QVideoFrameFormat::Format_ARGB8888:
+    case QVideoFrameFormat::Format_ARGB8888_Premultiplied:
+    case QVideoFrameFormat::Format_XRGB8888:
+    case QVideoFrameFormat::Format_BGRA8888:
+    case QVideoFrameFormat::Format_BGRA8888_Premultiplied:
+    case QVideoFrameFormat::Format_BGRX8888:
+    case QVideoFrameFormat::Format_ABGR8888:
+    case QVideoFrameFormat::Format_XBGR8888:
+    case QVideoFrameFormat::Format_RGBA8888:
+    case QVideoFrameFormat::Format_RGBX8888:
+        return 1;
+    case QVideoFrameFormat::Format_Jpeg:
+        return 3;
+    case QVideoFrameFormat::Format_Invalid:
+        return 4;
+    default:
+        return 2;
+    }
+}
+
+/*!
+ * \fn int resolutionFit(const QSize &resolution, const QSize &target)
+ * \brief Returns 0 for resolutions covering the target closely, 1 for larger ones and 2 for those not covering it.
+ * Portrait and landscape orientations of the target are treated alike.
+ */
+int resolutionFit(const QSize &resolution, const QSize &target)
+{
+    if (!target.isValid() || target.isEmpty()) {
+        return 0;
+    }
+
+    const bool covers = (resolution.width() >= target.width() && resolution.height() >= target.height())
+                        || (resolution.width() >= target.height() && resolution.height() >= target.width());
+
+    if (!covers) {
+        return 2;
+    }
+
+    const qint64 area = qint64(resolution.width()) * resolution.height();
+    const qint64 targetArea = qint64(target.width()) * target.height();
+    return area <= targetArea * k_closeFitAreaFactor ? 0 : 1;
+}
+}
+
+QCameraFormat SCodes::selectCameraFormat(const QList<QCameraFormat> &formats, const CameraFormatPolicy &policy)
+{
+    if (formats.isEmpty()) {
+        return {};
+    }
+
+    const bool hasTarget = policy.targetResolution.isValid() && !policy.targetResolution.isEmpty();
+
+    // Lexicographic key, the smallest one wins. Without target or covering format the largest one is taken
+    const auto key = [&policy, hasTarget](const QCameraFormat &format) {
+        const QSize resolution = format.resolution();
+        const qint64 area = qint64(resolution.width()) * resolution.height();
+        const int fit = resolutionFit(resolution, policy.targetResolution);
+        const bool fastEnough = format.maxFrameRate() >= policy.minFrameRate;
+
+        return std::make_tuple(fastEnough ? 0 : 1,
+                               fit,
+                               policy.preferLumaFormats ? pixelFormatCost(format.pixelFormat()) : 0,
+                               (fit == 2 || !hasTarget) ? -area : area,
+                               -format.maxFrameRate());
+    };
+
+    return *std::min_element(formats.cbegin(), formats.cend(), [&key](const auto &f1, const auto &f2) {
+        return key(f1) < key(f2);
+    });
+}
+
+bool SCodes::isDecodedInPlace(QVideoFrameFormat::PixelFormat pixelFormat)
+{
+    return pixelFormatCost(pixelFormat) == 0;
+}
+
+QString SCodes::describeCameraFormat(const QCameraFormat &format)
+{
+    if (format.isNull()) {
+        return QString();
+    }
+
+    return QStringLiteral("%1 %2x%3 @ %4 fps")
+        .arg(QVideoFrameFormat::pixelFormatToString(format.pixelFormat()))
+        .arg(format.resolution().width())
+        .arg(format.resolution().height())
+        .arg(format.maxFrameRate());
+}
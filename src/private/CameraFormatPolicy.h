@@ -0,0 +1,52 @@
+/*!
+ * This file contains the camera format policy, which picks the camera format that is cheapest to decode at the
+ * wanted resolution and frame rate instead of the one with most pixels.
+ */
+#ifndef CAMERAFORMATPOLICY_H
+#define CAMERAFORMATPOLICY_H
+
+#include <QCameraFormat>
+#include <QList>
+#include <QSize>
+#include <QString>
+#include <QVideoFrameFormat>
+
+namespace SCodes {
+/*!
+ * \brief The CameraFormatPolicy struct describes the camera format wanted for decoding.
+ */
+struct CameraFormatPolicy {
+    /// Resolution decoded frames should cover, larger formats only add work. Invalid for the largest format
+    QSize targetResolution { 1280, 720 };
+    /// Formats reaching lower frame rates are taken only if no other format reaches it
+    qreal minFrameRate = 15;
+    /// Prefer formats decoded in place (NV12, YUV420P, YUYV, Y16, ...) over RGB and MJPEG
+    bool preferLumaFormats = true;
+};
+
+/*!
+ * \fn QCameraFormat selectCameraFormat(const QList<QCameraFormat> &formats, const CameraFormatPolicy &policy)
+ * \brief Returns the format to decode from. Formats reaching the minimum frame rate come first, then those
+ * covering the target resolution without exceeding it by much, then the luminance friendly pixel formats. Ties are
+ * broken by the smaller covering resolution, or the larger one if none covers the target, and the higher frame rate.
+ * \param const QList<QCameraFormat> &formats - formats supported by the camera device.
+ * \param const CameraFormatPolicy &policy - wanted resolution, frame rate and pixel formats.
+ * \return null format if the list is empty.
+ */
+QCameraFormat selectCameraFormat(const QList<QCameraFormat> &formats, const CameraFormatPolicy &policy);
+
+/*!
+ * \fn bool isDecodedInPlace(QVideoFrameFormat::PixelFormat pixelFormat)
+ * \brief Returns true if frames of the pixel format are decoded right in their mapped memory, without converting
+ * them into a buffer first.
+ */
+bool isDecodedInPlace(QVideoFrameFormat::PixelFormat pixelFormat);
+
+/*!
+ * \fn QString describeCameraFormat(const QCameraFormat &format)
+ * \brief Returns a short description of the format for diagnostics, e.g. "NV12 1280x720 @ 30 fps".
+ */
+QString describeCameraFormat(const QCameraFormat &format);
+}
+
+#endif // CAMERAFORMATPOLICY_H
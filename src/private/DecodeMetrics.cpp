@@ -0,0 +1,166 @@
+#include "DecodeMetrics.h"
+
+#include <algorithm>
+
+namespace {
+/*!
+ *  Number of bits below the most significant one selecting the bucket within a power of two
+ */
+constexpr int k_subBucketBits = 2;
+constexpr int k_subBuckets    = 1 << k_subBucketBits;
+
+/*!
+ * \fn int mostSignificantBit(uint64_t value)
+ * \brief Returns index of the highest set bit, value must not be 0.
+ */
+int mostSignificantBit(uint64_t value)
+{
+    int bit = 0;
+
+    while (value >>= 1) {
+        ++bit;
+    }
+
+    return bit;
+}
+}
+
+void SCodes::LatencyHistogram::record(uint64_t microseconds)
+{
+    m_buckets[size_t(bucketIndex(microseconds))].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(microseconds, std::memory_order_relaxed);
+
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+
+    while (microseconds > max && !m_max.compare_exchange_weak(max, microseconds, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t SCodes::LatencyHistogram::count() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+double SCodes::LatencyHistogram::mean() const
+{
+    const uint64_t count = this->count();
+    return count == 0 ? 0.0 : double(m_sum.load(std::memory_order_relaxed)) / count;
+}
+
+double SCodes::LatencyHistogram::max() const
+{
+    return double(m_max.load(std::memory_order_relaxed));
+}
+
+double SCodes::LatencyHistogram::percentile(double fraction) const
+{
+    std::array<uint64_t, k_bucketCount> buckets;
+    uint64_t total = 0;
+
+    // Bucket counts are summed up from the copy, so the total matches them
+    for (int i = 0; i < k_bucketCount; ++i) {
+        buckets[size_t(i)] = m_buckets[size_t(i)].load(std::memory_order_relaxed);
+        total += buckets[size_t(i)];
+    }
+
+    if (total == 0) {
+        return 0.0;
+    }
+
+    const double rank = std::clamp(fraction, 0.0, 1.0) * double(total);
+    uint64_t below = 0;
+
+    for (int i = 0; i < k_bucketCount; ++i) {
+        const uint64_t inBucket = buckets[size_t(i)];
+
+        if (inBucket > 0 && double(below + inBucket) >= rank) {
+            const double lower = double(bucketLowerBound(i));
+            // The open-ended last bucket reaches up to the longest recorded duration
+            const double upper = i + 1 < k_bucketCount ? double(bucketLowerBound(i + 1)) : std::max(lower, max());
+            const double position = (rank - double(below)) / double(inBucket);
+
+            return std::min(lower + (upper - lower) * position, std::max(lower, max()));
+        }
+
+        below += inBucket;
+    }
+
+    return max();
+}
+
+void SCodes::LatencyHistogram::reset()
+{
+    for (auto &bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+int SCodes::LatencyHistogram::bucketIndex(uint64_t microseconds)
+{
+    // Durations below k_subBuckets have a bucket each, longer ones k_subBuckets per power of two
+    if (microseconds < uint64_t(k_subBuckets)) {
+        return int(microseconds);
+    }
+
+    const int msb = mostSignificantBit(microseconds);
+    const int sub = int((microseconds >> (msb - k_subBucketBits)) & (k_subBuckets - 1));
+
+    return std::min(k_bucketCount - 1, (msb - k_subBucketBits + 1) * k_subBuckets + sub);
+}
+
+uint64_t SCodes::LatencyHistogram::bucketLowerBound(int index)
+{
+    if (index < k_subBuckets) {
+        return uint64_t(index);
+    }
+
+    const int msb = index / k_subBuckets + k_subBucketBits - 1;
+    const int sub = index % k_subBuckets;
+
+    return uint64_t(k_subBuckets + sub) << (msb - k_subBucketBits);
+}
+
+SCodes::DecodeMetrics &SCodes::DecodeMetrics::instance()
+{
+    static DecodeMetrics metrics;
+    return metrics;
+}
+
+void SCodes::DecodeMetrics::recordHit(int format)
+{
+    // Single formats are powers of two, combined or unknown values are not counted
+    if (format <= 0 || (format & (format - 1)) != 0) {
+        return;
+    }
+
+    const int index = mostSignificantBit(uint64_t(format));
+
+    if (index < k_singleFormatCount) {
+        m_hits[size_t(index)].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint64_t SCodes::DecodeMetrics::hits(int formatIndex) const
+{
+    return formatIndex >= 0 && formatIndex < k_singleFormatCount
+      ? m_hits[size_t(formatIndex)].load(std::memory_order_relaxed)
+      : 0;
+}
+
+void SCodes::DecodeMetrics::reset()
+{
+    framesReceived.store(0, std::memory_order_relaxed);
+    framesProcessed.store(0, std::memory_order_relaxed);
+    framesDropped.store(0, std::memory_order_relaxed);
+    conversionTime.reset();
+    decodeTime.reset();
+
+    for (auto &hits : m_hits) {
+        hits.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,163 @@
+/*!
+ * This file contains the decode metrics registry, process-wide counters and latency histograms which are always
+ * collected, cheap enough to stay enabled in release builds.
+ */
+#ifndef DECODEMETRICS_H
+#define DECODEMETRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "SBarcodeFormat.h"
+
+namespace SCodes {
+/*!
+ * \brief The LatencyHistogram class counts durations in fixed buckets, four per power of two microseconds, so any
+ * percentile is known within 12.5 % up to almost two minutes. Recording is lock-free, all methods are thread safe.
+ */
+class LatencyHistogram
+{
+public:
+    /*!
+     *  Number of buckets, the last one also counts all longer durations
+     */
+    static constexpr int k_bucketCount = 104;
+
+    /*!
+     * \fn void record(uint64_t microseconds)
+     * \brief Adds a duration.
+     * \param uint64_t microseconds - duration in microseconds.
+     */
+    void record(uint64_t microseconds);
+
+    /*!
+     * \fn uint64_t count() const
+     * \brief Returns number of recorded durations.
+     */
+    uint64_t count() const;
+
+    /*!
+     * \fn double mean() const
+     * \brief Returns mean duration in microseconds, 0 if nothing was recorded.
+     */
+    double mean() const;
+
+    /*!
+     * \fn double max() const
+     * \brief Returns the longest duration in microseconds.
+     */
+    double max() const;
+
+    /*!
+     * \fn double percentile(double fraction) const
+     * \brief Returns the duration in microseconds not exceeded by the given fraction of recorded durations,
+     * interpolated within its bucket. Recording meanwhile may skew the result by the concurrently added durations.
+     * \param double fraction - fraction of durations, 0.5 for the median.
+     */
+    double percentile(double fraction) const;
+
+    /*!
+     * \fn void reset()
+     * \brief Forgets all recorded durations.
+     */
+    void reset();
+
+    /*!
+     * \fn static int bucketIndex(uint64_t microseconds)
+     * \brief Returns the bucket counting the duration.
+     */
+    static int bucketIndex(uint64_t microseconds);
+
+    /*!
+     * \fn static uint64_t bucketLowerBound(int index)
+     * \brief Returns the shortest duration in microseconds counted by the bucket.
+     */
+    static uint64_t bucketLowerBound(int index);
+
+private:
+    std::array<std::atomic<uint64_t>, k_bucketCount> m_buckets {};
+    std::atomic<uint64_t> m_count { 0 };
+    std::atomic<uint64_t> m_sum { 0 };
+    std::atomic<uint64_t> m_max { 0 };
+};
+
+/*!
+ * \brief The DecodeMetrics class is the process-wide registry of frame counters, conversion and decoding latencies
+ * and barcodes found per format. All methods are thread safe.
+ */
+class DecodeMetrics
+{
+public:
+    /*!
+     * \fn static DecodeMetrics &instance()
+     * \brief Returns the registry shared by the whole process.
+     */
+    static DecodeMetrics &instance();
+
+    /// Frames delivered by the camera while scanning
+    std::atomic<uint64_t> framesReceived { 0 };
+    /// Frames decoded
+    std::atomic<uint64_t> framesProcessed { 0 };
+    /// Frames never decoded, because they were replaced by newer ones, too old, blurred or moving
+    std::atomic<uint64_t> framesDropped { 0 };
+
+    /// Time spent converting frames to luminance images
+    LatencyHistogram conversionTime;
+    /// Time spent decoding a single image, all passes included
+    LatencyHistogram decodeTime;
+
+    /*!
+     * \fn void recordHit(int format)
+     * \brief Counts a decoded barcode.
+     * \param int format - single SBarcodeFormat value of the barcode.
+     */
+    void recordHit(int format);
+
+    /*!
+     * \fn uint64_t hits(int formatIndex) const
+     * \brief Returns number of decoded barcodes of the format.
+     * \param int formatIndex - bit index of the SBarcodeFormat value, from 0 to k_singleFormatCount - 1.
+     */
+    uint64_t hits(int formatIndex) const;
+
+    /*!
+     * \fn void reset()
+     * \brief Sets all counters and histograms to zero.
+     */
+    void reset();
+
+private:
+    DecodeMetrics() = default;
+
+    std::array<std::atomic<uint64_t>, k_singleFormatCount> m_hits {};
+};
+
+/*!
+ * \brief The LatencyTimer class records the time from its construction to its destruction in a histogram.
+ */
+class LatencyTimer
+{
+public:
+    explicit LatencyTimer(LatencyHistogram &histogram)
+        : m_histogram(histogram)
+        , m_start(std::chrono::steady_clock::now())
+    { }
+
+    ~LatencyTimer()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_histogram.record(uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    LatencyTimer(const LatencyTimer &) = delete;
+    LatencyTimer &operator=(const LatencyTimer &) = delete;
+
+private:
+    LatencyHistogram &m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+}
+
+#endif // DECODEMETRICS_H
@@ -0,0 +1,186 @@
+#include "DecodePool.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <string>
+
+namespace {
+/*!
+ *  Pool and index of the worker running on the current thread, used to keep tasks submitted by a task local
+ */
+thread_local const SCodes::DecodePool *t_pool = nullptr;
+thread_local int t_workerIndex = -1;
+
+/*!
+ * \fn int defaultWorkerCount()
+ * \brief Returns number of CPU cores, at least 1.
+ */
+int defaultWorkerCount()
+{
+    return std::max(1, int(std::thread::hardware_concurrency()));
+}
+}
+
+struct SCodes::DecodePool::Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+    std::thread thread;
+};
+
+SCodes::DecodePool &SCodes::DecodePool::instance()
+{
+    static DecodePool pool;
+    return pool;
+}
+
+SCodes::DecodePool::DecodePool()
+{
+    std::unique_lock<std::shared_mutex> lock(m_controlMutex);
+    startWorkers(defaultWorkerCount(), {});
+}
+
+SCodes::DecodePool::~DecodePool()
+{
+    std::lock_guard<std::mutex> restartLock(m_restartMutex);
+    joinWorkers();
+}
+
+int SCodes::DecodePool::workerCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_controlMutex);
+    return int(m_workers.size());
+}
+
+void SCodes::DecodePool::setWorkerCount(int count)
+{
+    count = count > 0 ? count : defaultWorkerCount();
+
+    std::lock_guard<std::mutex> restartLock(m_restartMutex);
+
+    if (workerCount() == count) {
+        return;
+    }
+
+    // Tasks running meanwhile may still submit, the old queues are only collected once the workers are gone
+    joinWorkers();
+
+    std::unique_lock<std::shared_mutex> lock(m_controlMutex);
+    std::vector<Task> tasks;
+
+    for (auto &worker : m_workers) {
+        std::move(worker->tasks.begin(), worker->tasks.end(), std::back_inserter(tasks));
+    }
+
+    m_workers.clear();
+    startWorkers(count, std::move(tasks));
+}
+
+void SCodes::DecodePool::submit(Task task)
+{
+    std::shared_lock<std::shared_mutex> lock(m_controlMutex);
+
+    const int index = t_pool == this && t_workerIndex < int(m_workers.size())
+      ? t_workerIndex
+      : int(m_nextWorker++ % m_workers.size());
+
+    {
+        Worker &worker = *m_workers[index];
+        std::lock_guard<std::mutex> workerLock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+
+    ++m_queued;
+
+    // Taking the sleep mutex orders the increment before the check of a worker going to sleep
+    {
+        std::lock_guard<std::mutex> sleepLock(m_sleepMutex);
+    }
+
+    m_wakeUp.notify_one();
+}
+
+void SCodes::DecodePool::startWorkers(int count, std::vector<Task> tasks)
+{
+    {
+        std::lock_guard<std::mutex> sleepLock(m_sleepMutex);
+        m_stopping = false;
+    }
+
+    m_queued = int(tasks.size());
+    m_workers.reserve(size_t(count));
+
+    for (int i = 0; i < count; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        m_workers[i % size_t(count)]->tasks.push_back(std::move(tasks[i]));
+    }
+
+    for (int i = 0; i < count; ++i) {
+        m_workers[size_t(i)]->thread = std::thread([this, i]() { run(i); });
+    }
+}
+
+void SCodes::DecodePool::joinWorkers()
+{
+    {
+        std::lock_guard<std::mutex> sleepLock(m_sleepMutex);
+        m_stopping = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    std::shared_lock<std::shared_mutex> lock(m_controlMutex);
+
+    for (auto &worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void SCodes::DecodePool::run(int index)
+{
+    t_pool = this;
+    t_workerIndex = index;
+    Trace::setThreadName("SCodes decode " + std::to_string(index));
+
+    Task task;
+
+    for (;;) {
+        // A restart leaves the queued tasks to the new workers
+        if (m_stopping) {
+            return;
+        }
+
+        if (next(index, task)) {
+            task();
+            // Captures are released before sleeping, not when the next task arrives
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> sleepLock(m_sleepMutex);
+        m_wakeUp.wait(sleepLock, [this]() { return m_stopping || m_queued > 0; });
+    }
+}
+
+bool SCodes::DecodePool::next(int index, Task &task)
+{
+    const size_t count = m_workers.size();
+
+    for (size_t i = 0; i < count; ++i) {
+        Worker &worker = *m_workers[(size_t(index) + i) % count];
+        std::lock_guard<std::mutex> workerLock(worker.mutex);
+
+        if (!worker.tasks.empty()) {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+            --m_queued;
+            return true;
+        }
+    }
+
+    return false;
+}
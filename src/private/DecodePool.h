@@ -0,0 +1,106 @@
+/*!
+ * This file contains the decode pool, a process-wide set of worker threads shared by all scanners.
+ */
+#ifndef DECODEPOOL_H
+#define DECODEPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace SCodes {
+/*!
+ * \brief The DecodePool class runs decoding tasks on a fixed number of worker threads. Every worker has its own
+ * queue, tasks submitted from a worker stay on its queue and idle workers steal the oldest tasks of busy ones, so
+ * frames of one or several scanners are spread over all cores without a single contended queue. All methods are
+ * thread safe.
+ */
+class DecodePool
+{
+public:
+    using Task = std::function<void()>;
+
+    /*!
+     * \fn static DecodePool &instance()
+     * \brief Returns the pool shared by the whole process, its workers are started on first use.
+     */
+    static DecodePool &instance();
+
+    ~DecodePool();
+
+    DecodePool(const DecodePool &) = delete;
+    DecodePool &operator=(const DecodePool &) = delete;
+
+    /*!
+     * \fn int workerCount() const
+     * \brief Returns number of worker threads.
+     */
+    int workerCount() const;
+
+    /*!
+     * \fn void setWorkerCount(int count)
+     * \brief Restarts the pool with the given number of workers, queued tasks are kept. Waits for running tasks,
+     * so it must not be called from a task.
+     * \param int count - number of workers, 0 or less means one per CPU core.
+     */
+    void setWorkerCount(int count);
+
+    /*!
+     * \fn void submit(Task task)
+     * \brief Queues the task, it runs on one of the workers.
+     * \param Task task - function to be run.
+     */
+    void submit(Task task);
+
+private:
+    struct Worker;
+
+    DecodePool();
+
+    /*!
+     * \fn void startWorkers(int count, std::vector<Task> tasks)
+     * \brief Starts the workers and distributes the tasks over their queues. Called with m_controlMutex locked.
+     */
+    void startWorkers(int count, std::vector<Task> tasks);
+
+    /*!
+     * \fn void joinWorkers()
+     * \brief Wakes up and joins all workers. Running tasks are finished, queued ones stay in the queues.
+     */
+    void joinWorkers();
+
+    /*!
+     * \fn void run(int index)
+     * \brief Worker thread loop.
+     */
+    void run(int index);
+
+    /*!
+     * \fn bool next(int index, Task &task)
+     * \brief Pops the oldest task of the worker, or steals the oldest task of another worker.
+     * \return false if all queues are empty.
+     */
+    bool next(int index, Task &task);
+
+    /// Serializes setWorkerCount() calls
+    std::mutex m_restartMutex;
+    /// Guards the worker list, submissions share it while setWorkerCount() replaces the list
+    mutable std::shared_mutex m_controlMutex;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<unsigned> m_nextWorker { 0 };
+
+    /// Number of queued tasks, idle workers sleep on m_wakeUp until it is positive
+    std::atomic<int> m_queued { 0 };
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeUp;
+    std::atomic<bool> m_stopping { false };
+};
+}
+
+#endif // DECODEPOOL_H
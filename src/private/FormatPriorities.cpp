@@ -0,0 +1,213 @@
+#include "FormatPriorities.h"
+
+#include <QSettings>
+#include <QtAlgorithms>
+#include <QVariantMap>
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+/*!
+ *  Default QSettings key of the statistics
+ */
+const QString k_defaultSettingsKey = QStringLiteral("SCodes/formatHits");
+
+/*!
+ * \fn SCodes::SBarcodeFormat formatAt(int index)
+ * \brief Returns the single format with the given bit index.
+ */
+SCodes::SBarcodeFormat formatAt(int index)
+{
+    return static_cast<SCodes::SBarcodeFormat>(1 << index);
+}
+
+/*!
+ * \fn const std::array<ZXing::BarcodeFormat, SCodes::k_singleFormatCount> &zxingFormats()
+ * \brief Returns ZXing formats by bit index of the SCodes formats, translated once.
+ */
+const std::array<ZXing::BarcodeFormat, SCodes::k_singleFormatCount> &zxingFormats()
+{
+    static const auto formats = []() {
+        std::array<ZXing::BarcodeFormat, SCodes::k_singleFormatCount> translated {};
+
+        for (int i = 0; i < SCodes::k_singleFormatCount; ++i) {
+            translated[size_t(i)] = SCodes::toZXingFormat(formatAt(i));
+        }
+
+        return translated;
+    }();
+
+    return formats;
+}
+
+/*!
+ * \fn int formatIndex(SCodes::SBarcodeFormat format)
+ * \brief Returns bit index of a single format, -1 for combined or unknown formats.
+ */
+int formatIndex(SCodes::SBarcodeFormat format)
+{
+    const uint value = uint(format);
+
+    if (value == 0 || (value & (value - 1)) != 0) {
+        return -1;
+    }
+
+    const int index = qCountTrailingZeroBits(value);
+    return index < SCodes::k_singleFormatCount ? index : -1;
+}
+}
+
+SCodes::FormatPriorities::FormatPriorities()
+    : m_settingsKey(k_defaultSettingsKey)
+{
+}
+
+void SCodes::FormatPriorities::recordHit(SBarcodeFormat format)
+{
+    const int index = formatIndex(format);
+
+    if (index < 0) {
+        return;
+    }
+
+    m_hits[size_t(index)].fetch_add(1, std::memory_order_relaxed);
+
+    if (m_total.fetch_add(1, std::memory_order_relaxed) + 1 >= k_decayLimit && m_mutex.try_lock()) {
+        // Older hits weigh half, the sum is recounted as other threads may have added meanwhile
+        quint32 total = 0;
+
+        for (auto &hits : m_hits) {
+            const quint32 halved = hits.load(std::memory_order_relaxed) / 2;
+            hits.store(halved, std::memory_order_relaxed);
+            total += halved;
+        }
+
+        m_total.store(total, std::memory_order_relaxed);
+        m_mutex.unlock();
+    }
+
+    m_unsavedHits.fetch_add(1, std::memory_order_relaxed);
+}
+
+quint32 SCodes::FormatPriorities::hits(SBarcodeFormat format) const
+{
+    const int index = formatIndex(format);
+    return index < 0 ? 0 : m_hits[size_t(index)].load(std::memory_order_relaxed);
+}
+
+ZXing::BarcodeFormats SCodes::FormatPriorities::likelyFormats(ZXing::BarcodeFormats formats) const
+{
+    const auto &translated = zxingFormats();
+    std::array<std::pair<quint32, int>, k_singleFormatCount> candidates {};
+    int candidateCount = 0;
+    quint32 total = 0;
+
+    for (int i = 0; i < k_singleFormatCount; ++i) {
+        const quint32 hits = m_hits[size_t(i)].load(std::memory_order_relaxed);
+
+        if (hits > 0 && formats.testFlag(translated[size_t(i)])) {
+            candidates[size_t(candidateCount++)] = { hits, i };
+            total += hits;
+        }
+    }
+
+    if (total < k_minHits) {
+        return formats;
+    }
+
+    std::sort(candidates.begin(), candidates.begin() + candidateCount, std::greater<>());
+
+    ZXing::BarcodeFormats likely;
+    quint32 covered = 0;
+
+    for (int i = 0; i < std::min(candidateCount, k_maxLikelyFormats) && covered * 20 < total * 19; ++i) {
+        likely |= translated[size_t(candidates[size_t(i)].second)];
+        covered += candidates[size_t(i)].first;
+    }
+
+    return likely;
+}
+
+ZXing::BarcodeFormats SCodes::FormatPriorities::remainingFormats(ZXing::BarcodeFormats formats,
+                                                                 ZXing::BarcodeFormats tried)
+{
+    ZXing::BarcodeFormats remaining;
+
+    for (const auto format : zxingFormats()) {
+        if (formats.testFlag(format) && !tried.testFlag(format)) {
+            remaining |= format;
+        }
+    }
+
+    return remaining;
+}
+
+QString SCodes::FormatPriorities::settingsKey() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_settingsKey;
+}
+
+void SCodes::FormatPriorities::setSettingsKey(const QString &key)
+{
+    QMutexLocker locker(&m_mutex);
+    m_settingsKey = key;
+}
+
+void SCodes::FormatPriorities::load()
+{
+    QMutexLocker locker(&m_mutex);
+
+    const QVariantMap saved = m_settingsKey.isEmpty() ? QVariantMap() : QSettings().value(m_settingsKey).toMap();
+    quint32 total = 0;
+
+    for (int i = 0; i < k_singleFormatCount; ++i) {
+        const quint32 hits = saved.value(toString(formatAt(i))).toUInt();
+        m_hits[size_t(i)].store(hits, std::memory_order_relaxed);
+        total += hits;
+    }
+
+    m_total.store(total, std::memory_order_relaxed);
+    m_unsavedHits.store(0, std::memory_order_relaxed);
+}
+
+void SCodes::FormatPriorities::save()
+{
+    QMutexLocker locker(&m_mutex);
+    m_unsavedHits.store(0, std::memory_order_relaxed);
+
+    if (m_settingsKey.isEmpty()) {
+        return;
+    }
+
+    QVariantMap saved;
+
+    for (int i = 0; i < k_singleFormatCount; ++i) {
+        const quint32 hits = m_hits[size_t(i)].load(std::memory_order_relaxed);
+
+        if (hits > 0) {
+            saved.insert(toString(formatAt(i)), hits);
+        }
+    }
+
+    QSettings().setValue(m_settingsKey, saved);
+}
+
+void SCodes::FormatPriorities::saveChanges()
+{
+    if (m_unsavedHits.load(std::memory_order_relaxed) > 0) {
+        save();
+    }
+}
+
+void SCodes::FormatPriorities::reset()
+{
+    QMutexLocker locker(&m_mutex);
+
+    for (auto &hits : m_hits) {
+        hits.store(0, std::memory_order_relaxed);
+    }
+
+    m_total.store(0, std::memory_order_relaxed);
+}
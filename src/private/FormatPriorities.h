@@ -0,0 +1,110 @@
+/*!
+ * This file contains the format priorities, hit statistics of barcode formats used to try the formats a deployment
+ * actually sees before all configured ones.
+ */
+#ifndef FORMATPRIORITIES_H
+#define FORMATPRIORITIES_H
+
+#include <QMutex>
+#include <QString>
+
+#include <array>
+#include <atomic>
+
+#include "SBarcodeFormat.h"
+
+namespace SCodes {
+/*!
+ * \brief The FormatPriorities class counts decoded barcodes per format and narrows a format set to the formats
+ * covering most of the hits. Counts are halved once their sum reaches a limit, so the statistics follow changes of
+ * the scanned barcodes, and they are kept in QSettings between runs. All methods are thread safe.
+ */
+class FormatPriorities
+{
+public:
+    FormatPriorities();
+
+    /*!
+     * \fn void recordHit(SBarcodeFormat format)
+     * \brief Counts a decoded barcode. Never touches the settings, the owner saves the changed statistics with
+     * saveChanges().
+     * \param SBarcodeFormat format - single format of the barcode.
+     */
+    void recordHit(SBarcodeFormat format);
+
+    /*!
+     * \fn quint32 hits(SBarcodeFormat format) const
+     * \brief Returns the possibly halved number of hits of the format.
+     */
+    quint32 hits(SBarcodeFormat format) const;
+
+    /*!
+     * \fn ZXing::BarcodeFormats likelyFormats(ZXing::BarcodeFormats formats) const
+     * \brief Returns the most often decoded formats of the set, at most k_maxLikelyFormats covering 95 % of their
+     * hits. Returns the set unchanged until its formats were decoded often enough.
+     * \param ZXing::BarcodeFormats formats - configured formats.
+     */
+    ZXing::BarcodeFormats likelyFormats(ZXing::BarcodeFormats formats) const;
+
+    /*!
+     * \fn static ZXing::BarcodeFormats remainingFormats(ZXing::BarcodeFormats formats, ZXing::BarcodeFormats tried)
+     * \brief Returns the formats of the set not contained in tried, empty if there are none.
+     */
+    static ZXing::BarcodeFormats remainingFormats(ZXing::BarcodeFormats formats, ZXing::BarcodeFormats tried);
+
+    /*!
+     * \fn QString settingsKey() const
+     * \brief Returns the QSettings key the statistics are kept under.
+     */
+    QString settingsKey() const;
+
+    /*!
+     * \fn void setSettingsKey(const QString &key)
+     * \brief Sets the QSettings key, the statistics are not loaded until load() is called.
+     * \param const QString &key - settings key, empty to keep the statistics in memory only.
+     */
+    void setSettingsKey(const QString &key);
+
+    /*!
+     * \fn void load()
+     * \brief Replaces the statistics by those saved under the settings key.
+     */
+    void load();
+
+    /*!
+     * \fn void save()
+     * \brief Saves the statistics under the settings key.
+     */
+    void save();
+
+    /*!
+     * \fn void saveChanges()
+     * \brief Saves the statistics under the settings key if hits were counted since they were last saved or loaded.
+     */
+    void saveChanges();
+
+    /*!
+     * \fn void reset()
+     * \brief Forgets all hits, the saved statistics are kept until the next save().
+     */
+    void reset();
+
+private:
+    /// Maximum number of formats tried before the remaining ones
+    static constexpr int k_maxLikelyFormats = 3;
+    /// Number of hits needed before the format set is narrowed
+    static constexpr quint32 k_minHits = 10;
+    /// Sum of hits at which all counts are halved
+    static constexpr quint32 k_decayLimit = 1000;
+
+    std::array<std::atomic<quint32>, k_singleFormatCount> m_hits {};
+    std::atomic<quint32> m_total { 0 };
+    std::atomic<quint32> m_unsavedHits { 0 };
+
+    /// Guards the settings key and serializes halving, loading and saving
+    mutable QMutex m_mutex;
+    QString m_settingsKey;
+};
+}
+
+#endif // FORMATPRIORITIES_H
@@ -0,0 +1,118 @@
+#include "FrameBufferPool.h"
+
+#include <algorithm>
+
+namespace {
+/*!
+ *  Maximum number of free buffers kept by the pool, larger bursts are released to the system
+ */
+constexpr size_t k_maxFreeBuffers = 4;
+}
+
+/*!
+ * \brief Pool state shared with the buffers, so images can outlive the pool
+ */
+struct SCodes::FrameBufferPool::State {
+    QMutex mutex;
+    std::vector<Buffer *> free;
+    bool alive = true;
+};
+
+/*!
+ * \brief Pixel memory of a single image
+ */
+struct SCodes::FrameBufferPool::Buffer {
+    std::unique_ptr<uchar[]> data;
+    size_t capacity = 0;
+    std::shared_ptr<State> state;
+};
+
+SCodes::FrameBufferPool::FrameBufferPool()
+    : m_state(std::make_shared<State>())
+{
+    m_state->free.reserve(k_maxFreeBuffers);
+}
+
+SCodes::FrameBufferPool::~FrameBufferPool()
+{
+    QMutexLocker locker(&m_state->mutex);
+    m_state->alive = false;
+
+    for (Buffer *buffer : m_state->free) {
+        delete buffer;
+    }
+
+    m_state->free.clear();
+}
+
+void SCodes::FrameBufferPool::reserve(int count, size_t bytes)
+{
+    QMutexLocker locker(&m_state->mutex);
+    auto &free = m_state->free;
+
+    free.erase(std::remove_if(free.begin(), free.end(), [bytes](Buffer *buffer){
+        if (buffer->capacity >= bytes) {
+            return false;
+        }
+
+        delete buffer;
+        return true;
+    }), free.end());
+
+    while (free.size() < std::min(size_t(std::max(0, count)), k_maxFreeBuffers)) {
+        free.push_back(new Buffer{ std::unique_ptr<uchar[]>(new uchar[bytes]), bytes, m_state });
+    }
+}
+
+QImage SCodes::FrameBufferPool::image(const QSize &size, QImage::Format format)
+{
+    if (size.isEmpty()) {
+        return QImage();
+    }
+
+    const int depth = QImage::toPixelFormat(format).bitsPerPixel();
+    const int bytesPerLine = ((size.width() * depth + 31) / 32) * 4;
+    const size_t bytes = size_t(bytesPerLine) * size.height();
+
+    Buffer *buffer = nullptr;
+
+    {
+        QMutexLocker locker(&m_state->mutex);
+        auto &free = m_state->free;
+
+        // Smallest fitting buffer, so large buffers stay available for large images
+        auto best = free.end();
+
+        for (auto it = free.begin(); it != free.end(); ++it) {
+            if ((*it)->capacity >= bytes && (best == free.end() || (*it)->capacity < (*best)->capacity)) {
+                best = it;
+            }
+        }
+
+        if (best != free.end()) {
+            buffer = *best;
+            free.erase(best);
+        }
+    }
+
+    if (buffer == nullptr) {
+        buffer = new Buffer{ std::unique_ptr<uchar[]>(new uchar[bytes]), bytes, m_state };
+    }
+
+    return QImage(buffer->data.get(), size.width(), size.height(), bytesPerLine, format, &FrameBufferPool::release,
+                  buffer);
+}
+
+void SCodes::FrameBufferPool::release(void *info)
+{
+    auto buffer = static_cast<Buffer *>(info);
+    const std::shared_ptr<State> state = buffer->state;
+
+    QMutexLocker locker(&state->mutex);
+
+    if (state->alive && state->free.size() < k_maxFreeBuffers) {
+        state->free.push_back(buffer);
+    } else {
+        delete buffer;
+    }
+}
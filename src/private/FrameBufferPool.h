@@ -0,0 +1,59 @@
+/*!
+ * This file contains the frame buffer pool, which recycles pixel buffers of images used while decoding frames.
+ */
+#ifndef FRAMEBUFFERPOOL_H
+#define FRAMEBUFFERPOOL_H
+
+#include <QImage>
+#include <QMutex>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace SCodes {
+/*!
+ * \brief The FrameBufferPool class hands out images backed by recycled buffers. A buffer goes back to the pool
+ * when the last copy of its image is destroyed, on whatever thread that happens, so scanning frames of the same
+ * size does not allocate once the pool is warmed up. Images may outlive the pool. All methods are thread safe.
+ */
+class FrameBufferPool
+{
+public:
+    FrameBufferPool();
+    ~FrameBufferPool();
+
+    FrameBufferPool(const FrameBufferPool &) = delete;
+    FrameBufferPool &operator=(const FrameBufferPool &) = delete;
+
+    /*!
+     * \fn void reserve(int count, size_t bytes)
+     * \brief Preallocates buffers, smaller free buffers are replaced.
+     * \param int count - number of buffers.
+     * \param size_t bytes - size of every buffer in bytes.
+     */
+    void reserve(int count, size_t bytes);
+
+    /*!
+     * \fn QImage image(const QSize &size, QImage::Format format)
+     * \brief Returns an uninitialized image backed by a pooled buffer. Scanlines are 32 bit aligned.
+     * \param const QSize &size - image size.
+     * \param QImage::Format format - image format.
+     */
+    QImage image(const QSize &size, QImage::Format format);
+
+private:
+    struct State;
+    struct Buffer;
+
+    /*!
+     * \fn static void release(void *buffer)
+     * \brief QImage cleanup function returning the buffer to its pool.
+     */
+    static void release(void *buffer);
+
+    std::shared_ptr<State> m_state;
+};
+}
+
+#endif // FRAMEBUFFERPOOL_H
@@ -0,0 +1,130 @@
+#include "FrameGate.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+/*!
+ *  Number of grid samples along the longer side of the frame
+ */
+constexpr int k_gridSize = 64;
+}
+
+bool SCodes::FrameGate::isEnabled() const
+{
+    return m_sharpnessThreshold > 0.0 || m_motionThreshold > 0.0;
+}
+
+double SCodes::FrameGate::sharpnessThreshold() const
+{
+    return m_sharpnessThreshold;
+}
+
+void SCodes::FrameGate::setSharpnessThreshold(double threshold)
+{
+    m_sharpnessThreshold = std::max(0.0, threshold);
+}
+
+double SCodes::FrameGate::motionThreshold() const
+{
+    return m_motionThreshold;
+}
+
+void SCodes::FrameGate::setMotionThreshold(double threshold)
+{
+    m_motionThreshold = std::max(0.0, threshold);
+}
+
+bool SCodes::FrameGate::accept(const LuminanceImage &image)
+{
+    if (image.data == nullptr || image.width < 2 || image.height < 2) {
+        return true;
+    }
+
+    const int step    = std::max(1, std::max(image.width, image.height) / k_gridSize);
+    const int columns = (image.width - 1 + step - 1) / step;
+    const int rows    = (image.height - 1 + step - 1) / step;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_current.resize(size_t(columns) * rows);
+
+    // Gradients use the direct neighbours at full resolution, so fine blur is visible even on a sparse grid
+    uint64_t gradientEnergy = 0;
+
+    for (int row = 0; row < rows; ++row) {
+        const uint8_t *line = image.data + size_t(row) * step * image.rowStride;
+        const uint8_t *next = line + image.rowStride;
+
+        for (int column = 0; column < columns; ++column) {
+            const size_t x = size_t(column) * step * image.pixStride;
+            const int sample = line[x];
+            const int dx = line[x + image.pixStride] - sample;
+            const int dy = next[x] - sample;
+
+            gradientEnergy += uint64_t(dx * dx + dy * dy);
+            m_current[size_t(row) * columns + column] = uint8_t(sample);
+        }
+    }
+
+    uint64_t difference = 0;
+    const bool comparable = columns == m_previousColumns && rows == m_previousRows;
+
+    if (comparable) {
+        for (size_t i = 0; i < m_current.size(); ++i) {
+            difference += uint64_t(std::abs(int(m_current[i]) - int(m_previous[i])));
+        }
+    }
+
+    m_current.swap(m_previous);
+    m_previousColumns = columns;
+    m_previousRows    = rows;
+
+    const double samples = double(columns) * rows;
+    const double sharpness = gradientEnergy / samples;
+    const double motion = comparable ? difference / samples : 0.0;
+
+    m_sharpness = sharpness;
+    m_motion    = motion;
+
+    const double sharpnessThreshold = m_sharpnessThreshold;
+    const double motionThreshold    = m_motionThreshold;
+
+    if (motionThreshold > 0.0 && motion > motionThreshold) {
+        ++m_movingFrames;
+        return false;
+    }
+
+    if (sharpnessThreshold > 0.0 && sharpness < sharpnessThreshold) {
+        ++m_blurredFrames;
+        return false;
+    }
+
+    return true;
+}
+
+double SCodes::FrameGate::sharpness() const
+{
+    return m_sharpness;
+}
+
+double SCodes::FrameGate::motion() const
+{
+    return m_motion;
+}
+
+int SCodes::FrameGate::blurredFrames() const
+{
+    return m_blurredFrames;
+}
+
+int SCodes::FrameGate::movingFrames() const
+{
+    return m_movingFrames;
+}
+
+void SCodes::FrameGate::resetCounters()
+{
+    m_blurredFrames = 0;
+    m_movingFrames  = 0;
+}
@@ -0,0 +1,113 @@
+/*!
+ * This file contains the frame gate, which rejects blurred or moving frames before they are decoded.
+ * Both measurements look at a sparse grid of samples only, so they cost a tiny fraction of a decoding pass.
+ */
+#ifndef FRAMEGATE_H
+#define FRAMEGATE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "LuminancePyramid.h"
+
+namespace SCodes {
+/*!
+ * \brief The FrameGate class measures sharpness of a frame as mean gradient energy and motion as mean absolute
+ * difference to the previous frame, both on a subsampled grid. Frames below the sharpness threshold or above the
+ * motion threshold are rejected. All methods may be called from any thread, concurrent accept() calls are
+ * serialized and compare against whichever frame was measured last.
+ */
+class FrameGate
+{
+public:
+    /*!
+     * \fn bool isEnabled() const
+     * \brief Returns true if any threshold is set.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \fn double sharpnessThreshold() const
+     * \brief Returns the minimum sharpness of decoded frames.
+     */
+    double sharpnessThreshold() const;
+
+    /*!
+     * \fn void setSharpnessThreshold(double threshold)
+     * \brief Sets the minimum sharpness of decoded frames.
+     * \param double threshold - mean squared gradient of luminance samples, 0 disables the check.
+     */
+    void setSharpnessThreshold(double threshold);
+
+    /*!
+     * \fn double motionThreshold() const
+     * \brief Returns the maximum motion of decoded frames.
+     */
+    double motionThreshold() const;
+
+    /*!
+     * \fn void setMotionThreshold(double threshold)
+     * \brief Sets the maximum motion of decoded frames.
+     * \param double threshold - mean absolute luminance difference to the previous frame (0-255), 0 disables
+     * the check.
+     */
+    void setMotionThreshold(double threshold);
+
+    /*!
+     * \fn bool accept(const LuminanceImage &image)
+     * \brief Measures the frame and returns true if it should be decoded.
+     * \param const LuminanceImage &image - luminance samples of the frame.
+     */
+    bool accept(const LuminanceImage &image);
+
+    /*!
+     * \fn double sharpness() const
+     * \brief Returns sharpness of the last measured frame.
+     */
+    double sharpness() const;
+
+    /*!
+     * \fn double motion() const
+     * \brief Returns motion of the last measured frame.
+     */
+    double motion() const;
+
+    /*!
+     * \fn int blurredFrames() const
+     * \brief Returns number of frames rejected as blurred.
+     */
+    int blurredFrames() const;
+
+    /*!
+     * \fn int movingFrames() const
+     * \brief Returns number of frames rejected as moving.
+     */
+    int movingFrames() const;
+
+    /*!
+     * \fn void resetCounters()
+     * \brief Sets the rejected frame counters to zero.
+     */
+    void resetCounters();
+
+private:
+    std::atomic<double> m_sharpnessThreshold { 0.0 };
+    std::atomic<double> m_motionThreshold { 0.0 };
+    std::atomic<double> m_sharpness { 0.0 };
+    std::atomic<double> m_motion { 0.0 };
+    std::atomic<int> m_blurredFrames { 0 };
+    std::atomic<int> m_movingFrames { 0 };
+
+    /// Guards the grid samples, frames may be measured on several decoding threads
+    std::mutex m_mutex;
+    /// Grid samples of the previous frame
+    std::vector<uint8_t> m_previous;
+    std::vector<uint8_t> m_current;
+    int m_previousColumns = 0;
+    int m_previousRows    = 0;
+};
+}
+
+#endif // FRAMEGATE_H
@@ -0,0 +1,129 @@
+#include "FrameMailbox.h"
+
+SCodes::FrameMailbox::FrameMailbox()
+{
+    m_clock.start();
+}
+
+SCodes::FrameMailbox::~FrameMailbox()
+{
+    delete m_slot.exchange(nullptr);
+    delete m_spare.exchange(nullptr);
+}
+
+bool SCodes::FrameMailbox::post(const QVideoFrame &frame, const QRect &captureRect)
+{
+    Frame *entry = m_spare.exchange(nullptr);
+
+    if (entry == nullptr) {
+        entry = new Frame;
+    }
+
+    entry->frame       = frame;
+    entry->captureRect = captureRect;
+    entry->timestamp   = timestamp();
+    entry->sequence    = ++m_sequence;
+
+    Frame *replaced = m_slot.exchange(entry);
+
+    if (replaced == nullptr) {
+        return false;
+    }
+
+    ++m_replacedFrames;
+    recycle(replaced);
+    return true;
+}
+
+bool SCodes::FrameMailbox::take(Frame &frame)
+{
+    Frame *entry = m_slot.exchange(nullptr);
+
+    if (entry == nullptr) {
+        return false;
+    }
+
+    frame = *entry;
+    recycle(entry);
+    return true;
+}
+
+bool SCodes::FrameMailbox::tryScheduleConsumer(int maxConsumers)
+{
+    int consumers = m_consumers;
+
+    while (consumers < maxConsumers) {
+        if (m_consumers.compare_exchange_weak(consumers, consumers + 1)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SCodes::FrameMailbox::finishConsumer(int maxConsumers)
+{
+    // The mailbox may be destroyed as soon as the waiting owner sees no consumers, so it is not touched after unlock
+    QMutexLocker locker(&m_finishMutex);
+    --m_consumers;
+
+    // A frame posted after the last take() may have found all consumers scheduled, nobody else will pick it up
+    const bool rescheduled = m_slot.load() != nullptr && tryScheduleConsumer(maxConsumers);
+
+    if (m_consumers == 0) {
+        m_consumersFinished.wakeAll();
+    }
+
+    return rescheduled;
+}
+
+int SCodes::FrameMailbox::scheduledConsumers() const
+{
+    return m_consumers;
+}
+
+void SCodes::FrameMailbox::waitForConsumers()
+{
+    QMutexLocker locker(&m_finishMutex);
+
+    while (m_consumers > 0) {
+        m_consumersFinished.wait(&m_finishMutex);
+    }
+}
+
+quint64 SCodes::FrameMailbox::sequence() const
+{
+    return m_sequence;
+}
+
+qint64 SCodes::FrameMailbox::timestamp() const
+{
+    return m_clock.nsecsElapsed();
+}
+
+void SCodes::FrameMailbox::drop()
+{
+    ++m_droppedFrames;
+}
+
+int SCodes::FrameMailbox::replacedFrames() const
+{
+    return m_replacedFrames;
+}
+
+int SCodes::FrameMailbox::droppedFrames() const
+{
+    return m_droppedFrames;
+}
+
+void SCodes::FrameMailbox::recycle(Frame *entry)
+{
+    // Camera buffers are returned as soon as possible
+    entry->frame = QVideoFrame();
+
+    Frame *empty = nullptr;
+
+    if (!m_spare.compare_exchange_strong(empty, entry)) {
+        delete entry;
+    }
+}
@@ -0,0 +1,141 @@
+/*!
+ * This file contains the frame mailbox, a lock-free single slot passing the newest video frame from the video sink
+ * to the decoding thread.
+ */
+#ifndef FRAMEMAILBOX_H
+#define FRAMEMAILBOX_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QRect>
+#include <QVideoFrame>
+#include <QWaitCondition>
+
+#include <atomic>
+
+namespace SCodes {
+/*!
+ * \brief The FrameMailbox class keeps only the newest posted frame, a frame not taken before the next one arrives
+ * is replaced. The producer schedules a consumer only while fewer than the allowed number are scheduled, consumers
+ * take frames until the mailbox is empty. Slot entries are recycled, so passing frames does not allocate. post()
+ * may be called from one producer thread, take() concurrently from any number of consumer threads. Only finishing
+ * consumers take a lock, so the owner can wait for them.
+ */
+class FrameMailbox
+{
+public:
+    /*!
+     * \brief Frame with the data needed for decoding it
+     */
+    struct Frame {
+        QVideoFrame frame;
+        /// Capture area in frame pixels
+        QRect captureRect;
+        /// Time of arrival in nanoseconds, see timestamp()
+        qint64 timestamp = 0;
+        /// Number of the frame, counted from 1
+        quint64 sequence = 0;
+    };
+
+    FrameMailbox();
+    ~FrameMailbox();
+
+    FrameMailbox(const FrameMailbox &) = delete;
+    FrameMailbox &operator=(const FrameMailbox &) = delete;
+
+    /*!
+     * \fn bool post(const QVideoFrame &frame, const QRect &captureRect)
+     * \brief Puts the frame into the mailbox, replacing the frame not taken yet.
+     * \param const QVideoFrame &frame - frame of video data.
+     * \param const QRect &captureRect - capture area in frame pixels.
+     * \return true if a frame was replaced.
+     */
+    bool post(const QVideoFrame &frame, const QRect &captureRect);
+
+    /*!
+     * \fn bool take(Frame &frame)
+     * \brief Takes the newest frame out of the mailbox.
+     * \param Frame &frame - set to the taken frame.
+     * \return false if the mailbox is empty.
+     */
+    bool take(Frame &frame);
+
+    /*!
+     * \fn bool tryScheduleConsumer(int maxConsumers)
+     * \brief Counts another scheduled consumer, called by the producer after posting.
+     * \param int maxConsumers - maximum number of consumers scheduled at once.
+     * \return true if the limit was not reached and the caller has to schedule the consumer.
+     */
+    bool tryScheduleConsumer(int maxConsumers = 1);
+
+    /*!
+     * \fn bool finishConsumer(int maxConsumers)
+     * \brief Counts a consumer as finished, called by the consumer once it stops taking frames.
+     * \param int maxConsumers - maximum number of consumers scheduled at once.
+     * \return true if a frame arrived in the meantime and the consumer was scheduled again, it should continue.
+     */
+    bool finishConsumer(int maxConsumers = 1);
+
+    /*!
+     * \fn int scheduledConsumers() const
+     * \brief Returns number of consumers scheduled and not finished yet.
+     */
+    int scheduledConsumers() const;
+
+    /*!
+     * \fn void waitForConsumers()
+     * \brief Blocks until all scheduled consumers have finished, called by the owner before it is destroyed.
+     */
+    void waitForConsumers();
+
+    /*!
+     * \fn quint64 sequence() const
+     * \brief Returns number of the last posted frame, 0 if there was none.
+     */
+    quint64 sequence() const;
+
+    /*!
+     * \fn qint64 timestamp() const
+     * \brief Returns current time in nanoseconds on the clock used for frame timestamps.
+     */
+    qint64 timestamp() const;
+
+    /*!
+     * \fn void drop()
+     * \brief Counts a taken frame which was not decoded, because it was too old.
+     */
+    void drop();
+
+    /*!
+     * \fn int replacedFrames() const
+     * \brief Returns number of frames replaced by a newer one before they were taken.
+     */
+    int replacedFrames() const;
+
+    /*!
+     * \fn int droppedFrames() const
+     * \brief Returns number of taken frames which were not decoded.
+     */
+    int droppedFrames() const;
+
+private:
+    /*!
+     * \fn void recycle(Frame *entry)
+     * \brief Releases the video frame and keeps the entry for the next post, or deletes it.
+     */
+    void recycle(Frame *entry);
+
+    std::atomic<Frame *> m_slot { nullptr };
+    std::atomic<Frame *> m_spare { nullptr };
+    std::atomic<int> m_consumers { 0 };
+    /// Guards finishing consumers, so waitForConsumers() cannot miss the last one
+    QMutex m_finishMutex;
+    QWaitCondition m_consumersFinished;
+    std::atomic<quint64> m_sequence { 0 };
+    std::atomic<int> m_replacedFrames { 0 };
+    std::atomic<int> m_droppedFrames { 0 };
+    QElapsedTimer m_clock;
+};
+}
+
+#endif // FRAMEMAILBOX_H
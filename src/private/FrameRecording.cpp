@@ -0,0 +1,330 @@
+#include "FrameRecording.h"
+
+#include <cstring>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+#include <QAbstractVideoBuffer>
+#endif
+
+using namespace SCodes::FrameRecordingFormat;
+
+namespace {
+/*!
+ * \fn qint64 aligned(qint64 offset)
+ * \brief Returns the offset rounded up to the record alignment.
+ */
+qint64 aligned(qint64 offset)
+{
+    return (offset + k_recordAlignment - 1) / k_recordAlignment * k_recordAlignment;
+}
+
+/*!
+ * \fn qint64 planeOffset(const FrameHeader &header, int plane)
+ * \brief Returns offset of the plane from the start of its frame record.
+ */
+qint64 planeOffset(const FrameHeader &header, int plane)
+{
+    qint64 offset = aligned(sizeof(FrameHeader));
+
+    for (int i = 0; i < plane; ++i) {
+        offset = aligned(offset + header.planeSize[i]);
+    }
+
+    return offset;
+}
+
+/*!
+ * \fn bool isValid(const FrameHeader &header, qint64 available)
+ * \brief Returns true if the header describes a complete frame within the given number of bytes.
+ */
+bool isValid(const FrameHeader &header, qint64 available)
+{
+    if (header.recordSize < sizeof(FrameHeader) || header.recordSize > available
+        || header.recordSize % k_recordAlignment != 0 || header.planeCount == 0
+        || header.planeCount > quint32(k_maxPlanes) || header.width == 0 || header.height == 0) {
+        return false;
+    }
+
+    return planeOffset(header, int(header.planeCount)) <= header.recordSize;
+}
+}
+
+struct SCodes::FrameRecording::Mapping {
+    QFile file;
+    const uchar *data = nullptr;
+    qint64 size = 0;
+
+    ~Mapping()
+    {
+        if (data) {
+            file.unmap(const_cast<uchar *>(data));
+        }
+    }
+};
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+namespace {
+/*!
+ * \brief The MappedFrameBuffer class exposes a frame of the mapped recording without copying it, the mapping is
+ * kept alive as long as the frame exists.
+ */
+class MappedFrameBuffer : public QAbstractVideoBuffer
+{
+public:
+    MappedFrameBuffer(std::shared_ptr<SCodes::FrameRecording::Mapping> mapping, qint64 offset,
+                      const QVideoFrameFormat &format)
+        : m_mapping(std::move(mapping))
+        , m_offset(offset)
+        , m_format(format)
+    {}
+
+    MapData map(QVideoFrame::MapMode mode) override
+    {
+        MapData data;
+
+        // The recording is mapped read-only
+        if (mode != QVideoFrame::ReadOnly) {
+            return data;
+        }
+
+        FrameHeader header;
+        std::memcpy(&header, m_mapping->data + m_offset, sizeof(header));
+
+        data.planeCount = int(header.planeCount);
+
+        for (int i = 0; i < data.planeCount; ++i) {
+            data.bytesPerLine[i] = int(header.bytesPerLine[i]);
+            data.data[i] = const_cast<uchar *>(m_mapping->data + m_offset + planeOffset(header, i));
+            data.dataSize[i] = int(header.planeSize[i]);
+        }
+
+        return data;
+    }
+
+    QVideoFrameFormat format() const override
+    {
+        return m_format;
+    }
+
+private:
+    std::shared_ptr<SCodes::FrameRecording::Mapping> m_mapping;
+    qint64 m_offset;
+    QVideoFrameFormat m_format;
+};
+}
+#endif
+
+bool SCodes::FrameRecordingWriter::open(const QString &path)
+{
+    close();
+    m_file.setFileName(path);
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    RecordingHeader header {};
+    std::memcpy(header.magic, k_magic, sizeof(header.magic));
+    header.version = k_version;
+    header.headerSize = sizeof(RecordingHeader);
+
+    QByteArray bytes(int(aligned(sizeof(header))), '\0');
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    if (m_file.write(bytes) != bytes.size()) {
+        m_errorString = m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    return true;
+}
+
+void SCodes::FrameRecordingWriter::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+bool SCodes::FrameRecordingWriter::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+bool SCodes::FrameRecordingWriter::write(const QVideoFrame &frame, qint64 timestamp)
+{
+    if (!m_file.isOpen()) {
+        m_errorString = QStringLiteral("Recording is not open");
+        return false;
+    }
+
+    QVideoFrame mappedFrame(frame);
+
+    if (!mappedFrame.map(QVideoFrame::ReadOnly)) {
+        m_errorString = QStringLiteral("Frame can't be mapped for reading");
+        return false;
+    }
+
+    FrameHeader header {};
+    header.pixelFormat = quint32(mappedFrame.pixelFormat());
+    header.width = quint32(mappedFrame.width());
+    header.height = quint32(mappedFrame.height());
+    header.timestamp = timestamp;
+    header.planeCount = quint32(qMin(mappedFrame.planeCount(), k_maxPlanes));
+
+    for (int i = 0; i < int(header.planeCount); ++i) {
+        header.bytesPerLine[i] = quint32(mappedFrame.bytesPerLine(i));
+        header.planeSize[i] = quint32(mappedFrame.mappedBytes(i));
+    }
+
+    const qint64 recordSize = aligned(planeOffset(header, int(header.planeCount)));
+    header.recordSize = quint32(recordSize);
+
+    // The record is assembled first, so a failing write never leaves a header without its planes
+    QByteArray record(int(recordSize), '\0');
+    std::memcpy(record.data(), &header, sizeof(header));
+
+    for (int i = 0; i < int(header.planeCount); ++i) {
+        std::memcpy(record.data() + planeOffset(header, i), mappedFrame.bits(i), header.planeSize[i]);
+    }
+
+    mappedFrame.unmap();
+
+    if (m_file.write(record) != record.size()) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QString SCodes::FrameRecordingWriter::errorString() const
+{
+    return m_errorString;
+}
+
+bool SCodes::FrameRecording::open(const QString &path)
+{
+    close();
+
+    auto mapping = std::make_shared<Mapping>();
+    mapping->file.setFileName(path);
+
+    if (!mapping->file.open(QIODevice::ReadOnly)) {
+        m_errorString = mapping->file.errorString();
+        return false;
+    }
+
+    mapping->size = mapping->file.size();
+    mapping->data = mapping->size > 0 ? mapping->file.map(0, mapping->size) : nullptr;
+
+    if (!mapping->data) {
+        m_errorString = mapping->file.errorString();
+        return false;
+    }
+
+    RecordingHeader header;
+
+    if (mapping->size < qint64(sizeof(header))) {
+        m_errorString = QStringLiteral("File is not a frame recording");
+        return false;
+    }
+
+    std::memcpy(&header, mapping->data, sizeof(header));
+
+    if (std::memcmp(header.magic, k_magic, sizeof(header.magic)) != 0) {
+        m_errorString = QStringLiteral("File is not a frame recording");
+        return false;
+    }
+
+    if (header.version != k_version) {
+        m_errorString = QStringLiteral("Unsupported frame recording version %1").arg(header.version);
+        return false;
+    }
+
+    qint64 offset = aligned(header.headerSize);
+
+    while (mapping->size - offset >= qint64(sizeof(FrameHeader))) {
+        FrameHeader frameHeader;
+        std::memcpy(&frameHeader, mapping->data + offset, sizeof(frameHeader));
+
+        if (!isValid(frameHeader, mapping->size - offset)) {
+            break;
+        }
+
+        m_offsets.push_back(offset);
+        offset += frameHeader.recordSize;
+    }
+
+    m_mapping = std::move(mapping);
+    return true;
+}
+
+void SCodes::FrameRecording::close()
+{
+    m_mapping.reset();
+    m_offsets.clear();
+}
+
+int SCodes::FrameRecording::frameCount() const
+{
+    return int(m_offsets.size());
+}
+
+qint64 SCodes::FrameRecording::timestamp(int index) const
+{
+    FrameHeader header;
+    std::memcpy(&header, m_mapping->data + m_offsets.at(size_t(index)), sizeof(header));
+    return header.timestamp;
+}
+
+QVideoFrame SCodes::FrameRecording::frame(int index) const
+{
+    const qint64 offset = m_offsets.at(size_t(index));
+    FrameHeader header;
+    std::memcpy(&header, m_mapping->data + offset, sizeof(header));
+
+    if (header.pixelFormat == QVideoFrameFormat::Format_Invalid
+        || header.pixelFormat > quint32(QVideoFrameFormat::NPixelFormats - 1)) {
+        return {};
+    }
+
+    const QVideoFrameFormat format(QSize(int(header.width), int(header.height)),
+                                   QVideoFrameFormat::PixelFormat(header.pixelFormat));
+
+    #if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+    QVideoFrame frame(std::make_unique<MappedFrameBuffer>(m_mapping, offset, format));
+    #else
+    // Custom video buffers are private API before Qt 6.8, the planes are copied row by row as strides may differ
+    QVideoFrame frame(format);
+
+    if (!frame.map(QVideoFrame::WriteOnly)) {
+        return {};
+    }
+
+    for (int i = 0; i < qMin(frame.planeCount(), int(header.planeCount)); ++i) {
+        const int sourceStride = int(header.bytesPerLine[i]);
+        const int targetStride = frame.bytesPerLine(i);
+        const int rows = qMin(sourceStride > 0 ? int(header.planeSize[i]) / sourceStride : 0,
+                              targetStride > 0 ? frame.mappedBytes(i) / targetStride : 0);
+        const uchar *source = m_mapping->data + offset + planeOffset(header, i);
+
+        for (int y = 0; y < rows; ++y) {
+            std::memcpy(frame.bits(i) + y * targetStride, source + y * sourceStride,
+                        size_t(qMin(sourceStride, targetStride)));
+        }
+    }
+
+    frame.unmap();
+    #endif
+
+    frame.setStartTime(header.timestamp);
+    return frame;
+}
+
+QString SCodes::FrameRecording::errorString() const
+{
+    return m_errorString;
+}
@@ -0,0 +1,160 @@
+/*!
+ * This file contains reading and writing of frame recordings, raw video frames stored with their timestamps so the
+ * scanning pipeline can be replayed without a camera.
+ */
+#ifndef FRAMERECORDING_H
+#define FRAMERECORDING_H
+
+#include <QFile>
+#include <QVideoFrame>
+#include <QVideoFrameFormat>
+
+#include <memory>
+#include <vector>
+
+namespace SCodes {
+/*!
+ * \brief Layout of a frame recording. All values are stored in native byte order and every record starts at
+ * a multiple of k_recordAlignment, so planes of a memory-mapped recording are aligned like those of a camera.
+ *
+ *   RecordingHeader
+ *   FrameHeader, plane 0, plane 1, ...  (padded to k_recordAlignment)
+ *   FrameHeader, ...
+ *
+ * A recording cut off while being written is read up to the last complete frame.
+ */
+namespace FrameRecordingFormat {
+constexpr char k_magic[4] = { 'S', 'C', 'F', 'R' };
+/// Increased whenever the layout changes, pixel formats are stored as QVideoFrameFormat::PixelFormat values
+constexpr quint32 k_version = 1;
+constexpr qint64 k_recordAlignment = 64;
+constexpr int k_maxPlanes = 4;
+
+struct RecordingHeader {
+    char magic[4];
+    quint32 version;
+    quint32 headerSize;
+    quint32 reserved;
+};
+
+struct FrameHeader {
+    /// Size of the whole record including the header and padding
+    quint32 recordSize;
+    quint32 pixelFormat;
+    quint32 width;
+    quint32 height;
+    /// Presentation time of the frame in microseconds
+    qint64 timestamp;
+    quint32 planeCount;
+    quint32 reserved;
+    quint32 bytesPerLine[k_maxPlanes];
+    /// Size of every plane, the next plane starts at the following multiple of k_recordAlignment
+    quint32 planeSize[k_maxPlanes];
+};
+
+static_assert(sizeof(RecordingHeader) == 16, "Recording header layout must not depend on the compiler");
+static_assert(sizeof(FrameHeader) == 64, "Frame header layout must not depend on the compiler");
+}
+
+/*!
+ * \brief The FrameRecordingWriter class appends video frames to a recording file.
+ */
+class FrameRecordingWriter
+{
+public:
+    /*!
+     * \fn bool open(const QString &path)
+     * \brief Creates the recording file, an existing one is overwritten.
+     * \param const QString &path - path of the recording.
+     * \return false if the file can't be written, see errorString().
+     */
+    bool open(const QString &path);
+
+    /*!
+     * \fn void close()
+     * \brief Closes the recording file.
+     */
+    void close();
+
+    /*!
+     * \fn bool isOpen() const
+     * \brief Returns true if frames are written.
+     */
+    bool isOpen() const;
+
+    /*!
+     * \fn bool write(const QVideoFrame &frame, qint64 timestamp)
+     * \brief Appends the frame. Frames in GPU memory are downloaded by mapping them.
+     * \param const QVideoFrame &frame - frame to be stored.
+     * \param qint64 timestamp - presentation time in microseconds.
+     * \return false if the frame can't be mapped or written, see errorString().
+     */
+    bool write(const QVideoFrame &frame, qint64 timestamp);
+
+    /*!
+     * \fn QString errorString() const
+     * \brief Returns description of the last error.
+     */
+    QString errorString() const;
+
+private:
+    QFile m_file;
+    QString m_errorString;
+};
+
+/*!
+ * \brief The FrameRecording class provides frames of a memory-mapped recording file. Frames share the mapping,
+ * with Qt 6.8 and later they are not copied at all, so they stay valid after the recording is closed.
+ */
+class FrameRecording
+{
+public:
+    /*!
+     * \fn bool open(const QString &path)
+     * \brief Maps the recording file and indexes its frames.
+     * \param const QString &path - path of the recording.
+     * \return false if the file can't be mapped or is no recording, see errorString().
+     */
+    bool open(const QString &path);
+
+    /*!
+     * \fn void close()
+     * \brief Releases the recording, the file stays mapped until the last frame is destroyed.
+     */
+    void close();
+
+    /*!
+     * \fn int frameCount() const
+     * \brief Returns number of complete frames in the recording.
+     */
+    int frameCount() const;
+
+    /*!
+     * \fn qint64 timestamp(int index) const
+     * \brief Returns presentation time of the frame in microseconds.
+     */
+    qint64 timestamp(int index) const;
+
+    /*!
+     * \fn QVideoFrame frame(int index) const
+     * \brief Returns the frame, an invalid frame if the pixel format is unknown to this Qt version.
+     */
+    QVideoFrame frame(int index) const;
+
+    /*!
+     * \fn QString errorString() const
+     * \brief Returns description of the last error.
+     */
+    QString errorString() const;
+
+    struct Mapping;
+
+private:
+    std::shared_ptr<Mapping> m_mapping;
+    /// Offsets of the frame headers in the mapping
+    std::vector<qint64> m_offsets;
+    QString m_errorString;
+};
+}
+
+#endif // FRAMERECORDING_H
@@ -0,0 +1,421 @@
+#include "GlLumaReader.h"
+
+#include <QOpenGLBuffer>
+#include <QOpenGLShaderProgram>
+#include <QSurfaceFormat>
+
+#include <cstring>
+
+#include "debug.h"
+
+namespace {
+/*!
+ *  Luminance samples packed into one RGBA texel of the render target
+ */
+constexpr int k_samplesPerTexel = 4;
+
+/*!
+ *  Full-viewport quad drawn as triangle strip
+ */
+constexpr GLfloat k_quad[] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+
+const char *const k_vertexShader =
+    "attribute vec2 vertex;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = vec4(vertex, 0.0, 1.0);\n"
+    "}\n";
+
+// Every target texel holds four horizontally adjacent pixels of the area, weighted like ZXing does on the CPU
+// Texel centers are sampled, so the result does not depend on the filtering of the frame texture
+const char *const k_fragmentShader =
+    "#ifdef GL_ES\n"
+    "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+    "precision highp float;\n"
+    "#else\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "#endif\n"
+    "uniform sampler2D source;\n"
+    "uniform vec2 origin;\n"
+    "uniform vec2 texelSize;\n"
+    "float luma(float x, float y)\n"
+    "{\n"
+    "    return dot(texture2D(source, vec2(x, y) * texelSize).rgb, vec3(0.299, 0.587, 0.114));\n"
+    "}\n"
+    "void main()\n"
+    "{\n"
+    "    float x = origin.x + floor(gl_FragCoord.x) * 4.0 + 0.5;\n"
+    "    float y = origin.y + floor(gl_FragCoord.y) + 0.5;\n"
+    "    gl_FragColor = vec4(luma(x, y), luma(x + 1.0, y), luma(x + 2.0, y), luma(x + 3.0, y));\n"
+    "}\n";
+
+/*!
+ * \fn QSize packedSize(const QRect &rect)
+ * \brief Returns size of the render target holding the area.
+ */
+QSize packedSize(const QRect &rect)
+{
+    return QSize((rect.width() + k_samplesPerTexel - 1) / k_samplesPerTexel, rect.height());
+}
+
+/*!
+ * \fn bool supportsAsyncReadback(const QOpenGLContext *context)
+ * \brief Returns true if the context has pixel buffer objects, glMapBufferRange and fences.
+ */
+bool supportsAsyncReadback(const QOpenGLContext *context)
+{
+    const QSurfaceFormat format = context->format();
+    const auto version = qMakePair(format.majorVersion(), format.minorVersion());
+
+    return context->isOpenGLES() ? version >= qMakePair(3, 0) : version >= qMakePair(3, 2);
+}
+
+/*!
+ * \brief The StateGuard class saves the OpenGL state touched by the luminance pass and restores it when destroyed,
+ * so the scene graph rendering the video finds the context as it left it.
+ */
+class StateGuard
+{
+public:
+    explicit StateGuard(QOpenGLFunctions *f)
+        : m_f(f)
+    {
+        m_f->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &m_framebuffer);
+        m_f->glGetIntegerv(GL_VIEWPORT, m_viewport);
+        m_f->glGetIntegerv(GL_CURRENT_PROGRAM, &m_program);
+        m_f->glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &m_arrayBuffer);
+        m_f->glGetIntegerv(GL_ACTIVE_TEXTURE, &m_activeTexture);
+        m_f->glActiveTexture(GL_TEXTURE0);
+        m_f->glGetIntegerv(GL_TEXTURE_BINDING_2D, &m_texture);
+        m_f->glGetIntegerv(GL_PACK_ALIGNMENT, &m_packAlignment);
+
+        // Vertex attribute 0 feeds the quad of the luminance pass
+        m_f->glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &m_attribEnabled);
+        m_f->glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &m_attribBuffer);
+        m_f->glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_SIZE, &m_attribSize);
+        m_f->glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_TYPE, &m_attribType);
+        m_f->glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED, &m_attribNormalized);
+        m_f->glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_STRIDE, &m_attribStride);
+        m_f->glGetVertexAttribPointerv(0, GL_VERTEX_ATTRIB_ARRAY_POINTER, &m_attribPointer);
+
+        for (size_t i = 0; i < m_capabilities.size(); ++i) {
+            m_enabled[i] = m_f->glIsEnabled(m_capabilities[i]);
+            m_f->glDisable(m_capabilities[i]);
+        }
+    }
+
+    ~StateGuard()
+    {
+        for (size_t i = 0; i < m_capabilities.size(); ++i) {
+            if (m_enabled[i]) {
+                m_f->glEnable(m_capabilities[i]);
+            }
+        }
+
+        m_f->glBindBuffer(GL_ARRAY_BUFFER, GLuint(m_attribBuffer));
+        m_f->glVertexAttribPointer(0, m_attribSize, GLenum(m_attribType), GLboolean(m_attribNormalized),
+                                   m_attribStride, m_attribPointer);
+
+        if (m_attribEnabled) {
+            m_f->glEnableVertexAttribArray(0);
+        } else {
+            m_f->glDisableVertexAttribArray(0);
+        }
+
+        m_f->glPixelStorei(GL_PACK_ALIGNMENT, m_packAlignment);
+        m_f->glBindTexture(GL_TEXTURE_2D, GLuint(m_texture));
+        m_f->glActiveTexture(GLenum(m_activeTexture));
+        m_f->glBindBuffer(GL_ARRAY_BUFFER, GLuint(m_arrayBuffer));
+        m_f->glUseProgram(GLuint(m_program));
+        m_f->glViewport(m_viewport[0], m_viewport[1], m_viewport[2], m_viewport[3]);
+        m_f->glBindFramebuffer(GL_FRAMEBUFFER, GLuint(m_framebuffer));
+    }
+
+private:
+    QOpenGLFunctions *m_f;
+    const std::array<GLenum, 5> m_capabilities { { GL_BLEND, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_SCISSOR_TEST,
+                                                   GL_CULL_FACE } };
+    std::array<GLboolean, 5> m_enabled {};
+    GLint m_framebuffer = 0;
+    GLint m_viewport[4] = {};
+    GLint m_program = 0;
+    GLint m_arrayBuffer = 0;
+    GLint m_activeTexture = GL_TEXTURE0;
+    GLint m_texture = 0;
+    GLint m_packAlignment = 4;
+    GLint m_attribEnabled = GL_FALSE;
+    GLint m_attribBuffer = 0;
+    GLint m_attribSize = 4;
+    GLint m_attribType = GL_FLOAT;
+    GLint m_attribNormalized = GL_FALSE;
+    GLint m_attribStride = 0;
+    void *m_attribPointer = nullptr;
+};
+}
+
+SCodes::GlLumaReader::GlLumaReader() = default;
+
+SCodes::GlLumaReader::~GlLumaReader()
+{
+    release();
+}
+
+bool SCodes::GlLumaReader::initialize()
+{
+    if (m_initialized) {
+        return m_usable && QOpenGLContext::currentContext() == m_context;
+    }
+
+    m_initialized = true;
+    m_context = QOpenGLContext::currentContext();
+
+    if (!m_context) {
+        return false;
+    }
+
+    m_program = std::make_unique<QOpenGLShaderProgram>();
+    m_program->bindAttributeLocation("vertex", 0);
+
+    if (!m_program->addShaderFromSourceCode(QOpenGLShader::Vertex, k_vertexShader)
+        || !m_program->addShaderFromSourceCode(QOpenGLShader::Fragment, k_fragmentShader)
+        || !m_program->link()) {
+        sDebug() << "Luminance shader failed, OpenGL frames are read on the CPU:" << m_program->log();
+        m_program.reset();
+        return false;
+    }
+
+    m_vertices = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::VertexBuffer);
+    m_vertices->create();
+    m_vertices->bind();
+    m_vertices->allocate(k_quad, int(sizeof(k_quad)));
+    m_vertices->release();
+
+    QOpenGLFunctions *f = m_context->functions();
+    f->glGenFramebuffers(1, &m_framebuffer);
+    f->glGenTextures(1, &m_target);
+
+    m_async = supportsAsyncReadback(m_context);
+
+    if (m_async) {
+        for (auto &readback : m_readbacks) {
+            f->glGenBuffers(1, &readback.buffer);
+        }
+    }
+
+    sDebug() << "OpenGL frames are converted on the GPU, readback" << (m_async ? "asynchronous" : "synchronous");
+
+    m_usable = true;
+    return true;
+}
+
+bool SCodes::GlLumaReader::isAsync() const
+{
+    return m_async;
+}
+
+bool SCodes::GlLumaReader::start(GLuint texture, const QSize &textureSize, const QRect &rect)
+{
+    if (!m_async || !initialize()) {
+        return false;
+    }
+
+    QOpenGLExtraFunctions *f = m_context->extraFunctions();
+    StateGuard state(f);
+
+    if (!render(texture, textureSize, rect)) {
+        return false;
+    }
+
+    // The readback slot not taken yet is overwritten, its frame would be older than the one started now
+    m_current = (m_current + 1) % int(m_readbacks.size());
+    Readback &readback = m_readbacks[size_t(m_current)];
+
+    if (readback.fence) {
+        f->glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+    }
+
+    const QSize packed = packedSize(rect);
+    const int bytes = packed.width() * k_samplesPerTexel * packed.height();
+
+    GLint previousBuffer = 0;
+    f->glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previousBuffer);
+    f->glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    f->glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+    f->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    // With a pack buffer bound glReadPixels only queues the copy
+    f->glReadPixels(0, 0, packed.width(), packed.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    f->glBindBuffer(GL_PIXEL_PACK_BUFFER, GLuint(previousBuffer));
+
+    readback.fence = f->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.rect = rect;
+    readback.textureSize = textureSize;
+    readback.pending = true;
+
+    // Submits the commands, the fence would never signal otherwise
+    f->glFlush();
+
+    return true;
+}
+
+bool SCodes::GlLumaReader::take(QImage &luminance, QRect &rect, QSize &textureSize)
+{
+    if (!m_async || !initialize()) {
+        return false;
+    }
+
+    Readback &readback = m_readbacks[size_t((m_current + 1) % int(m_readbacks.size()))];
+
+    if (!readback.pending) {
+        return false;
+    }
+
+    QOpenGLExtraFunctions *f = m_context->extraFunctions();
+
+    // Mapping a buffer still being written would block, the frame is skipped instead
+    if (readback.fence) {
+        const GLenum status = f->glClientWaitSync(readback.fence, 0, 0);
+
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            return false;
+        }
+
+        f->glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+    }
+
+    const QSize packed = packedSize(readback.rect);
+    const int bytes = packed.width() * k_samplesPerTexel * packed.height();
+
+    GLint previousBuffer = 0;
+    f->glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previousBuffer);
+    f->glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+
+    bool taken = false;
+
+    if (const auto packedPixels = static_cast<const uchar *>(
+          f->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT))) {
+        unpack(packedPixels, readback.rect, luminance);
+        f->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        rect = readback.rect;
+        textureSize = readback.textureSize;
+        taken = true;
+    }
+
+    f->glBindBuffer(GL_PIXEL_PACK_BUFFER, GLuint(previousBuffer));
+    readback.pending = false;
+
+    return taken;
+}
+
+bool SCodes::GlLumaReader::read(GLuint texture, const QSize &textureSize, const QRect &rect, QImage &luminance)
+{
+    if (!initialize()) {
+        return false;
+    }
+
+    QOpenGLFunctions *f = m_context->functions();
+    StateGuard state(f);
+
+    if (!render(texture, textureSize, rect)) {
+        return false;
+    }
+
+    const QSize packed = packedSize(rect);
+    QImage packedPixels = m_bufferPool.image(QSize(packed.width() * k_samplesPerTexel, packed.height()),
+                                             QImage::Format_Grayscale8);
+
+    f->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    f->glReadPixels(0, 0, packed.width(), packed.height(), GL_RGBA, GL_UNSIGNED_BYTE, packedPixels.bits());
+
+    // Rows of the pooled image are 32 bit aligned just like the packed rows, only the width has to be cut
+    luminance = m_bufferPool.image(rect.size(), QImage::Format_Grayscale8);
+
+    for (int y = 0; y < rect.height(); ++y) {
+        std::memcpy(luminance.scanLine(y), packedPixels.constScanLine(y), size_t(rect.width()));
+    }
+
+    return true;
+}
+
+bool SCodes::GlLumaReader::render(GLuint texture, const QSize &textureSize, const QRect &rect)
+{
+    if (rect.isEmpty() || textureSize.isEmpty()) {
+        return false;
+    }
+
+    QOpenGLFunctions *f = m_context->functions();
+    const QSize packed = packedSize(rect);
+
+    f->glBindTexture(GL_TEXTURE_2D, m_target);
+
+    if (m_targetSize != packed) {
+        f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, packed.width(), packed.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                        nullptr);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        f->glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+        f->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_target, 0);
+
+        if (f->glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            m_targetSize = QSize();
+            return false;
+        }
+
+        m_targetSize = packed;
+    }
+
+    f->glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    f->glViewport(0, 0, packed.width(), packed.height());
+
+    f->glBindTexture(GL_TEXTURE_2D, texture);
+
+    m_program->bind();
+    m_program->setUniformValue("source", 0);
+    m_program->setUniformValue("origin", QPointF(rect.topLeft()));
+    m_program->setUniformValue("texelSize", QPointF(1.0 / textureSize.width(), 1.0 / textureSize.height()));
+
+    m_vertices->bind();
+    m_program->enableAttributeArray(0);
+    m_program->setAttributeBuffer(0, GL_FLOAT, 0, 2);
+    f->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    m_program->disableAttributeArray(0);
+    m_vertices->release();
+
+    return true;
+}
+
+void SCodes::GlLumaReader::unpack(const uchar *packed, const QRect &rect, QImage &luminance)
+{
+    const int packedStride = packedSize(rect).width() * k_samplesPerTexel;
+    luminance = m_bufferPool.image(rect.size(), QImage::Format_Grayscale8);
+
+    for (int y = 0; y < rect.height(); ++y) {
+        std::memcpy(luminance.scanLine(y), packed + size_t(y) * packedStride, size_t(rect.width()));
+    }
+}
+
+void SCodes::GlLumaReader::release()
+{
+    // Objects of a context which is not current any more are freed with the context itself
+    if (!m_context || QOpenGLContext::currentContext() != m_context) {
+        return;
+    }
+
+    QOpenGLExtraFunctions *f = m_context->extraFunctions();
+
+    for (auto &readback : m_readbacks) {
+        if (readback.fence) {
+            f->glDeleteSync(readback.fence);
+        }
+
+        if (readback.buffer) {
+            f->glDeleteBuffers(1, &readback.buffer);
+        }
+    }
+
+    f->glDeleteTextures(1, &m_target);
+    f->glDeleteFramebuffers(1, &m_framebuffer);
+}
@@ -0,0 +1,135 @@
+/*!
+ * This file contains the OpenGL luminance reader, which converts the capture area of a video frame texture to
+ * luminance on the GPU and reads it back without stalling the render thread (Qt5).
+ */
+#ifndef GLLUMAREADER_H
+#define GLLUMAREADER_H
+
+#include <QImage>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QRect>
+
+#include <array>
+#include <memory>
+
+#include "FrameBufferPool.h"
+
+class QOpenGLBuffer;
+class QOpenGLShaderProgram;
+
+namespace SCodes {
+/*!
+ * \brief The GlLumaReader class reads luminance of the capture area of video frame textures. A shader pass renders
+ * the area into a persistent framebuffer with four luminance samples packed into every RGBA texel, so only one byte
+ * per pixel is read back. With OpenGL 3.2 or OpenGL ES 3.0 the readback goes into two pixel buffer objects in turn
+ * and is taken one frame later, once its fence signals, otherwise it is read synchronously. Must be used on the
+ * thread of a single OpenGL context, the render thread.
+ */
+class GlLumaReader
+{
+public:
+    GlLumaReader();
+    ~GlLumaReader();
+
+    GlLumaReader(const GlLumaReader &) = delete;
+    GlLumaReader &operator=(const GlLumaReader &) = delete;
+
+    /*!
+     * \fn bool initialize()
+     * \brief Creates the shader and buffers in the current context, on first use only.
+     * \return false if there is no current context or the shader can't be built, the reader is unusable then.
+     */
+    bool initialize();
+
+    /*!
+     * \fn bool isAsync() const
+     * \brief Returns true if readbacks go through pixel buffer objects, start() and take() are used then.
+     */
+    bool isAsync() const;
+
+    /*!
+     * \fn bool start(GLuint texture, const QSize &textureSize, const QRect &rect)
+     * \brief Converts the area of the texture to luminance and starts reading it back, to be taken by take() when
+     * done. Cheap enough to be called for every frame. Asynchronous mode only.
+     * \param GLuint texture - texture of the video frame.
+     * \param const QSize &textureSize - texture size.
+     * \param const QRect &rect - area to be read, in texture pixels.
+     */
+    bool start(GLuint texture, const QSize &textureSize, const QRect &rect);
+
+    /*!
+     * \fn bool take(QImage &luminance, QRect &rect, QSize &textureSize)
+     * \brief Returns the luminance of the area passed to start() before the latest one, if its readback completed.
+     * Every readback is taken once. Asynchronous mode only.
+     * \param QImage &luminance - set to Grayscale8 image backed by a pooled buffer.
+     * \param QRect &rect - set to area of the frame the image covers.
+     * \param QSize &textureSize - set to size of the frame the image was read from.
+     * \return false if no readback is complete, the frame is skipped then.
+     */
+    bool take(QImage &luminance, QRect &rect, QSize &textureSize);
+
+    /*!
+     * \fn bool read(GLuint texture, const QSize &textureSize, const QRect &rect, QImage &luminance)
+     * \brief Converts the area of the texture to luminance and reads it right away.
+     * \param GLuint texture - texture of the video frame.
+     * \param const QSize &textureSize - texture size.
+     * \param const QRect &rect - area to be read, in texture pixels.
+     * \param QImage &luminance - set to Grayscale8 image backed by a pooled buffer.
+     */
+    bool read(GLuint texture, const QSize &textureSize, const QRect &rect, QImage &luminance);
+
+private:
+    /*!
+     * \brief Pixel buffer object with the readback of one frame
+     */
+    struct Readback {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        QRect rect;
+        QSize textureSize;
+        bool pending = false;
+    };
+
+    /*!
+     * \fn bool render(GLuint texture, const QSize &textureSize, const QRect &rect)
+     * \brief Renders packed luminance of the area into the framebuffer and leaves the framebuffer bound for reading.
+     * The caller restores the previous framebuffer.
+     */
+    bool render(GLuint texture, const QSize &textureSize, const QRect &rect);
+
+    /*!
+     * \fn void unpack(const uchar *packed, const QRect &rect, QImage &luminance)
+     * \brief Copies the packed rows read back for the area into a pooled Grayscale8 image.
+     */
+    void unpack(const uchar *packed, const QRect &rect, QImage &luminance);
+
+    /*!
+     * \fn void release()
+     * \brief Deletes the OpenGL objects, if their context is current.
+     */
+    void release();
+
+    QOpenGLContext *m_context = nullptr;
+    bool m_initialized = false;
+    bool m_usable = false;
+    bool m_async = false;
+
+    std::unique_ptr<QOpenGLShaderProgram> m_program;
+    std::unique_ptr<QOpenGLBuffer> m_vertices;
+
+    /// Persistent render target, reallocated when the packed area size changes
+    GLuint m_framebuffer = 0;
+    GLuint m_target = 0;
+    QSize m_targetSize;
+
+    std::array<Readback, 2> m_readbacks;
+    /// Index of the readback started last
+    int m_current = 0;
+
+    /// Buffers of the returned images
+    FrameBufferPool m_bufferPool;
+};
+}
+
+#endif // GLLUMAREADER_H
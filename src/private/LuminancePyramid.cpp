@@ -0,0 +1,251 @@
+#include "LuminancePyramid.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCODES_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(SCODES_SSE2) && (defined(__GNUC__) || defined(__clang__) || defined(__AVX2__))
+#define SCODES_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SCODES_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+using RowFunction = int (*)(const uint8_t *row0, const uint8_t *row1, uint8_t *output, int outputWidth);
+
+/*!
+ * \fn int downscaleRowsScalar(const uint8_t *row0, const uint8_t *row1, uint8_t *output, int outputWidth, int pixStride)
+ * \brief Averages 2x2 blocks of two neighbouring rows, works for any distance between samples.
+ * \return number of output samples written.
+ */
+int downscaleRowsScalar(const uint8_t *row0, const uint8_t *row1, uint8_t *output, int outputWidth, int pixStride)
+{
+    for (int x = 0; x < outputWidth; ++x) {
+        const int i = 2 * x * pixStride;
+        output[x] = uint8_t((row0[i] + row0[i + pixStride] + row1[i] + row1[i + pixStride] + 2) >> 2);
+    }
+
+    return outputWidth;
+}
+
+#ifdef SCODES_SSE2
+/*!
+ * \fn int downscaleRowsSSE2(const uint8_t *row0, const uint8_t *row1, uint8_t *output, int outputWidth)
+ * \brief SSE2 version of downscaleRowsScalar for contiguous samples, 16 output samples per iteration.
+ * \return number of output samples written, the remainder is left to the scalar version.
+ */
+int downscaleRowsSSE2(const uint8_t *row0, const uint8_t *row1, uint8_t *output, int outputWidth)
+{
+    const __m128i lowBytes = _mm_set1_epi16(0x00ff);
+    const __m128i rounding = _mm_set1_epi16(2);
+
+    auto pairSums = [&](__m128i v) {
+        return _mm_add_epi16(_mm_and_si128(v, lowBytes), _mm_srli_epi16(v, 8));
+    };
+
+    int x = 0;
+
+    for (; x + 16 <= outputWidth; x += 16) {
+        const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + 2 * x));
+        const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + 2 * x + 16));
+        const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + 2 * x));
+        const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + 2 * x + 16));
+
+        const __m128i sum0 = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(pairSums(a0), pairSums(b0)), rounding), 2);
+        const __m128i sum1 = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(pairSums(a1), pairSums(b1)), rounding), 2);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + x), _mm_packus_epi16(sum0, sum1));
+    }
+
+    return x;
+}
+#endif
+
+#ifdef SCODES_AVX2
+/*!
+ * \fn int downscaleRowsAVX2(const uint8_t *row0, const uint8_t *row1, uint8_t *output, int outputWidth)
+ * \brief AVX2 version of downscaleRowsScalar for contiguous samples, 32 output samples per iteration.
+ * \return number of output samples written, the remainder is left to the scalar version.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+int downscaleRowsAVX2(const uint8_t *row0, const uint8_t *row1, uint8_t *output, int outputWidth)
+{
+    const __m256i lowBytes = _mm256_set1_epi16(0x00ff);
+    const __m256i rounding = _mm256_set1_epi16(2);
+
+    int x = 0;
+
+    for (; x + 32 <= outputWidth; x += 32) {
+        const __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row0 + 2 * x));
+        const __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row0 + 2 * x + 32));
+        const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row1 + 2 * x));
+        const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row1 + 2 * x + 32));
+
+        const __m256i pairs0 = _mm256_add_epi16(
+            _mm256_add_epi16(_mm256_and_si256(a0, lowBytes), _mm256_srli_epi16(a0, 8)),
+            _mm256_add_epi16(_mm256_and_si256(b0, lowBytes), _mm256_srli_epi16(b0, 8)));
+        const __m256i pairs1 = _mm256_add_epi16(
+            _mm256_add_epi16(_mm256_and_si256(a1, lowBytes), _mm256_srli_epi16(a1, 8)),
+            _mm256_add_epi16(_mm256_and_si256(b1, lowBytes), _mm256_srli_epi16(b1, 8)));
+
+        const __m256i sum0 = _mm256_srli_epi16(_mm256_add_epi16(pairs0, rounding), 2);
+        const __m256i sum1 = _mm256_srli_epi16(_mm256_add_epi16(pairs1, rounding), 2);
+
+        // Packing works within 128 bit lanes, restore the order of 64 bit blocks afterwards
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum0, sum1), 0xd8);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + x), packed);
+    }
+
+    return x;
+}
+#endif
+
+#ifdef SCODES_NEON
+/*!
+ * \fn int downscaleRowsNEON(const uint8_t *row0, const uint8_t *row1, uint8_t *output, int outputWidth)
+ * \brief NEON version of downscaleRowsScalar for contiguous samples, 8 output samples per iteration.
+ * \return number of output samples written, the remainder is left to the scalar version.
+ */
+int downscaleRowsNEON(const uint8_t *row0, const uint8_t *row1, uint8_t *output, int outputWidth)
+{
+    int x = 0;
+
+    for (; x + 8 <= outputWidth; x += 8) {
+        const uint16x8_t sums = vpadalq_u8(vpaddlq_u8(vld1q_u8(row0 + 2 * x)), vld1q_u8(row1 + 2 * x));
+        // Rounding shift, (sum + 2) >> 2
+        vst1_u8(output + x, vrshrn_n_u16(sums, 2));
+    }
+
+    return x;
+}
+#endif
+
+/*!
+ * \fn RowFunction vectorizedRowFunction()
+ * \brief Returns the fastest row function supported by the CPU, nullptr if there is none.
+ */
+RowFunction vectorizedRowFunction()
+{
+    #if defined(SCODES_AVX2) && defined(__AVX2__)
+    return downscaleRowsAVX2;
+
+    #elif defined(SCODES_AVX2)
+    static const RowFunction function = __builtin_cpu_supports("avx2") ? downscaleRowsAVX2 : downscaleRowsSSE2;
+    return function;
+
+    #elif defined(SCODES_SSE2)
+    return downscaleRowsSSE2;
+
+    #elif defined(SCODES_NEON)
+    return downscaleRowsNEON;
+
+    #else
+    return nullptr;
+
+    #endif
+}
+
+/*!
+ * \fn RowFunction rowFunction(SCodes::DownscaleKernel kernel)
+ * \brief Returns the row function of the kernel, nullptr for the scalar kernel and unsupported ones.
+ */
+RowFunction rowFunction(SCodes::DownscaleKernel kernel)
+{
+    switch (kernel) {
+        case SCodes::DownscaleKernel::Automatic:
+            return vectorizedRowFunction();
+
+        case SCodes::DownscaleKernel::SSE2:
+            #ifdef SCODES_SSE2
+            return downscaleRowsSSE2;
+            #else
+            return nullptr;
+            #endif
+
+        case SCodes::DownscaleKernel::AVX2:
+            #if defined(SCODES_AVX2) && defined(__AVX2__)
+            return downscaleRowsAVX2;
+            #elif defined(SCODES_AVX2)
+            return __builtin_cpu_supports("avx2") ? downscaleRowsAVX2 : nullptr;
+            #else
+            return nullptr;
+            #endif
+
+        case SCodes::DownscaleKernel::NEON:
+            #ifdef SCODES_NEON
+            return downscaleRowsNEON;
+            #else
+            return nullptr;
+            #endif
+
+        case SCodes::DownscaleKernel::Scalar:
+            break;
+    }
+
+    return nullptr;
+}
+}
+
+bool SCodes::isSupported(DownscaleKernel kernel)
+{
+    return kernel == DownscaleKernel::Automatic || kernel == DownscaleKernel::Scalar || rowFunction(kernel) != nullptr;
+}
+
+void SCodes::downscale2x(const LuminanceImage &image, uint8_t *output, int outputStride, DownscaleKernel kernel)
+{
+    const int outputWidth  = image.width / 2;
+    const int outputHeight = image.height / 2;
+    const RowFunction vectorized = image.pixStride == 1 ? rowFunction(kernel) : nullptr;
+
+    for (int y = 0; y < outputHeight; ++y) {
+        const uint8_t *row0 = image.data + size_t(2 * y) * image.rowStride;
+        const uint8_t *row1 = row0 + image.rowStride;
+        uint8_t *outputRow  = output + size_t(y) * outputStride;
+
+        const int done = vectorized ? vectorized(row0, row1, outputRow, outputWidth) : 0;
+
+        downscaleRowsScalar(row0 + 2 * done * image.pixStride, row1 + 2 * done * image.pixStride, outputRow + done,
+                            outputWidth - done, image.pixStride);
+    }
+}
+
+void SCodes::LuminancePyramid::build(const LuminanceImage &image, int maxLevels, int minSize)
+{
+    m_levelCount = 0;
+
+    if (int(m_levels.size()) < maxLevels) {
+        m_levels.resize(maxLevels);
+    }
+
+    LuminanceImage source = image;
+
+    while (m_levelCount < maxLevels && source.width / 2 >= minSize && source.height / 2 >= minSize) {
+        Level &level = m_levels[m_levelCount];
+        level.width  = source.width / 2;
+        level.height = source.height / 2;
+        level.pixels.resize(size_t(level.width) * level.height);
+
+        downscale2x(source, level.pixels.data(), level.width);
+
+        source = this->level(m_levelCount++);
+    }
+}
+
+int SCodes::LuminancePyramid::levelCount() const
+{
+    return m_levelCount;
+}
+
+SCodes::LuminanceImage SCodes::LuminancePyramid::level(int index) const
+{
+    const Level &level = m_levels.at(index);
+    return { level.pixels.data(), level.width, level.height, level.width, 1 };
+}
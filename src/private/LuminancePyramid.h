@@ -0,0 +1,95 @@
+/*!
+ * This file contains the luminance image pyramid used to decode downscaled images before the full resolution one.
+ * Downscaling averages 2x2 blocks, vectorized with AVX2, SSE2 or NEON where available.
+ */
+#ifndef LUMINANCEPYRAMID_H
+#define LUMINANCEPYRAMID_H
+
+#include <cstdint>
+#include <vector>
+
+namespace SCodes {
+/*!
+ * \brief View on 8 bit luminance samples
+ */
+struct LuminanceImage {
+    const uint8_t *data = nullptr;
+    int width     = 0;
+    int height    = 0;
+    int rowStride = 0;
+    int pixStride = 1;
+};
+
+/*!
+ * \brief Row kernels of downscale2x. Vectorized kernels handle contiguous samples only, the scalar kernel handles
+ * the rest of every row and images with a pixel stride above 1.
+ */
+enum class DownscaleKernel {
+    Automatic,
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON,
+};
+
+/*!
+ * \fn bool isSupported(DownscaleKernel kernel)
+ * \brief Returns true if the kernel was compiled in and the CPU supports it.
+ */
+bool isSupported(DownscaleKernel kernel);
+
+/*!
+ * \fn void downscale2x(const LuminanceImage &image, uint8_t *output, int outputStride, DownscaleKernel kernel)
+ * \brief Halves the image in both directions, every output sample is the rounded average of a 2x2 block.
+ * \param const LuminanceImage &image - source image.
+ * \param uint8_t *output - destination buffer, at least (image.height / 2) rows of outputStride bytes.
+ * \param int outputStride - distance between output rows in bytes.
+ * \param DownscaleKernel kernel - row kernel, Automatic picks the fastest supported one. Unsupported kernels fall
+ * back to the scalar one.
+ */
+void downscale2x(const LuminanceImage &image, uint8_t *output, int outputStride,
+                 DownscaleKernel kernel = DownscaleKernel::Automatic);
+
+/*!
+ * \brief The LuminancePyramid class keeps successively halved copies of an image. Buffers are reused between
+ * builds, so rebuilding for frames of the same size does not allocate.
+ */
+class LuminancePyramid
+{
+public:
+    /*!
+     * \fn void build(const LuminanceImage &image, int maxLevels, int minSize)
+     * \brief Builds levels of half, quarter, ... resolution until maxLevels is reached or the shorter side of the
+     * next level would drop below minSize.
+     * \param const LuminanceImage &image - full resolution image, it is not part of the pyramid.
+     * \param int maxLevels - maximum number of levels.
+     * \param int minSize - minimum length of the shorter side of a level.
+     */
+    void build(const LuminanceImage &image, int maxLevels, int minSize);
+
+    /*!
+     * \fn int levelCount() const
+     * \brief Returns number of levels of the last build.
+     */
+    int levelCount() const;
+
+    /*!
+     * \fn LuminanceImage level(int index) const
+     * \brief Returns the level, 0 is half resolution, levelCount() - 1 the coarsest one.
+     * \param int index - level index.
+     */
+    LuminanceImage level(int index) const;
+
+private:
+    struct Level {
+        std::vector<uint8_t> pixels;
+        int width  = 0;
+        int height = 0;
+    };
+
+    std::vector<Level> m_levels;
+    int m_levelCount = 0;
+};
+}
+
+#endif // LUMINANCEPYRAMID_H
@@ -0,0 +1,137 @@
+#include "ResultFilter.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+/*!
+ *  Number of remembered barcodes above which expired ones are removed
+ */
+constexpr int k_maxLastSeen = 64;
+
+/*!
+ * \fn size_t resultHash(const SBarcodeResult &result)
+ * \brief Returns hash of the barcode text seeded with its format.
+ */
+size_t resultHash(const SBarcodeResult &result)
+{
+    return qHash(result.text, uint(result.format));
+}
+}
+
+SCodes::ResultFilter::ResultFilter()
+    : m_history(1)
+{
+    m_clock.start();
+}
+
+int SCodes::ResultFilter::requiredFrames() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_requiredFrames;
+}
+
+void SCodes::ResultFilter::setRequiredFrames(int requiredFrames)
+{
+    QMutexLocker locker(&m_mutex);
+    // Kept as requested, the window may be set afterwards, it is limited to the window where it is used
+    m_requiredFrames = qMax(1, requiredFrames);
+}
+
+int SCodes::ResultFilter::windowFrames() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_windowFrames;
+}
+
+void SCodes::ResultFilter::setWindowFrames(int windowFrames)
+{
+    QMutexLocker locker(&m_mutex);
+    m_windowFrames   = qMax(1, windowFrames);
+    m_history        = QVector<QVector<size_t>>(m_windowFrames);
+    m_historyIndex   = 0;
+}
+
+int SCodes::ResultFilter::repeatInterval() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_repeatInterval;
+}
+
+void SCodes::ResultFilter::setRepeatInterval(int milliseconds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_repeatInterval = qMax(0, milliseconds);
+}
+
+QList<SBarcodeResult> SCodes::ResultFilter::filter(const QList<SBarcodeResult> &results)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Nothing to filter with the default settings, keep the hot path free of any work
+    if (m_windowFrames == 1 && m_repeatInterval == 0) {
+        return results;
+    }
+
+    QVector<size_t> &frame = m_history[m_historyIndex];
+    m_historyIndex = (m_historyIndex + 1) % m_windowFrames;
+
+    frame.clear();
+
+    for (const auto &result : results) {
+        const size_t hash = resultHash(result);
+
+        if (!frame.contains(hash)) {
+            frame.append(hash);
+        }
+    }
+
+    if (results.isEmpty()) {
+        return results;
+    }
+
+    const qint64 now = m_clock.elapsed();
+    const int requiredFrames = qMin(m_requiredFrames, m_windowFrames);
+    QList<SBarcodeResult> reported;
+
+    for (const auto &result : results) {
+        const size_t hash = resultHash(result);
+
+        const auto agreeing = std::count_if(m_history.cbegin(), m_history.cend(), [hash](const QVector<size_t> &hashes){
+            return hashes.contains(hash);
+        });
+
+        if (agreeing < requiredFrames) {
+            continue;
+        }
+
+        if (m_repeatInterval > 0) {
+            const auto lastSeen = m_lastSeen.find(hash);
+            const bool repeated = lastSeen != m_lastSeen.end() && now - lastSeen.value() < m_repeatInterval;
+
+            m_lastSeen.insert(hash, now);
+
+            if (repeated) {
+                continue;
+            }
+        }
+
+        reported.append(result);
+    }
+
+    if (m_lastSeen.size() > k_maxLastSeen) {
+        for (auto it = m_lastSeen.begin(); it != m_lastSeen.end();) {
+            it = now - it.value() >= m_repeatInterval ? m_lastSeen.erase(it) : std::next(it);
+        }
+    }
+
+    return reported;
+}
+
+void SCodes::ResultFilter::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_history      = QVector<QVector<size_t>>(m_windowFrames);
+    m_historyIndex = 0;
+    m_lastSeen.clear();
+}
@@ -0,0 +1,97 @@
+/*!
+ * This file contains the result filter, which reports a barcode only after it was decoded in enough frames and
+ * suppresses repeated reports of the same barcode.
+ */
+#ifndef RESULTFILTER_H
+#define RESULTFILTER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QVector>
+
+#include "SBarcodeResult.h"
+
+namespace SCodes {
+/*!
+ * \brief The ResultFilter class filters results of consecutive frames. A barcode passes once it was decoded in
+ * at least requiredFrames of the last windowFrames frames, and is suppressed while it keeps being seen within
+ * repeatInterval milliseconds. Barcodes are compared by hash of their text and format only. All methods are
+ * thread safe.
+ */
+class ResultFilter
+{
+public:
+    ResultFilter();
+
+    /*!
+     * \fn int requiredFrames() const
+     * \brief Returns number of frames a barcode has to be decoded in before it is reported.
+     */
+    int requiredFrames() const;
+
+    /*!
+     * \fn void setRequiredFrames(int requiredFrames)
+     * \brief Sets number of frames a barcode has to be decoded in before it is reported.
+     * \param int requiredFrames - number of frames, at least 1. Frames beyond windowFrames are not required.
+     */
+    void setRequiredFrames(int requiredFrames);
+
+    /*!
+     * \fn int windowFrames() const
+     * \brief Returns number of last frames in which the agreeing frames are counted.
+     */
+    int windowFrames() const;
+
+    /*!
+     * \fn void setWindowFrames(int windowFrames)
+     * \brief Sets number of last frames in which the agreeing frames are counted.
+     * \param int windowFrames - number of frames, at least 1.
+     */
+    void setWindowFrames(int windowFrames);
+
+    /*!
+     * \fn int repeatInterval() const
+     * \brief Returns time in milliseconds within which a barcode is not reported again.
+     */
+    int repeatInterval() const;
+
+    /*!
+     * \fn void setRepeatInterval(int milliseconds)
+     * \brief Sets time in milliseconds within which a barcode is not reported again. The time is counted from
+     * the last frame the barcode was seen in, so a barcode held in front of the camera is reported once.
+     * \param int milliseconds - time interval, 0 reports the barcode in every frame.
+     */
+    void setRepeatInterval(int milliseconds);
+
+    /*!
+     * \fn QList<SBarcodeResult> filter(const QList<SBarcodeResult> &results)
+     * \brief Adds results of a frame and returns the ones to be reported.
+     * \param const QList<SBarcodeResult> &results - barcodes decoded from the frame, empty if nothing was found.
+     */
+    QList<SBarcodeResult> filter(const QList<SBarcodeResult> &results);
+
+    /*!
+     * \fn void reset()
+     * \brief Forgets all frames and reported barcodes.
+     */
+    void reset();
+
+private:
+    mutable QMutex m_mutex;
+    int m_requiredFrames = 1;
+    int m_windowFrames   = 1;
+    int m_repeatInterval = 0;
+
+    /// Hashes of barcodes decoded in the last frames, used as ring buffer
+    QVector<QVector<size_t>> m_history;
+    int m_historyIndex = 0;
+
+    /// Time in milliseconds barcodes were last seen at, by hash
+    QHash<size_t, qint64> m_lastSeen;
+    QElapsedTimer m_clock;
+};
+}
+
+#endif // RESULTFILTER_H
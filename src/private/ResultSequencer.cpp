@@ -0,0 +1,42 @@
+#include "ResultSequencer.h"
+
+void SCodes::ResultSequencer::begin(quint64 sequence)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (sequence > m_lastReported) {
+        m_frames.insert(sequence, std::nullopt);
+    }
+}
+
+void SCodes::ResultSequencer::finish(quint64 sequence, const QList<SBarcodeResult> &results, const Report &report)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const auto frame = m_frames.find(sequence);
+
+    if (frame == m_frames.end()) {
+        return;
+    }
+
+    *frame = results;
+    reportDue(report);
+}
+
+void SCodes::ResultSequencer::discard(quint64 sequence, const Report &report)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_frames.remove(sequence) > 0) {
+        reportDue(report);
+    }
+}
+
+void SCodes::ResultSequencer::reportDue(const Report &report)
+{
+    while (!m_frames.isEmpty() && m_frames.first().has_value()) {
+        m_lastReported = m_frames.firstKey();
+        report(m_lastReported, *m_frames.first());
+        m_frames.erase(m_frames.begin());
+    }
+}
@@ -0,0 +1,67 @@
+/*!
+ * This file contains the result sequencer, which reports results of frames decoded concurrently in frame order.
+ */
+#ifndef RESULTSEQUENCER_H
+#define RESULTSEQUENCER_H
+
+#include <QList>
+#include <QMap>
+#include <QMutex>
+
+#include <functional>
+#include <optional>
+
+#include "SBarcodeResult.h"
+
+namespace SCodes {
+/*!
+ * \brief The ResultSequencer class orders results of frames decoded on several threads. A frame is registered
+ * when its decoding starts, its results are held back until all earlier registered frames are finished. A frame
+ * registered only after a later one was reported already is discarded, as its results are outdated. All methods
+ * are thread safe.
+ */
+class ResultSequencer
+{
+public:
+    using Report = std::function<void(quint64 sequence, const QList<SBarcodeResult> &results)>;
+
+    /*!
+     * \fn void begin(quint64 sequence)
+     * \brief Registers a frame being decoded.
+     * \param quint64 sequence - number of the frame, increasing with the frame time.
+     */
+    void begin(quint64 sequence);
+
+    /*!
+     * \fn void finish(quint64 sequence, const QList<SBarcodeResult> &results, const Report &report)
+     * \brief Stores results of a registered frame and reports all frames which are due, in frame order. The
+     * report function is called with the sequencer locked, so reports never overlap.
+     * \param quint64 sequence - number of the frame.
+     * \param const QList<SBarcodeResult> &results - barcodes decoded from the frame, empty if nothing was found.
+     * \param const Report &report - called once for every reported frame.
+     */
+    void finish(quint64 sequence, const QList<SBarcodeResult> &results, const Report &report);
+
+    /*!
+     * \fn void discard(quint64 sequence, const Report &report)
+     * \brief Forgets a registered frame which was not decoded and reports the frames waiting for it.
+     * \param quint64 sequence - number of the frame.
+     * \param const Report &report - called once for every reported frame.
+     */
+    void discard(quint64 sequence, const Report &report);
+
+private:
+    /*!
+     * \fn void reportDue(const Report &report)
+     * \brief Reports and removes finished frames preceding the first unfinished one. Called with m_mutex locked.
+     */
+    void reportDue(const Report &report);
+
+    QMutex m_mutex;
+    /// Frames being decoded or waiting for earlier ones, results are set once decoded
+    QMap<quint64, std::optional<QList<SBarcodeResult>>> m_frames;
+    quint64 m_lastReported = 0;
+};
+}
+
+#endif // RESULTSEQUENCER_H
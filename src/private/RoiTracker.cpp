@@ -0,0 +1,91 @@
+#include "RoiTracker.h"
+
+namespace {
+/*!
+ *  Margin added on every side of the barcodes bounding rectangle, relative to its size
+ */
+constexpr qreal k_roiMargin = 0.5;
+
+/*!
+ *  Minimum margin in frame pixels, so small barcodes can move between frames
+ */
+constexpr int k_minRoiMargin = 48;
+}
+
+bool SCodes::RoiTracker::isEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_enabled;
+}
+
+void SCodes::RoiTracker::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_enabled = enabled;
+    m_region  = QRect();
+    m_misses  = 0;
+}
+
+int SCodes::RoiTracker::maxMisses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxMisses;
+}
+
+void SCodes::RoiTracker::setMaxMisses(int maxMisses)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxMisses = qMax(1, maxMisses);
+}
+
+QRect SCodes::RoiTracker::region(const QRect &captureRect) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_enabled || m_region.isNull()) {
+        return captureRect;
+    }
+
+    const QRect region = m_region.intersected(captureRect);
+    return region.isEmpty() ? captureRect : region;
+}
+
+void SCodes::RoiTracker::update(const QList<SBarcodeResult> &results, const QSize &frameSize)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_enabled) {
+        return;
+    }
+
+    QRectF bounds;
+
+    for (const auto &result : results) {
+        bounds |= result.position.boundingRect();
+    }
+
+    if (bounds.isNull()) {
+        if (++m_misses >= m_maxMisses) {
+            m_region = QRect();
+            m_misses = 0;
+        }
+
+        return;
+    }
+
+    const QRectF pixels(bounds.x() * frameSize.width(), bounds.y() * frameSize.height(),
+                        bounds.width() * frameSize.width(), bounds.height() * frameSize.height());
+
+    const int marginX = qMax(k_minRoiMargin, qRound(pixels.width() * k_roiMargin));
+    const int marginY = qMax(k_minRoiMargin, qRound(pixels.height() * k_roiMargin));
+
+    m_region = pixels.toAlignedRect().adjusted(-marginX, -marginY, marginX, marginY);
+    m_misses = 0;
+}
+
+void SCodes::RoiTracker::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_region = QRect();
+    m_misses = 0;
+}
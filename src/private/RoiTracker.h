@@ -0,0 +1,80 @@
+/*!
+ * This file contains the region of interest tracker, which limits decoding of the next frames to the area
+ * around the last decoded barcodes.
+ */
+#ifndef ROITRACKER_H
+#define ROITRACKER_H
+
+#include <QList>
+#include <QMutex>
+#include <QRect>
+#include <QSize>
+
+#include "SBarcodeResult.h"
+
+namespace SCodes {
+/*!
+ * \brief The RoiTracker class keeps a region of interest around the last decoded barcodes. The region is dropped
+ * after the configured number of frames without any barcode. All methods are thread safe.
+ */
+class RoiTracker
+{
+public:
+    /*!
+     * \fn bool isEnabled() const
+     * \brief Returns true if tracking is enabled.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \fn void setEnabled(bool enabled)
+     * \brief Enables or disables tracking, disabling also drops the current region.
+     * \param bool enabled - tracking state.
+     */
+    void setEnabled(bool enabled);
+
+    /*!
+     * \fn int maxMisses() const
+     * \brief Returns number of frames without barcode after which the full capture area is scanned again.
+     */
+    int maxMisses() const;
+
+    /*!
+     * \fn void setMaxMisses(int maxMisses)
+     * \brief Sets number of frames without barcode after which the full capture area is scanned again.
+     * \param int maxMisses - number of frames, at least 1.
+     */
+    void setMaxMisses(int maxMisses);
+
+    /*!
+     * \fn QRect region(const QRect &captureRect) const
+     * \brief Returns the area to be decoded in the next frame, the whole capture area if no region is tracked.
+     * \param const QRect &captureRect - capture area rectangle in frame pixels.
+     */
+    QRect region(const QRect &captureRect) const;
+
+    /*!
+     * \fn void update(const QList<SBarcodeResult> &results, const QSize &frameSize)
+     * \brief Updates the region with results of a decoded frame, an empty list counts as a miss.
+     * \param const QList<SBarcodeResult> &results - decoded barcodes, positions normalized to the whole frame.
+     * \param const QSize &frameSize - size of the frame in pixels.
+     */
+    void update(const QList<SBarcodeResult> &results, const QSize &frameSize);
+
+    /*!
+     * \fn void reset()
+     * \brief Drops the current region.
+     */
+    void reset();
+
+private:
+    mutable QMutex m_mutex;
+    bool m_enabled = false;
+    int m_maxMisses = 5;
+    int m_misses = 0;
+    /// Tracked region in frame pixels, null if there is none
+    QRect m_region;
+};
+}
+
+#endif // ROITRACKER_H
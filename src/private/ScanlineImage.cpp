@@ -0,0 +1,70 @@
+#include "ScanlineImage.h"
+
+#include <algorithm>
+#include <cstring>
+
+void SCodes::ScanlineImage::build(const LuminanceImage &image, int bandCount, bool vertical)
+{
+    const int length = vertical ? image.height : image.width;
+    const int extent = vertical ? image.width : image.height;
+
+    m_vertical = vertical;
+    m_width = length;
+    m_lines.clear();
+
+    bandCount = std::clamp(bandCount, 0, extent / k_bandLines);
+
+    // Bands are centered in equal slices of the image, the middle one is always scanned for odd counts
+    for (int band = 0; band < bandCount; ++band) {
+        const int first = std::min(int((band + 0.5) * extent / bandCount), extent - k_bandLines);
+
+        for (int i = 0; i < k_bandLines; ++i) {
+            m_lines.push_back(first + i);
+        }
+    }
+
+    m_pixels.resize(m_lines.size() * size_t(length));
+
+    if (!vertical) {
+        for (size_t row = 0; row < m_lines.size(); ++row) {
+            const uint8_t *source = image.data + size_t(m_lines[row]) * image.rowStride;
+            uint8_t *target = m_pixels.data() + row * size_t(length);
+
+            if (image.pixStride == 1) {
+                std::memcpy(target, source, size_t(length));
+            } else {
+                for (int x = 0; x < length; ++x) {
+                    target[x] = source[x * image.pixStride];
+                }
+            }
+        }
+
+        return;
+    }
+
+    // Columns are gathered in a single pass over the source rows, each source row is read once
+    for (int y = 0; y < image.height; ++y) {
+        const uint8_t *source = image.data + size_t(y) * image.rowStride;
+
+        for (size_t row = 0; row < m_lines.size(); ++row) {
+            m_pixels[row * size_t(length) + size_t(y)] = source[m_lines[row] * image.pixStride];
+        }
+    }
+}
+
+SCodes::LuminanceImage SCodes::ScanlineImage::image() const
+{
+    return { m_pixels.data(), m_width, int(m_lines.size()), m_width, 1 };
+}
+
+QPointF SCodes::ScanlineImage::toSource(const QPointF &point) const
+{
+    if (m_lines.empty()) {
+        return point;
+    }
+
+    const int row = std::clamp(int(point.y()), 0, int(m_lines.size()) - 1);
+    const qreal line = m_lines[size_t(row)] + (point.y() - row);
+
+    return m_vertical ? QPointF(line, point.x()) : QPointF(point.x(), line);
+}
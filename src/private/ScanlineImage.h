@@ -0,0 +1,57 @@
+/*!
+ * This file contains the scanline image, a thin image assembled from a few rows or columns of a frame, so linear
+ * barcodes can be decoded without touching the rest of the frame.
+ */
+#ifndef SCANLINEIMAGE_H
+#define SCANLINEIMAGE_H
+
+#include <QPointF>
+
+#include <vector>
+
+#include "LuminancePyramid.h"
+
+namespace SCodes {
+/*!
+ * \brief The ScanlineImage class copies evenly spaced bands of adjacent rows, or columns turned into rows, of a
+ * luminance image into one contiguous image. Every band has k_bandLines lines, so ZXing's linear readers can
+ * confirm a barcode on two neighbouring lines as they do in a full image. Buffers are reused between builds.
+ */
+class ScanlineImage
+{
+public:
+    /// Number of adjacent source lines in a band, matches the default ZXing::ReaderOptions::minLineCount()
+    static constexpr int k_bandLines = 2;
+
+    /*!
+     * \fn void build(const LuminanceImage &image, int bandCount, bool vertical)
+     * \brief Extracts bandCount bands spread evenly over the image height, or over its width for vertical bands.
+     * \param const LuminanceImage &image - source image.
+     * \param int bandCount - number of bands, limited by the image size.
+     * \param bool vertical - true to extract columns, they become rows of the scanline image.
+     */
+    void build(const LuminanceImage &image, int bandCount, bool vertical);
+
+    /*!
+     * \fn LuminanceImage image() const
+     * \brief Returns the scanline image of the last build, one line per row.
+     */
+    LuminanceImage image() const;
+
+    /*!
+     * \fn QPointF toSource(const QPointF &point) const
+     * \brief Maps a point of the scanline image to source image coordinates.
+     * \param const QPointF &point - point in the scanline image.
+     */
+    QPointF toSource(const QPointF &point) const;
+
+private:
+    std::vector<uint8_t> m_pixels;
+    /// Source row, or column, of every scanline image row
+    std::vector<int> m_lines;
+    int m_width = 0;
+    bool m_vertical = false;
+};
+}
+
+#endif // SCANLINEIMAGE_H
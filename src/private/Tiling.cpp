@@ -0,0 +1,98 @@
+#include "Tiling.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+/*!
+ *  Distance in pixels two detections of a barcode may be further apart than half of its size, for the corners
+ *  found by different tiles to differ slightly
+ */
+constexpr qreal k_sameBarcodeTolerance = 8.0;
+
+/*!
+ * \fn QRectF pixelBounds(const QPolygonF &position, const QSize &imageSize)
+ * \brief Returns the bounding rectangle of a normalized position in image pixels.
+ */
+QRectF pixelBounds(const QPolygonF &position, const QSize &imageSize)
+{
+    const QRectF bounds = position.boundingRect();
+
+    return QRectF(bounds.x() * imageSize.width(), bounds.y() * imageSize.height(),
+                  bounds.width() * imageSize.width(), bounds.height() * imageSize.height());
+}
+}
+
+QVector<QRect> SCodes::tileRects(const QSize &imageSize, const QSize &tileSize, int overlap)
+{
+    auto origins = [overlap](int length, int tileLength) {
+        QVector<int> positions;
+
+        if (tileLength >= length) {
+            positions.append(0);
+            return positions;
+        }
+
+        for (int position = 0; ; position += tileLength - overlap) {
+            if (position + tileLength >= length) {
+                positions.append(length - tileLength);
+                break;
+            }
+
+            positions.append(position);
+        }
+
+        return positions;
+    };
+
+    const int tileWidth  = qMin(tileSize.width(), imageSize.width());
+    const int tileHeight = qMin(tileSize.height(), imageSize.height());
+
+    QVector<QRect> tiles;
+
+    for (const int y : origins(imageSize.height(), tileHeight)) {
+        for (const int x : origins(imageSize.width(), tileWidth)) {
+            tiles.append(QRect(x, y, tileWidth, tileHeight));
+        }
+    }
+
+    return tiles;
+}
+
+bool SCodes::isSameBarcode(const SBarcodeResult &first, const SBarcodeResult &second, const QSize &imageSize)
+{
+    if (first.format != second.format || first.text != second.text) {
+        return false;
+    }
+
+    const QRectF firstBounds  = pixelBounds(first.position, imageSize);
+    const QRectF secondBounds = pixelBounds(second.position, imageSize);
+
+    // Two detections of one barcode lie within its extent, e.g. on different rows of a linear barcode
+    const qreal reach = std::max({ firstBounds.width(), firstBounds.height(),
+                                   secondBounds.width(), secondBounds.height() }) / 2 + k_sameBarcodeTolerance;
+    const QPointF distance = firstBounds.center() - secondBounds.center();
+
+    return std::hypot(distance.x(), distance.y()) <= reach;
+}
+
+QList<SBarcodeResult> SCodes::mergeTileResults(const std::vector<QList<SBarcodeResult>> &tileResults,
+                                               const QSize &imageSize)
+{
+    QList<SBarcodeResult> barcodes;
+
+    for (const auto &results : tileResults) {
+        for (const auto &result : results) {
+            // Codes in tile overlaps are found twice, at the same place of the image
+            const bool duplicate = std::any_of(barcodes.cbegin(), barcodes.cend(), [&](const SBarcodeResult &other){
+                return isSameBarcode(other, result, imageSize);
+            });
+
+            if (!duplicate) {
+                barcodes.append(result);
+            }
+        }
+    }
+
+    return barcodes;
+}
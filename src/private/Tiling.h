@@ -0,0 +1,49 @@
+/*!
+ * This file contains the tiling helpers of large images, which split an image into overlapping tiles decoded
+ * separately and merge the barcodes found in them.
+ */
+#ifndef TILING_H
+#define TILING_H
+
+#include <QList>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+
+#include <vector>
+
+#include "SBarcodeResult.h"
+
+namespace SCodes {
+/*!
+ * \fn QVector<QRect> tileRects(const QSize &imageSize, const QSize &tileSize, int overlap)
+ * \brief Splits the image into tiles of given size overlapping by given number of pixels. Tiles on the right and
+ * bottom edges are shifted back to keep their full size.
+ * \param const QSize &imageSize - size of the image.
+ * \param const QSize &tileSize - size of a single tile.
+ * \param int overlap - number of pixels shared by neighbouring tiles.
+ */
+QVector<QRect> tileRects(const QSize &imageSize, const QSize &tileSize, int overlap);
+
+/*!
+ * \fn bool isSameBarcode(const SBarcodeResult &first, const SBarcodeResult &second, const QSize &imageSize)
+ * \brief Returns true if both results are the same barcode found at the same place of the image, by two tiles.
+ * Positions of linear barcodes are zero height lines that never overlap, so the distance of the centers is
+ * compared with the size of the barcodes instead.
+ * \param const SBarcodeResult &first - decoded barcode, position normalized to the image.
+ * \param const SBarcodeResult &second - decoded barcode, position normalized to the image.
+ * \param const QSize &imageSize - size of the image in pixels.
+ */
+bool isSameBarcode(const SBarcodeResult &first, const SBarcodeResult &second, const QSize &imageSize);
+
+/*!
+ * \fn QList<SBarcodeResult> mergeTileResults(const std::vector<QList<SBarcodeResult>> &tileResults, const QSize &imageSize)
+ * \brief Returns the barcodes of all tiles in tile order, those found again by a later tile are left out.
+ * \param const std::vector<QList<SBarcodeResult>> &tileResults - barcodes of every tile, normalized to the image.
+ * \param const QSize &imageSize - size of the image in pixels.
+ */
+QList<SBarcodeResult> mergeTileResults(const std::vector<QList<SBarcodeResult>> &tileResults,
+                                       const QSize &imageSize);
+}
+
+#endif // TILING_H
@@ -0,0 +1,364 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+/*!
+ *  Number of ring buffers of finished threads kept for the export, the oldest ones are released beyond it
+ */
+constexpr size_t k_maxFinishedBuffers = 8;
+
+/*!
+ * \brief Single span in a ring buffer, fields are atomic as the exporting thread reads them while they are written
+ */
+struct Event {
+    std::atomic<const char *> name { nullptr };
+    std::atomic<int64_t> start { 0 };
+    std::atomic<int64_t> end { 0 };
+    std::atomic<uint64_t> frame { 0 };
+};
+
+/*!
+ * \brief Ring buffer of a single thread, written by the thread only
+ */
+struct ThreadBuffer {
+    std::unique_ptr<Event[]> events { new Event[SCodes::Trace::k_bufferSize] };
+    /// Number of spans written since the thread started tracing
+    std::atomic<uint64_t> written { 0 };
+    /// Number of spans written when the trace was cleared last
+    std::atomic<uint64_t> cleared { 0 };
+    /// Set when the thread finished, nothing is written anymore
+    std::atomic<bool> finished { false };
+    int tid = 0;
+    std::string name;
+};
+
+/*!
+ * \brief Copy of a span taken for the export
+ */
+struct Span {
+    const char *name;
+    int64_t start;
+    int64_t end;
+    uint64_t frame;
+    int tid;
+};
+
+/*!
+ * \brief Ring buffers of the threads which recorded a span. Buffers of finished threads are kept until they are
+ * exported or cleared, but no more than k_maxFinishedBuffers of them, so short lived threads don't pile up.
+ */
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    int nextTid = 1;
+
+    /*!
+     * \fn void release(size_t keep)
+     * \brief Drops buffers of finished threads, oldest first, until no more than keep of them are left. Called with
+     * the mutex locked, an export running meanwhile keeps its own reference.
+     */
+    void release(size_t keep)
+    {
+        size_t finished = size_t(std::count_if(buffers.cbegin(), buffers.cend(), [](const auto &buffer) {
+            return buffer->finished.load(std::memory_order_acquire);
+        }));
+
+        for (auto it = buffers.begin(); it != buffers.end() && finished > keep;) {
+            if ((*it)->finished.load(std::memory_order_acquire)) {
+                it = buffers.erase(it);
+                --finished;
+            } else {
+                ++it;
+            }
+        }
+    }
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+const auto k_epoch = std::chrono::steady_clock::now();
+
+/*!
+ * \brief Owner of the ring buffer of a thread, marks the buffer finished when the thread ends
+ */
+struct BufferOwner {
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ~BufferOwner()
+    {
+        if (buffer) {
+            buffer->finished.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local BufferOwner t_buffer;
+thread_local uint64_t t_frame = 0;
+thread_local std::string t_threadName;
+
+/*!
+ * \fn ThreadBuffer &threadBuffer()
+ * \brief Returns the ring buffer of the current thread, it is allocated and registered on first use.
+ */
+ThreadBuffer &threadBuffer()
+{
+    if (!t_buffer.buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+
+        reg.release(k_maxFinishedBuffers);
+        buffer->tid  = reg.nextTid++;
+        buffer->name = t_threadName;
+        reg.buffers.push_back(buffer);
+        t_buffer.buffer = std::move(buffer);
+    }
+
+    return *t_buffer.buffer;
+}
+
+/*!
+ * \fn void appendEscaped(std::string &json, const char *text)
+ * \brief Appends the text as JSON string literal.
+ */
+void appendEscaped(std::string &json, const char *text)
+{
+    json += '"';
+
+    for (const char *c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            json += '\\';
+            json += *c;
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", unsigned(static_cast<unsigned char>(*c)));
+            json += escaped;
+        } else {
+            json += *c;
+        }
+    }
+
+    json += '"';
+}
+
+/*!
+ * \fn void appendMicroseconds(std::string &json, int64_t nanoseconds)
+ * \brief Appends the time in microseconds, trace event timestamps are in microseconds.
+ */
+void appendMicroseconds(std::string &json, int64_t nanoseconds)
+{
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.3f", double(nanoseconds) / 1000.0);
+    json += number;
+}
+}
+
+std::atomic<bool> SCodes::Trace::s_enabled { false };
+
+void SCodes::Trace::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+int64_t SCodes::Trace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - k_epoch).count();
+}
+
+void SCodes::Trace::record(const char *name, int64_t start, int64_t end, uint64_t frame)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    Event &event = buffer.events[index % k_bufferSize];
+
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+    event.frame.store(frame, std::memory_order_relaxed);
+
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+uint64_t SCodes::Trace::currentFrame()
+{
+    return t_frame;
+}
+
+void SCodes::Trace::setThreadName(const std::string &name)
+{
+    // The buffer is allocated only once the thread records a span, it picks up the name then
+    t_threadName = name;
+
+    if (t_buffer.buffer) {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        t_buffer.buffer->name = name;
+    }
+}
+
+std::string SCodes::Trace::toJson()
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<std::shared_ptr<ThreadBuffer>> exported;
+    std::vector<std::pair<int, std::string>> threadNames;
+    Registry &reg = registry();
+
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffers = reg.buffers;
+
+        for (const auto &buffer : buffers) {
+            threadNames.emplace_back(buffer->tid, buffer->name);
+
+            // Buffers of threads finished before the copy are exported completely and released afterwards
+            if (buffer->finished.load(std::memory_order_acquire)) {
+                exported.push_back(buffer);
+            }
+        }
+    }
+
+    std::vector<Span> spans;
+
+    for (const auto &buffer : buffers) {
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        const uint64_t first = std::max(buffer->cleared.load(std::memory_order_relaxed),
+                                        written > uint64_t(k_bufferSize) ? written - k_bufferSize : 0);
+        const size_t copied = spans.size();
+
+        for (uint64_t i = first; i < written; ++i) {
+            const Event &event = buffer->events[i % k_bufferSize];
+            spans.push_back({ event.name.load(std::memory_order_relaxed), event.start.load(std::memory_order_relaxed),
+                              event.end.load(std::memory_order_relaxed), event.frame.load(std::memory_order_relaxed),
+                              buffer->tid });
+        }
+
+        // Spans overwritten while copying, including the one being written now, are dropped
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t writtenAfter = buffer->written.load(std::memory_order_relaxed);
+        const uint64_t valid = writtenAfter + 1 > uint64_t(k_bufferSize) ? writtenAfter + 1 - k_bufferSize : 0;
+
+        if (valid > first) {
+            const size_t overwritten = size_t(std::min(valid, written) - first);
+            spans.erase(spans.begin() + std::ptrdiff_t(copied), spans.begin() + std::ptrdiff_t(copied + overwritten));
+        }
+    }
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    auto beginEvent = [&]() {
+        json += first ? "\n" : ",\n";
+        first = false;
+    };
+
+    for (const auto &thread : threadNames) {
+        if (thread.second.empty()) {
+            continue;
+        }
+
+        beginEvent();
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(thread.first)
+                + ",\"args\":{\"name\":";
+        appendEscaped(json, thread.second.c_str());
+        json += "}}";
+    }
+
+    std::map<uint64_t, std::vector<const Span *>> frames;
+
+    for (const auto &span : spans) {
+        if (span.name == nullptr) {
+            continue;
+        }
+
+        beginEvent();
+        json += "{\"name\":";
+        appendEscaped(json, span.name);
+        json += ",\"cat\":\"scodes\",\"pid\":1,\"tid\":" + std::to_string(span.tid) + ",\"ts\":";
+        appendMicroseconds(json, span.start);
+
+        if (span.end > span.start) {
+            json += ",\"ph\":\"X\",\"dur\":";
+            appendMicroseconds(json, span.end - span.start);
+        } else {
+            json += ",\"ph\":\"i\",\"s\":\"t\"";
+        }
+
+        if (span.frame != 0) {
+            json += ",\"args\":{\"frame\":" + std::to_string(span.frame) + "}";
+            frames[span.frame].push_back(&span);
+        }
+
+        json += "}";
+    }
+
+    // Flow events draw arrows between the spans of a frame, in the order they started
+    for (auto &frame : frames) {
+        auto &frameSpans = frame.second;
+
+        if (frameSpans.size() < 2) {
+            continue;
+        }
+
+        std::stable_sort(frameSpans.begin(), frameSpans.end(), [](const Span *a, const Span *b) {
+            return a->start < b->start;
+        });
+
+        for (size_t i = 0; i < frameSpans.size(); ++i) {
+            const char *phase = i == 0 ? "s" : (i + 1 == frameSpans.size() ? "f" : "t");
+
+            beginEvent();
+            json += "{\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"";
+            json += phase;
+            json += "\",\"bp\":\"e\",\"id\":" + std::to_string(frame.first) + ",\"pid\":1,\"tid\":"
+                    + std::to_string(frameSpans[i]->tid) + ",\"ts\":";
+            appendMicroseconds(json, frameSpans[i]->start);
+            json += "}";
+        }
+    }
+
+    json += "\n]}\n";
+
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.buffers.erase(std::remove_if(reg.buffers.begin(), reg.buffers.end(), [&](const auto &buffer) {
+            return std::find(exported.cbegin(), exported.cend(), buffer) != exported.cend();
+        }), reg.buffers.end());
+    }
+
+    return json;
+}
+
+void SCodes::Trace::clear()
+{
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    for (const auto &buffer : reg.buffers) {
+        buffer->cleared.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+    // Finished threads have nothing left to export
+    reg.release(0);
+}
+
+SCodes::TraceFrame::TraceFrame(uint64_t frame)
+    : m_previous(t_frame)
+{
+    t_frame = frame;
+}
+
+SCodes::TraceFrame::~TraceFrame()
+{
+    t_frame = m_previous;
+}
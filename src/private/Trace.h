@@ -0,0 +1,154 @@
+/*!
+ * This file contains the pipeline tracer, which records timed spans of the frame pipeline into per-thread ring
+ * buffers and exports them as Chrome trace event JSON, to be opened in chrome://tracing or Perfetto.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace SCodes {
+/*!
+ * \brief The Trace class is the process-wide tracer. Every thread records into its own ring buffer without any
+ * lock, the oldest spans are overwritten once it is full. Spans carry the id of the frame they belong to, so the
+ * export links spans of one frame across threads. Buffers of finished threads are released once exported or
+ * cleared, and only the latest few of them are kept meanwhile. While tracing is disabled a span costs one relaxed
+ * atomic load. All methods are thread safe.
+ */
+class Trace
+{
+public:
+    /*!
+     *  Number of spans kept per thread
+     */
+    static constexpr int k_bufferSize = 1 << 14;
+
+    /*!
+     * \fn static bool isEnabled()
+     * \brief Returns true if spans are recorded.
+     */
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * \fn static void setEnabled(bool enabled)
+     * \brief Starts or stops recording, recorded spans are kept.
+     */
+    static void setEnabled(bool enabled);
+
+    /*!
+     * \fn static int64_t now()
+     * \brief Returns the trace clock in nanoseconds.
+     */
+    static int64_t now();
+
+    /*!
+     * \fn static void record(const char *name, int64_t start, int64_t end, uint64_t frame)
+     * \brief Records a span on the current thread.
+     * \param const char *name - name of the span, must stay valid until the trace is exported, a literal usually.
+     * \param int64_t start - start on the trace clock.
+     * \param int64_t end - end on the trace clock, equal to start for an instant event.
+     * \param uint64_t frame - id of the frame, 0 if the span does not belong to a frame.
+     */
+    static void record(const char *name, int64_t start, int64_t end, uint64_t frame);
+
+    /*!
+     * \fn static uint64_t currentFrame()
+     * \brief Returns id of the frame processed by the current thread, set by TraceFrame.
+     */
+    static uint64_t currentFrame();
+
+    /*!
+     * \fn static void setThreadName(const std::string &name)
+     * \brief Names the current thread in the exported trace.
+     */
+    static void setThreadName(const std::string &name);
+
+    /*!
+     * \fn static std::string toJson()
+     * \brief Returns all recorded spans as Chrome trace event JSON. Spans recorded meanwhile may be left out.
+     * Spans of threads that had finished are released.
+     */
+    static std::string toJson();
+
+    /*!
+     * \fn static void clear()
+     * \brief Forgets all recorded spans.
+     */
+    static void clear();
+
+private:
+    friend class TraceFrame;
+
+    static std::atomic<bool> s_enabled;
+};
+
+/*!
+ * \brief The TraceScope class records a span from its construction to its destruction, if tracing is enabled
+ * at construction. The span belongs to the frame set by TraceFrame on the thread, unless set explicitly.
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name)
+        : m_name(Trace::isEnabled() ? name : nullptr)
+        , m_start(m_name ? Trace::now() : 0)
+        , m_frame(m_name ? Trace::currentFrame() : 0)
+    { }
+
+    ~TraceScope()
+    {
+        if (m_name) {
+            Trace::record(m_name, m_start, Trace::now(), m_frame);
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+    /*!
+     * \fn void setFrame(uint64_t frame)
+     * \brief Sets the frame of the span, when its id is known only after the span started.
+     */
+    void setFrame(uint64_t frame)
+    {
+        m_frame = frame;
+    }
+
+private:
+    const char *m_name;
+    int64_t m_start;
+    uint64_t m_frame;
+};
+
+/*!
+ * \brief The TraceFrame class sets the frame processed by the current thread for its lifetime, spans started
+ * meanwhile belong to it.
+ */
+class TraceFrame
+{
+public:
+    explicit TraceFrame(uint64_t frame);
+    ~TraceFrame();
+
+    TraceFrame(const TraceFrame &) = delete;
+    TraceFrame &operator=(const TraceFrame &) = delete;
+
+private:
+    uint64_t m_previous;
+};
+}
+
+#define SCODES_TRACE_CONCAT_(a, b) a##b
+#define SCODES_TRACE_CONCAT(a, b) SCODES_TRACE_CONCAT_(a, b)
+
+/*!
+ *  Records the enclosing scope as span of the given name, like SCODES_MEASURE but always compiled in
+ */
+#define SCODES_TRACE(name) SCodes::TraceScope SCODES_TRACE_CONCAT(scodesTrace, __LINE__) (name)
+
+#endif // TRACE_H
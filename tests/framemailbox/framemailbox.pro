@@ -0,0 +1,6 @@
+include(../tests.pri)
+
+TARGET = tst_framemailbox
+
+SOURCES += \
+    tst_framemailbox.cpp
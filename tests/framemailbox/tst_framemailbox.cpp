@@ -0,0 +1,166 @@
+#include <QtTest>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "private/FrameMailbox.h"
+
+/*!
+ * \brief The FrameMailboxTest class checks that the mailbox passes the newest frames in order and schedules the
+ * consumers taking them.
+ */
+class FrameMailboxTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void keepsNewestFrame();
+    void schedulesConsumers();
+    void reschedulesForLateFrame();
+    void concurrentConsumers();
+    void waitForConsumers();
+};
+
+void FrameMailboxTest::keepsNewestFrame()
+{
+    SCodes::FrameMailbox mailbox;
+    SCodes::FrameMailbox::Frame frame;
+
+    QVERIFY(!mailbox.take(frame));
+
+    QVERIFY(!mailbox.post(QVideoFrame(), QRect(0, 0, 1, 1)));
+    QVERIFY(mailbox.post(QVideoFrame(), QRect(0, 0, 2, 2)));
+    QVERIFY(mailbox.post(QVideoFrame(), QRect(0, 0, 3, 3)));
+
+    QVERIFY(mailbox.take(frame));
+    QCOMPARE(frame.sequence, quint64(3));
+    QCOMPARE(frame.captureRect, QRect(0, 0, 3, 3));
+    QCOMPARE(mailbox.replacedFrames(), 2);
+    QCOMPARE(mailbox.sequence(), quint64(3));
+
+    QVERIFY(!mailbox.take(frame));
+}
+
+void FrameMailboxTest::schedulesConsumers()
+{
+    SCodes::FrameMailbox mailbox;
+
+    QVERIFY(mailbox.tryScheduleConsumer(2));
+    QVERIFY(mailbox.tryScheduleConsumer(2));
+    QVERIFY(!mailbox.tryScheduleConsumer(2));
+    QCOMPARE(mailbox.scheduledConsumers(), 2);
+
+    QVERIFY(!mailbox.finishConsumer(2));
+    QVERIFY(!mailbox.finishConsumer(2));
+    QCOMPARE(mailbox.scheduledConsumers(), 0);
+}
+
+void FrameMailboxTest::reschedulesForLateFrame()
+{
+    SCodes::FrameMailbox mailbox;
+    SCodes::FrameMailbox::Frame frame;
+
+    mailbox.post(QVideoFrame(), QRect());
+    QVERIFY(mailbox.tryScheduleConsumer());
+    QVERIFY(mailbox.take(frame));
+
+    // Posted while the only consumer is still running, nobody was scheduled for it
+    mailbox.post(QVideoFrame(), QRect());
+    QVERIFY(!mailbox.tryScheduleConsumer());
+
+    QVERIFY(mailbox.finishConsumer());
+    QCOMPARE(mailbox.scheduledConsumers(), 1);
+    QVERIFY(mailbox.take(frame));
+    QCOMPARE(frame.sequence, quint64(2));
+    QVERIFY(!mailbox.finishConsumer());
+}
+
+void FrameMailboxTest::concurrentConsumers()
+{
+    constexpr int frameCount = 20000;
+    constexpr int consumerCount = 3;
+
+    SCodes::FrameMailbox mailbox;
+    std::atomic<bool> posting { true };
+    std::vector<std::vector<quint64>> taken(consumerCount);
+    std::vector<std::thread> consumers;
+
+    for (int c = 0; c < consumerCount; ++c) {
+        consumers.emplace_back([&, c]() {
+            SCodes::FrameMailbox::Frame frame;
+
+            while (true) {
+                const bool done = !posting;
+
+                while (mailbox.take(frame)) {
+                    taken[size_t(c)].push_back(frame.sequence);
+                }
+
+                if (done) {
+                    break;
+                }
+
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    for (int i = 0; i < frameCount; ++i) {
+        mailbox.post(QVideoFrame(), QRect());
+    }
+
+    posting = false;
+
+    for (auto &consumer : consumers) {
+        consumer.join();
+    }
+
+    // Every frame was either taken once or replaced, each consumer saw its frames in frame order
+    QVector<int> takeCounts(frameCount + 1, 0);
+    int takenCount = 0;
+
+    for (const auto &sequences : taken) {
+        QVERIFY(std::is_sorted(sequences.cbegin(), sequences.cend()));
+
+        for (const quint64 sequence : sequences) {
+            ++takeCounts[int(sequence)];
+            ++takenCount;
+        }
+    }
+
+    QVERIFY(std::all_of(takeCounts.cbegin(), takeCounts.cend(), [](int count) { return count <= 1; }));
+    QCOMPARE(takenCount + mailbox.replacedFrames(), frameCount);
+    QCOMPARE(takeCounts[frameCount], 1);
+}
+
+void FrameMailboxTest::waitForConsumers()
+{
+    SCodes::FrameMailbox mailbox;
+    std::atomic<int> finished { 0 };
+    std::vector<std::thread> consumers;
+
+    for (int c = 0; c < 2; ++c) {
+        QVERIFY(mailbox.tryScheduleConsumer(2));
+
+        consumers.emplace_back([&, c]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50 * (c + 1)));
+            ++finished;
+            mailbox.finishConsumer(2);
+        });
+    }
+
+    mailbox.waitForConsumers();
+
+    QCOMPARE(finished.load(), 2);
+    QCOMPARE(mailbox.scheduledConsumers(), 0);
+
+    for (auto &consumer : consumers) {
+        consumer.join();
+    }
+}
+
+QTEST_GUILESS_MAIN(FrameMailboxTest)
+
+#include "tst_framemailbox.moc"
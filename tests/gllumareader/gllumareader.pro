@@ -0,0 +1,6 @@
+include(../tests.pri)
+
+TARGET = tst_gllumareader
+
+SOURCES += \
+    tst_gllumareader.cpp
@@ -0,0 +1,288 @@
+#include <QtTest>
+
+#include <QAbstractVideoBuffer>
+#include <QGuiApplication>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QVideoFrame>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "SBarcodeDecoder.h"
+#include "private/GlLumaReader.h"
+
+namespace {
+/*!
+ *  Size of the test texture, the capture area is not a multiple of the four samples packed per texel
+ */
+const QSize k_textureSize(101, 37);
+const QRect k_captureRect(3, 5, 61, 29);
+
+/*!
+ * \brief The TextureBuffer class wraps a texture into a video buffer, as the camera backends of Qt5 deliver it.
+ */
+class TextureBuffer : public QAbstractVideoBuffer
+{
+public:
+    explicit TextureBuffer(GLuint texture)
+        : QAbstractVideoBuffer(GLTextureHandle)
+        , m_texture(texture)
+    {
+    }
+
+    MapMode mapMode() const override
+    {
+        return NotMapped;
+    }
+
+    uchar *map(MapMode, int *, int *) override
+    {
+        return nullptr;
+    }
+
+    void unmap() override
+    {
+    }
+
+    QVariant handle() const override
+    {
+        return QVariant::fromValue(uint(m_texture));
+    }
+
+private:
+    GLuint m_texture;
+};
+}
+
+/*!
+ * \brief The GlLumaReaderTest class checks the GPU luminance readback against the CPU conversion of the decoder.
+ * It needs an OpenGL context, Mesa's software rasterizer is enough, and is skipped without one.
+ */
+class GlLumaReaderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void synchronousRead();
+    void asynchronousRead();
+    void restoresState();
+
+private:
+    /*!
+     * \fn GLuint createTexture(unsigned seed)
+     * \brief Uploads a texture of random colors and returns it.
+     */
+    GLuint createTexture(unsigned seed);
+
+    /*!
+     * \fn QImage cpuLuminance(GLuint texture)
+     * \brief Returns luminance of the capture area converted by the decoder on the CPU.
+     */
+    QImage cpuLuminance(GLuint texture);
+
+    /*!
+     * \fn void compare(const QImage &actual, const QImage &expected)
+     * \brief Compares luminance images, samples may differ by one as the GPU converts in floating point.
+     */
+    void compare(const QImage &actual, const QImage &expected);
+
+    QOffscreenSurface m_surface;
+    QOpenGLContext m_context;
+    QOpenGLFunctions *m_f = nullptr;
+    std::vector<GLuint> m_textures;
+    SBarcodeDecoder m_decoder;
+};
+
+void GlLumaReaderTest::initTestCase()
+{
+    m_surface.create();
+
+    if (!m_context.create() || !m_context.makeCurrent(&m_surface)) {
+        QSKIP("No OpenGL context available");
+    }
+
+    m_f = m_context.functions();
+}
+
+void GlLumaReaderTest::cleanupTestCase()
+{
+    if (m_f) {
+        m_f->glDeleteTextures(GLsizei(m_textures.size()), m_textures.data());
+        m_context.doneCurrent();
+    }
+}
+
+GLuint GlLumaReaderTest::createTexture(unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> channel(0, 255);
+    std::vector<uchar> pixels(size_t(k_textureSize.width()) * k_textureSize.height() * 4);
+
+    for (auto &value : pixels) {
+        value = uchar(channel(generator));
+    }
+
+    GLuint texture = 0;
+    m_f->glGenTextures(1, &texture);
+    m_f->glBindTexture(GL_TEXTURE_2D, texture);
+    m_f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    m_f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    m_f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, k_textureSize.width(), k_textureSize.height(), 0, GL_RGBA,
+                      GL_UNSIGNED_BYTE, pixels.data());
+    m_f->glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_textures.push_back(texture);
+    return texture;
+}
+
+QImage GlLumaReaderTest::cpuLuminance(GLuint texture)
+{
+    const QVideoFrame frame(new TextureBuffer(texture), k_textureSize, QVideoFrame::Format_RGB32);
+
+    // The pooled buffer is reused by the next conversion
+    return m_decoder.videoFrameToLuminance(frame, k_captureRect).copy();
+}
+
+void GlLumaReaderTest::compare(const QImage &actual, const QImage &expected)
+{
+    QCOMPARE(actual.format(), QImage::Format_Grayscale8);
+    QCOMPARE(actual.size(), expected.size());
+
+    for (int y = 0; y < expected.height(); ++y) {
+        for (int x = 0; x < expected.width(); ++x) {
+            const int difference = int(actual.constScanLine(y)[x]) - int(expected.constScanLine(y)[x]);
+
+            if (qAbs(difference) > 1) {
+                QFAIL(qPrintable(QString("Sample %1,%2 differs by %3").arg(x).arg(y).arg(difference)));
+            }
+        }
+    }
+}
+
+void GlLumaReaderTest::synchronousRead()
+{
+    const GLuint texture = createTexture(1);
+
+    SCodes::GlLumaReader reader;
+    QVERIFY(reader.initialize());
+
+    QImage luminance;
+    QVERIFY(reader.read(texture, k_textureSize, k_captureRect, luminance));
+
+    compare(luminance, cpuLuminance(texture));
+}
+
+void GlLumaReaderTest::asynchronousRead()
+{
+    SCodes::GlLumaReader reader;
+    QVERIFY(reader.initialize());
+
+    if (!reader.isAsync()) {
+        QSKIP("Pixel buffer objects need OpenGL 3.2 or OpenGL ES 3.0");
+    }
+
+    const GLuint first = createTexture(2);
+    const GLuint second = createTexture(3);
+
+    QImage luminance;
+    QRect rect;
+    QSize textureSize;
+
+    // Readbacks are taken one frame late
+    QVERIFY(reader.start(first, k_textureSize, k_captureRect));
+    QVERIFY(!reader.take(luminance, rect, textureSize));
+    QVERIFY(reader.start(second, k_textureSize, k_captureRect));
+    m_f->glFinish();
+
+    QVERIFY(reader.take(luminance, rect, textureSize));
+    QCOMPARE(rect, k_captureRect);
+    QCOMPARE(textureSize, k_textureSize);
+    compare(luminance, cpuLuminance(first));
+
+    // Taken once only
+    QVERIFY(!reader.take(luminance, rect, textureSize));
+
+    QVERIFY(reader.start(first, k_textureSize, k_captureRect));
+    m_f->glFinish();
+
+    QVERIFY(reader.take(luminance, rect, textureSize));
+    compare(luminance, cpuLuminance(second));
+}
+
+void GlLumaReaderTest::restoresState()
+{
+    const GLuint texture = createTexture(4);
+
+    SCodes::GlLumaReader reader;
+    QVERIFY(reader.initialize());
+
+    // State the scene graph may rely on
+    GLint boundFramebuffer = 0;
+    m_f->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &boundFramebuffer);
+    m_f->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    m_f->glViewport(1, 2, 30, 40);
+
+    GLuint vertexBuffer = 0;
+    m_f->glGenBuffers(1, &vertexBuffer);
+    m_f->glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    m_f->glBufferData(GL_ARRAY_BUFFER, 4 * 3 * sizeof(GLfloat), nullptr, GL_STATIC_DRAW);
+    m_f->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), nullptr);
+    m_f->glEnableVertexAttribArray(0);
+    m_f->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    QImage luminance;
+    QVERIFY(reader.read(texture, k_textureSize, k_captureRect, luminance));
+
+    if (reader.isAsync()) {
+        QVERIFY(reader.start(texture, k_textureSize, k_captureRect));
+    }
+
+    GLint packAlignment = 0;
+    GLint viewport[4] = {};
+    GLint framebuffer = -1;
+    m_f->glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+    m_f->glGetIntegerv(GL_VIEWPORT, viewport);
+    m_f->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+
+    QCOMPARE(packAlignment, 1);
+    QCOMPARE(QRect(viewport[0], viewport[1], viewport[2], viewport[3]), QRect(1, 2, 30, 40));
+    QCOMPARE(framebuffer, boundFramebuffer);
+
+    GLint attribEnabled = GL_FALSE;
+    GLint attribBuffer = 0;
+    GLint attribSize = 0;
+    GLint attribStride = 0;
+    m_f->glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &attribEnabled);
+    m_f->glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &attribBuffer);
+    m_f->glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_SIZE, &attribSize);
+    m_f->glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_STRIDE, &attribStride);
+
+    QVERIFY(attribEnabled);
+    QCOMPARE(GLuint(attribBuffer), vertexBuffer);
+    QCOMPARE(attribSize, 3);
+    QCOMPARE(attribStride, GLint(3 * sizeof(GLfloat)));
+
+    m_f->glDisableVertexAttribArray(0);
+    m_f->glDeleteBuffers(1, &vertexBuffer);
+    m_f->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+}
+
+int main(int argc, char *argv[])
+{
+    // Runs without a display, Mesa renders offscreen surfaces in software where there is no GPU
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication app(argc, argv);
+    GlLumaReaderTest test;
+
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_gllumareader.moc"
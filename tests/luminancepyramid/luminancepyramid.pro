@@ -0,0 +1,6 @@
+include(../tests.pri)
+
+TARGET = tst_luminancepyramid
+
+SOURCES += \
+    tst_luminancepyramid.cpp
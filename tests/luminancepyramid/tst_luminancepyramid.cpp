@@ -0,0 +1,155 @@
+#include <QtTest>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "private/LuminancePyramid.h"
+
+Q_DECLARE_METATYPE(SCodes::DownscaleKernel)
+
+namespace {
+/*!
+ * \fn std::vector<uint8_t> randomSamples(size_t count, unsigned seed)
+ * \brief Returns reproducible random luminance samples.
+ */
+std::vector<uint8_t> randomSamples(size_t count, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> sample(0, 255);
+    std::vector<uint8_t> samples(count);
+
+    for (auto &value : samples) {
+        value = uint8_t(sample(generator));
+    }
+
+    return samples;
+}
+
+/*!
+ * \fn std::vector<uint8_t> referenceDownscale(const SCodes::LuminanceImage &image)
+ * \brief Returns the image halved by the plain definition of downscale2x, rounded 2x2 averages.
+ */
+std::vector<uint8_t> referenceDownscale(const SCodes::LuminanceImage &image)
+{
+    const int width  = image.width / 2;
+    const int height = image.height / 2;
+    std::vector<uint8_t> output(size_t(width) * height);
+
+    auto at = [&image](int x, int y) {
+        return int(image.data[size_t(y) * image.rowStride + size_t(x) * image.pixStride]);
+    };
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const int sum = at(2 * x, 2 * y) + at(2 * x + 1, 2 * y) + at(2 * x, 2 * y + 1) + at(2 * x + 1, 2 * y + 1);
+            output[size_t(y) * width + x] = uint8_t((sum + 2) >> 2);
+        }
+    }
+
+    return output;
+}
+}
+
+/*!
+ * \brief The LuminancePyramidTest class checks the vectorized downscaling kernels against the scalar definition.
+ */
+class LuminancePyramidTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void downscale_data();
+    void downscale();
+    void pixelStride();
+    void pyramidLevels();
+};
+
+void LuminancePyramidTest::downscale_data()
+{
+    QTest::addColumn<SCodes::DownscaleKernel>("kernel");
+
+    QTest::newRow("automatic") << SCodes::DownscaleKernel::Automatic;
+    QTest::newRow("scalar")    << SCodes::DownscaleKernel::Scalar;
+    QTest::newRow("sse2")      << SCodes::DownscaleKernel::SSE2;
+    QTest::newRow("avx2")      << SCodes::DownscaleKernel::AVX2;
+    QTest::newRow("neon")      << SCodes::DownscaleKernel::NEON;
+}
+
+void LuminancePyramidTest::downscale()
+{
+    QFETCH(SCodes::DownscaleKernel, kernel);
+
+    if (!SCodes::isSupported(kernel)) {
+        QSKIP("Kernel not supported by this build or CPU");
+    }
+
+    // Widths cover the vector loops and all remainders handled by the scalar kernel, odd sizes drop the last
+    // column and row, the offset makes all loads unaligned
+    for (int width = 1; width <= 160; ++width) {
+        for (const int height : { 2, 3, 7 }) {
+            const int rowStride = width + 5;
+            const auto samples = randomSamples(size_t(rowStride) * height + 1, unsigned(width * 31 + height));
+            const SCodes::LuminanceImage image { samples.data() + 1, width, height, rowStride, 1 };
+
+            const int outputStride = width / 2 + 3;
+            std::vector<uint8_t> output(size_t(outputStride) * (height / 2), 0);
+
+            SCodes::downscale2x(image, output.data(), outputStride, kernel);
+
+            const auto expected = referenceDownscale(image);
+
+            for (int y = 0; y < height / 2; ++y) {
+                for (int x = 0; x < width / 2; ++x) {
+                    QCOMPARE(int(output[size_t(y) * outputStride + x]), int(expected[size_t(y) * (width / 2) + x]));
+                }
+            }
+        }
+    }
+}
+
+void LuminancePyramidTest::pixelStride()
+{
+    // Interleaved samples, e.g. the luminance of YUYV frames, take the scalar kernel with any requested kernel
+    const int width = 67;
+    const int height = 6;
+    const int rowStride = 2 * width + 2;
+    const auto samples = randomSamples(size_t(rowStride) * height, 11);
+    const SCodes::LuminanceImage image { samples.data() + 1, width, height, rowStride, 2 };
+
+    std::vector<uint8_t> output(size_t(width / 2) * (height / 2));
+    SCodes::downscale2x(image, output.data(), width / 2);
+
+    QVERIFY(output == referenceDownscale(image));
+}
+
+void LuminancePyramidTest::pyramidLevels()
+{
+    const int width = 640;
+    const int height = 480;
+    const auto samples = randomSamples(size_t(width) * height, 3);
+    const SCodes::LuminanceImage image { samples.data(), width, height, width, 1 };
+
+    SCodes::LuminancePyramid pyramid;
+    pyramid.build(image, 3, 100);
+
+    // 320x240 and 160x120, the next level would be shorter than 100 samples
+    QCOMPARE(pyramid.levelCount(), 2);
+    QCOMPARE(pyramid.level(0).width, 320);
+    QCOMPARE(pyramid.level(1).height, 120);
+
+    // Every level is halved from the previous one
+    const auto firstLevel = referenceDownscale(image);
+    const auto secondLevel = referenceDownscale(pyramid.level(0));
+
+    QVERIFY(std::equal(firstLevel.cbegin(), firstLevel.cend(), pyramid.level(0).data));
+    QVERIFY(std::equal(secondLevel.cbegin(), secondLevel.cend(), pyramid.level(1).data));
+
+    // Rebuilding for a smaller image reuses the buffers and reports fewer levels
+    pyramid.build({ samples.data(), 300, 200, width, 1 }, 3, 100);
+    QCOMPARE(pyramid.levelCount(), 1);
+}
+
+QTEST_GUILESS_MAIN(LuminancePyramidTest)
+
+#include "tst_luminancepyramid.moc"
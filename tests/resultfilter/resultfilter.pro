@@ -0,0 +1,6 @@
+include(../tests.pri)
+
+TARGET = tst_resultfilter
+
+SOURCES += \
+    tst_resultfilter.cpp
@@ -0,0 +1,143 @@
+#include <QtTest>
+
+#include "private/ResultFilter.h"
+
+namespace {
+/*!
+ * \fn SBarcodeResult barcode(const QString &text, SCodes::SBarcodeFormat format)
+ * \brief Returns a decoded barcode with the given content.
+ */
+SBarcodeResult barcode(const QString &text, SCodes::SBarcodeFormat format = SCodes::SBarcodeFormat::QRCode)
+{
+    SBarcodeResult result;
+    result.text   = text;
+    result.format = format;
+    return result;
+}
+
+/*!
+ * \fn QStringList texts(const QList<SBarcodeResult> &results)
+ * \brief Returns texts of the results, to compare them with expected ones.
+ */
+QStringList texts(const QList<SBarcodeResult> &results)
+{
+    QStringList list;
+
+    for (const auto &result : results) {
+        list.append(result.text);
+    }
+
+    return list;
+}
+}
+
+/*!
+ * \brief The ResultFilterTest class checks the frame consensus and the repeat suppression of the result filter.
+ */
+class ResultFilterTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void passThroughByDefault();
+    void consensus();
+    void requiredFramesBeforeWindow();
+    void requiredFramesAboveWindow();
+    void formatsAreDistinct();
+    void repeatInterval();
+    void reset();
+};
+
+void ResultFilterTest::passThroughByDefault()
+{
+    SCodes::ResultFilter filter;
+    const QList<SBarcodeResult> results { barcode("a"), barcode("a"), barcode("b") };
+
+    QCOMPARE(texts(filter.filter(results)), texts(results));
+    QCOMPARE(texts(filter.filter(results)), texts(results));
+}
+
+void ResultFilterTest::consensus()
+{
+    SCodes::ResultFilter filter;
+    filter.setWindowFrames(3);
+    filter.setRequiredFrames(2);
+
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList());
+    QCOMPARE(texts(filter.filter({})), QStringList());
+    // Second frame with "a" out of the last three
+    QCOMPARE(texts(filter.filter({ barcode("a"), barcode("b") })), QStringList { "a" });
+    QCOMPARE(texts(filter.filter({ barcode("b") })), QStringList { "b" });
+    QCOMPARE(texts(filter.filter({})), QStringList());
+    QCOMPARE(texts(filter.filter({})), QStringList());
+    // The earlier frames with "b" left the window
+    QCOMPARE(texts(filter.filter({ barcode("b") })), QStringList());
+}
+
+void ResultFilterTest::requiredFramesBeforeWindow()
+{
+    // QML may assign consensusFrames before consensusWindow, the requested value must survive
+    SCodes::ResultFilter filter;
+    filter.setRequiredFrames(3);
+    filter.setWindowFrames(5);
+
+    QCOMPARE(filter.requiredFrames(), 3);
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList());
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList());
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList { "a" });
+}
+
+void ResultFilterTest::requiredFramesAboveWindow()
+{
+    SCodes::ResultFilter filter;
+    filter.setRequiredFrames(4);
+    filter.setWindowFrames(2);
+
+    // Kept as requested, but only the frames of the window can agree
+    QCOMPARE(filter.requiredFrames(), 4);
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList());
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList { "a" });
+}
+
+void ResultFilterTest::formatsAreDistinct()
+{
+    SCodes::ResultFilter filter;
+    filter.setWindowFrames(2);
+    filter.setRequiredFrames(2);
+
+    QCOMPARE(texts(filter.filter({ barcode("1234", SCodes::SBarcodeFormat::Code128) })), QStringList());
+    QCOMPARE(texts(filter.filter({ barcode("1234", SCodes::SBarcodeFormat::ITF) })), QStringList());
+}
+
+void ResultFilterTest::repeatInterval()
+{
+    SCodes::ResultFilter filter;
+    filter.setRepeatInterval(60000);
+
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList { "a" });
+    QCOMPARE(texts(filter.filter({ barcode("a"), barcode("b") })), QStringList { "b" });
+    QCOMPARE(texts(filter.filter({ barcode("a"), barcode("b") })), QStringList());
+
+    filter.setRepeatInterval(0);
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList { "a" });
+}
+
+void ResultFilterTest::reset()
+{
+    SCodes::ResultFilter filter;
+    filter.setWindowFrames(2);
+    filter.setRequiredFrames(2);
+    filter.setRepeatInterval(60000);
+
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList());
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList { "a" });
+
+    filter.reset();
+
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList());
+    QCOMPARE(texts(filter.filter({ barcode("a") })), QStringList { "a" });
+}
+
+QTEST_GUILESS_MAIN(ResultFilterTest)
+
+#include "tst_resultfilter.moc"
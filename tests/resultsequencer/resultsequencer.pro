@@ -0,0 +1,6 @@
+include(../tests.pri)
+
+TARGET = tst_resultsequencer
+
+SOURCES += \
+    tst_resultsequencer.cpp
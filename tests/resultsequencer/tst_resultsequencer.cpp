@@ -0,0 +1,164 @@
+#include <QtTest>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "private/ResultSequencer.h"
+
+namespace {
+/*!
+ * \fn QList<SBarcodeResult> frameResults(quint64 sequence)
+ * \brief Returns results identifying the frame they were decoded from.
+ */
+QList<SBarcodeResult> frameResults(quint64 sequence)
+{
+    SBarcodeResult result;
+    result.text   = QString::number(sequence);
+    result.format = SCodes::SBarcodeFormat::QRCode;
+    return { result };
+}
+}
+
+/*!
+ * \brief The ResultSequencerTest class checks that results of concurrently decoded frames are reported in frame
+ * order.
+ */
+class ResultSequencerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void inOrder();
+    void outOfOrder();
+    void discard();
+    void lateRegistration();
+    void concurrentFinish();
+
+private:
+    /*!
+     * \fn SCodes::ResultSequencer::Report recorder()
+     * \brief Returns report function appending the reported frames to m_reported, the sequencer serializes the
+     * calls.
+     */
+    SCodes::ResultSequencer::Report recorder();
+
+    QList<quint64> m_reported;
+};
+
+SCodes::ResultSequencer::Report ResultSequencerTest::recorder()
+{
+    m_reported.clear();
+
+    // Called from the finishing threads, results not belonging to the frame are recorded as frame 0
+    return [this](quint64 sequence, const QList<SBarcodeResult> &results) {
+        m_reported.append(results.first().text == QString::number(sequence) ? sequence : 0);
+    };
+}
+
+void ResultSequencerTest::inOrder()
+{
+    SCodes::ResultSequencer sequencer;
+    const auto report = recorder();
+
+    for (quint64 sequence = 1; sequence <= 3; ++sequence) {
+        sequencer.begin(sequence);
+        sequencer.finish(sequence, frameResults(sequence), report);
+        QCOMPARE(m_reported.last(), sequence);
+    }
+
+    QCOMPARE(m_reported, (QList<quint64> { 1, 2, 3 }));
+}
+
+void ResultSequencerTest::outOfOrder()
+{
+    SCodes::ResultSequencer sequencer;
+    const auto report = recorder();
+
+    sequencer.begin(1);
+    sequencer.begin(2);
+    sequencer.begin(3);
+
+    sequencer.finish(3, frameResults(3), report);
+    QVERIFY(m_reported.isEmpty());
+
+    sequencer.finish(1, frameResults(1), report);
+    QCOMPARE(m_reported, QList<quint64> { 1 });
+
+    // Frame 3 was held back for frame 2
+    sequencer.finish(2, frameResults(2), report);
+    QCOMPARE(m_reported, (QList<quint64> { 1, 2, 3 }));
+}
+
+void ResultSequencerTest::discard()
+{
+    SCodes::ResultSequencer sequencer;
+    const auto report = recorder();
+
+    sequencer.begin(1);
+    sequencer.begin(2);
+    sequencer.finish(2, frameResults(2), report);
+    QVERIFY(m_reported.isEmpty());
+
+    sequencer.discard(1, report);
+    QCOMPARE(m_reported, QList<quint64> { 2 });
+}
+
+void ResultSequencerTest::lateRegistration()
+{
+    SCodes::ResultSequencer sequencer;
+    const auto report = recorder();
+
+    sequencer.begin(6);
+    sequencer.finish(6, frameResults(6), report);
+
+    // Results of an older frame are outdated once a newer one was reported
+    sequencer.begin(5);
+    sequencer.finish(5, frameResults(5), report);
+
+    QCOMPARE(m_reported, QList<quint64> { 6 });
+}
+
+void ResultSequencerTest::concurrentFinish()
+{
+    constexpr int frameCount = 2000;
+    constexpr int threadCount = 4;
+
+    SCodes::ResultSequencer sequencer;
+    const auto report = recorder();
+
+    // Frames are registered in order when taken, then finished by several threads in random order
+    std::vector<quint64> sequences(frameCount);
+
+    for (int i = 0; i < frameCount; ++i) {
+        sequences[size_t(i)] = quint64(i + 1);
+        sequencer.begin(sequences[size_t(i)]);
+    }
+
+    std::shuffle(sequences.begin(), sequences.end(), std::mt19937(5));
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = size_t(t); i < sequences.size(); i += threadCount) {
+                sequencer.finish(sequences[i], frameResults(sequences[i]), report);
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    QCOMPARE(m_reported.size(), frameCount);
+
+    for (int i = 0; i < frameCount; ++i) {
+        QCOMPARE(m_reported[i], quint64(i + 1));
+    }
+}
+
+QTEST_GUILESS_MAIN(ResultSequencerTest)
+
+#include "tst_resultsequencer.moc"
@@ -0,0 +1,7 @@
+# Common settings of the unit tests, the library is compiled into every test through SCodes.pri like into an
+# application
+QT += testlib
+CONFIG += testcase console c++17
+CONFIG -= app_bundle
+
+include($$PWD/../src/SCodes.pri)
@@ -0,0 +1,15 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    luminancepyramid \
+    resultfilter \
+    resultsequencer \
+    tiling
+
+equals(QT_MAJOR_VERSION, 6) {
+    SUBDIRS += framemailbox
+}
+
+equals(QT_MAJOR_VERSION, 5) {
+    SUBDIRS += gllumareader
+}
@@ -0,0 +1,6 @@
+include(../tests.pri)
+
+TARGET = tst_tiling
+
+SOURCES += \
+    tst_tiling.cpp
@@ -0,0 +1,163 @@
+#include <QtTest>
+
+#include "private/Tiling.h"
+
+namespace {
+/*!
+ * \fn SBarcodeResult barcode(const QString &text, SCodes::SBarcodeFormat format, const QPolygonF &position)
+ * \brief Returns a decoded barcode found at the normalized position.
+ */
+SBarcodeResult barcode(const QString &text, SCodes::SBarcodeFormat format, const QPolygonF &position)
+{
+    SBarcodeResult result;
+    result.text     = text;
+    result.format   = format;
+    result.position = position;
+    return result;
+}
+
+/*!
+ * \fn QPolygonF line(qreal left, qreal right, qreal y)
+ * \brief Returns zero height position of a linear barcode, as reported by ZXing.
+ */
+QPolygonF line(qreal left, qreal right, qreal y)
+{
+    return QPolygonF({ QPointF(left, y), QPointF(right, y), QPointF(right, y), QPointF(left, y) });
+}
+
+/*!
+ * \fn QPolygonF square(qreal left, qreal top, qreal size)
+ * \brief Returns position of a square 2D barcode.
+ */
+QPolygonF square(qreal left, qreal top, qreal size)
+{
+    return QPolygonF(QRectF(left, top, size, size));
+}
+}
+
+/*!
+ * \brief The TilingTest class checks the tile geometry of large images and the merging of barcodes found by
+ * overlapping tiles.
+ */
+class TilingTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tileRects_data();
+    void tileRects();
+    void sameLinearBarcode();
+    void sameSquareBarcode();
+    void differentBarcodes();
+    void mergeTileResults();
+};
+
+void TilingTest::tileRects_data()
+{
+    QTest::addColumn<QSize>("imageSize");
+    QTest::addColumn<QSize>("tileSize");
+    QTest::addColumn<int>("overlap");
+    QTest::addColumn<int>("tileCount");
+
+    QTest::newRow("3x2 tiles")     << QSize(1000, 600) << QSize(400, 400) << 50  << 6;
+    QTest::newRow("exact fit")     << QSize(800, 400)  << QSize(400, 400) << 0   << 2;
+    QTest::newRow("large overlap") << QSize(4000, 3000) << QSize(1024, 1024) << 256 << 20;
+    QTest::newRow("small image")   << QSize(300, 200)  << QSize(400, 400) << 50  << 1;
+}
+
+void TilingTest::tileRects()
+{
+    QFETCH(QSize, imageSize);
+    QFETCH(QSize, tileSize);
+    QFETCH(int, overlap);
+    QFETCH(int, tileCount);
+
+    const QRect imageRect(QPoint(0, 0), imageSize);
+    const QVector<QRect> tiles = SCodes::tileRects(imageSize, tileSize, overlap);
+
+    QCOMPARE(tiles.size(), tileCount);
+
+    QRect covered;
+
+    for (const QRect &tile : tiles) {
+        // Tiles keep their full size, clipped to the image only if it is smaller
+        QVERIFY(imageRect.contains(tile));
+        QCOMPARE(tile.size(), tileSize.boundedTo(imageSize));
+        covered |= tile;
+    }
+
+    QCOMPARE(covered, imageRect);
+
+    // Neighbours in a row share at least the overlap, so a barcode as wide as the overlap is whole in one tile
+    for (int i = 1; i < tiles.size(); ++i) {
+        if (tiles[i].y() == tiles[i - 1].y()) {
+            QVERIFY(tiles[i - 1].right() - tiles[i].left() + 1 >= overlap);
+        }
+    }
+}
+
+void TilingTest::sameLinearBarcode()
+{
+    const QSize imageSize(4000, 3000);
+
+    // Two tiles decoded different rows of the same barcode, the zero height lines have no intersection
+    const auto first  = barcode("5901234123457", SCodes::SBarcodeFormat::EAN13, line(0.40, 0.45, 0.500));
+    const auto second = barcode("5901234123457", SCodes::SBarcodeFormat::EAN13, line(0.401, 0.451, 0.505));
+
+    QVERIFY(first.position.boundingRect().isEmpty());
+    QVERIFY(SCodes::isSameBarcode(first, second, imageSize));
+    QVERIFY(SCodes::isSameBarcode(second, first, imageSize));
+}
+
+void TilingTest::sameSquareBarcode()
+{
+    const QSize imageSize(2000, 2000);
+
+    const auto first  = barcode("text", SCodes::SBarcodeFormat::QRCode, square(0.5, 0.5, 0.05));
+    const auto second = barcode("text", SCodes::SBarcodeFormat::QRCode, square(0.501, 0.499, 0.05));
+
+    QVERIFY(SCodes::isSameBarcode(first, second, imageSize));
+}
+
+void TilingTest::differentBarcodes()
+{
+    const QSize imageSize(4000, 3000);
+    const auto code = barcode("5901234123457", SCodes::SBarcodeFormat::EAN13, line(0.40, 0.45, 0.5));
+
+    // Other content or format at the same place
+    QVERIFY(!SCodes::isSameBarcode(code, barcode("5901234123464", SCodes::SBarcodeFormat::EAN13, code.position),
+                                   imageSize));
+    QVERIFY(!SCodes::isSameBarcode(code, barcode(code.text, SCodes::SBarcodeFormat::ITF, code.position), imageSize));
+
+    // Same content printed twice, far apart
+    QVERIFY(!SCodes::isSameBarcode(code, barcode(code.text, code.format, line(0.40, 0.45, 0.8)), imageSize));
+}
+
+void TilingTest::mergeTileResults()
+{
+    const QSize imageSize(4000, 3000);
+
+    const auto linear     = barcode("5901234123457", SCodes::SBarcodeFormat::EAN13, line(0.40, 0.45, 0.500));
+    const auto linearSeen = barcode("5901234123457", SCodes::SBarcodeFormat::EAN13, line(0.40, 0.45, 0.503));
+    const auto qrCode     = barcode("text", SCodes::SBarcodeFormat::QRCode, square(0.1, 0.1, 0.05));
+    const auto qrCodeSeen = barcode("text", SCodes::SBarcodeFormat::QRCode, square(0.1, 0.1, 0.05));
+    const auto secondCopy = barcode("text", SCodes::SBarcodeFormat::QRCode, square(0.8, 0.8, 0.05));
+
+    const std::vector<QList<SBarcodeResult>> tileResults {
+        { qrCode, linear },
+        { linearSeen },
+        { qrCodeSeen, secondCopy },
+        {},
+    };
+
+    const QList<SBarcodeResult> merged = SCodes::mergeTileResults(tileResults, imageSize);
+
+    QCOMPARE(merged.size(), 3);
+    QCOMPARE(merged[0].position, qrCode.position);
+    QCOMPARE(merged[1].position, linear.position);
+    QCOMPARE(merged[2].position, secondCopy.position);
+}
+
+QTEST_GUILESS_MAIN(TilingTest)
+
+#include "tst_tiling.moc"
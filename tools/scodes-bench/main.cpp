@@ -0,0 +1,785 @@
+/*!
+ * scodes-bench measures decoding throughput and success rate on a synthetic corpus. Barcodes of every format
+ * ZXing can write are rendered for several frame resolutions and module sizes, degraded in a controlled way
+ * (blur, noise, perspective, low contrast, inversion) and decoded through SBarcodeDecoder::process and the video
+ * frame conversion paths. The corpus only depends on the seed, so results of two runs can be compared:
+ *
+ *   scodes-bench --output before.json
+ *   scodes-bench --output after.json --baseline before.json
+ *
+ * Results are written as single JSON document, regressions against the baseline to the standard error output.
+ */
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QTransform>
+#include <QVideoFrame>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QVideoFrameFormat>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "SBarcodeDecoder.h"
+#include "SBarcodeFormat.h"
+#include "private/BarcodeEncoder.h"
+
+namespace {
+/*!
+ *  Quiet zone around the barcode in modules, linear barcodes need a wider one
+ */
+constexpr int k_quietZone2D = 4;
+constexpr int k_quietZone1D = 10;
+
+/*!
+ *  Version of the output document, to be increased when fields change their meaning
+ */
+constexpr int k_outputVersion = 1;
+
+enum class Degradation {
+    None,
+    Blur,
+    Noise,
+    Perspective,
+    LowContrast,
+    Inverted,
+};
+
+enum class DecodePath {
+    Process,
+    FrameNV12,
+    FrameRGB32,
+};
+
+const QList<QPair<Degradation, QString>> k_degradations = {
+    { Degradation::None, QStringLiteral("none") },
+    { Degradation::Blur, QStringLiteral("blur") },
+    { Degradation::Noise, QStringLiteral("noise") },
+    { Degradation::Perspective, QStringLiteral("perspective") },
+    { Degradation::LowContrast, QStringLiteral("low-contrast") },
+    { Degradation::Inverted, QStringLiteral("inverted") },
+};
+
+const QList<QPair<DecodePath, QString>> k_paths = {
+    { DecodePath::Process, QStringLiteral("process") },
+    { DecodePath::FrameNV12, QStringLiteral("frame-nv12") },
+    { DecodePath::FrameRGB32, QStringLiteral("frame-rgb32") },
+};
+
+/*!
+ * \brief Content of a single corpus sample, the text passed to the encoder and the text expected in the result.
+ */
+struct SampleText {
+    QString encoded;
+    QString expected;
+};
+
+/*!
+ * \brief Single rendered and degraded sample.
+ */
+struct Sample {
+    QImage image;
+    QString expected;
+};
+
+/*!
+ * \fn QString randomDigits(std::mt19937 &random, int count)
+ * \brief Returns string of random decimal digits.
+ */
+QString randomDigits(std::mt19937 &random, int count)
+{
+    std::uniform_int_distribution<int> digit(0, 9);
+    QString digits;
+
+    for (int i = 0; i < count; ++i) {
+        digits.append(QChar('0' + digit(random)));
+    }
+
+    return digits;
+}
+
+/*!
+ * \fn SampleText sampleText(SCodes::SBarcodeFormat format, std::mt19937 &random)
+ * \brief Returns random content valid for the format. Check digits of EAN and UPC codes are left to the encoder,
+ * so the expected text is a prefix of the decoded one, and Codabar start and stop characters are not expected.
+ */
+SampleText sampleText(SCodes::SBarcodeFormat format, std::mt19937 &random)
+{
+    using SCodes::SBarcodeFormat;
+
+    switch (format) {
+    case SBarcodeFormat::Codabar: {
+        const QString digits = randomDigits(random, 10);
+        return { QStringLiteral("A") + digits + QStringLiteral("B"), digits };
+    }
+    case SBarcodeFormat::Code39:
+    case SBarcodeFormat::Code93: {
+        const QString text = QStringLiteral("SCODES-") + randomDigits(random, 6);
+        return { text, text };
+    }
+    case SBarcodeFormat::Code128: {
+        const QString text = QStringLiteral("SCodes-") + randomDigits(random, 8);
+        return { text, text };
+    }
+    case SBarcodeFormat::EAN8: {
+        const QString digits = randomDigits(random, 7);
+        return { digits, digits };
+    }
+    case SBarcodeFormat::EAN13: {
+        const QString digits = randomDigits(random, 12);
+        return { digits, digits };
+    }
+    case SBarcodeFormat::ITF: {
+        const QString digits = randomDigits(random, 14);
+        return { digits, digits };
+    }
+    case SBarcodeFormat::UPCA: {
+        const QString digits = randomDigits(random, 11);
+        return { digits, digits };
+    }
+    case SBarcodeFormat::UPCE: {
+        const QString digits = QStringLiteral("0") + randomDigits(random, 6);
+        return { digits, digits };
+    }
+    default: {
+        const QString text = QStringLiteral("https://scodes.example/") + randomDigits(random, 16);
+        return { text, text };
+    }
+    }
+}
+
+/*!
+ * \fn bool isLinear(SCodes::SBarcodeFormat format)
+ * \brief Returns true for 1D barcode formats.
+ */
+bool isLinear(SCodes::SBarcodeFormat format)
+{
+    return SCodes::SBarcodeFormats(SCodes::SBarcodeFormat::OneDCodes).testFlag(format);
+}
+
+/*!
+ * \fn void boxBlur(QImage &image, int radius)
+ * \brief Blurs Grayscale8 image in place by horizontal and vertical box filter of the given radius.
+ */
+void boxBlur(QImage &image, int radius)
+{
+    const int width  = image.width();
+    const int height = image.height();
+    const int size   = 2 * radius + 1;
+    std::vector<uint8_t> line(size_t(std::max(width, height)));
+
+    auto filter = [&](uint8_t *first, int count, int step) {
+        for (int i = 0; i < count; ++i) {
+            line[size_t(i)] = first[i * step];
+        }
+
+        int sum = 0;
+
+        for (int i = -radius; i <= radius; ++i) {
+            sum += line[size_t(std::clamp(i, 0, count - 1))];
+        }
+
+        for (int i = 0; i < count; ++i) {
+            first[i * step] = uint8_t((sum + size / 2) / size);
+            sum += line[size_t(std::min(i + radius + 1, count - 1))] - line[size_t(std::max(i - radius, 0))];
+        }
+    };
+
+    for (int y = 0; y < height; ++y) {
+        filter(image.scanLine(y), width, 1);
+    }
+
+    for (int x = 0; x < width; ++x) {
+        filter(image.bits() + x, height, int(image.bytesPerLine()));
+    }
+}
+
+/*!
+ * \fn void addNoise(QImage &image, std::mt19937 &random, double sigma)
+ * \brief Adds gaussian noise to Grayscale8 image in place.
+ */
+void addNoise(QImage &image, std::mt19937 &random, double sigma)
+{
+    std::normal_distribution<double> noise(0.0, sigma);
+
+    for (int y = 0; y < image.height(); ++y) {
+        uint8_t *line = image.scanLine(y);
+
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = uint8_t(std::clamp(int(line[x] + noise(random)), 0, 255));
+        }
+    }
+}
+
+/*!
+ * \fn QImage warpPerspective(const QImage &image, std::mt19937 &random, double strength)
+ * \brief Returns Grayscale8 image with every corner moved inwards by a random amount up to the given fraction
+ * of the image size.
+ */
+QImage warpPerspective(const QImage &image, std::mt19937 &random, double strength)
+{
+    std::uniform_real_distribution<double> shift(0.0, strength);
+    const double width  = image.width();
+    const double height = image.height();
+
+    const QPolygonF source(QRectF(image.rect()));
+    QPolygonF target;
+    target << QPointF(shift(random) * width, shift(random) * height)
+           << QPointF(width - shift(random) * width, shift(random) * height)
+           << QPointF(width - shift(random) * width, height - shift(random) * height)
+           << QPointF(shift(random) * width, height - shift(random) * height);
+
+    QTransform transform;
+    QTransform::quadToQuad(source, target, transform);
+
+    QImage warped(image.size(), QImage::Format_RGB32);
+    warped.fill(Qt::white);
+
+    {
+        QPainter painter(&warped);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.setTransform(transform);
+        painter.drawImage(0, 0, image);
+    }
+
+    return warped.convertToFormat(QImage::Format_Grayscale8);
+}
+
+/*!
+ * \fn void reduceContrast(QImage &image, int low, int high)
+ * \brief Maps the full luminance range of Grayscale8 image in place to the range between low and high.
+ */
+void reduceContrast(QImage &image, int low, int high)
+{
+    for (int y = 0; y < image.height(); ++y) {
+        uint8_t *line = image.scanLine(y);
+
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = uint8_t(low + line[x] * (high - low) / 255);
+        }
+    }
+}
+
+/*!
+ * \fn bool renderSample(SCodes::SBarcodeFormat format, const QSize &resolution, int moduleSize, Degradation degradation, std::mt19937 &random, Sample &sample)
+ * \brief Renders a random barcode of the format at a random position of a white Grayscale8 frame and degrades it.
+ * \return false if the barcode does not fit into the frame.
+ */
+bool renderSample(SCodes::SBarcodeFormat format, const QSize &resolution, int moduleSize, Degradation degradation,
+                  std::mt19937 &random, Sample &sample)
+{
+    const SampleText text = sampleText(format, random);
+
+    // Encoded with one pixel per module and no margin, linear barcodes are a single row
+    QImage code = SCodes::encodeBarcode(format, text.encoded, 0, 0, 0, -1).convertToFormat(QImage::Format_Grayscale8);
+
+    const bool linear = isLinear(format);
+    const int quietZone = (linear ? k_quietZone1D : k_quietZone2D) * moduleSize;
+    const int codeWidth = code.width() * moduleSize;
+    const int codeHeight = linear ? std::max(resolution.height() / 4, 20 * moduleSize) : code.height() * moduleSize;
+
+    if (codeWidth + 2 * quietZone > resolution.width() || codeHeight + 2 * quietZone > resolution.height()) {
+        return false;
+    }
+
+    code = code.scaled(codeWidth, codeHeight, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+
+    std::uniform_int_distribution<int> left(quietZone, resolution.width() - quietZone - codeWidth);
+    std::uniform_int_distribution<int> top(quietZone, resolution.height() - quietZone - codeHeight);
+    const int x0 = left(random);
+    const int y0 = top(random);
+
+    QImage image(resolution, QImage::Format_Grayscale8);
+    image.fill(255);
+
+    for (int y = 0; y < codeHeight; ++y) {
+        std::memcpy(image.scanLine(y0 + y) + x0, code.constScanLine(y), size_t(codeWidth));
+    }
+
+    switch (degradation) {
+    case Degradation::None:
+        break;
+    case Degradation::Blur:
+        boxBlur(image, std::max(1, moduleSize / 2));
+        break;
+    case Degradation::Noise:
+        addNoise(image, random, 24.0);
+        break;
+    case Degradation::Perspective:
+        image = warpPerspective(image, random, 0.15);
+        break;
+    case Degradation::LowContrast:
+        reduceContrast(image, 100, 155);
+        break;
+    case Degradation::Inverted:
+        image.invertPixels();
+        break;
+    }
+
+    sample = { image, text.expected };
+    return true;
+}
+
+/*!
+ * \fn QVideoFrame toVideoFrame(const QImage &image, DecodePath path)
+ * \brief Returns a copy of the Grayscale8 image as NV12 or 32 bit RGB video frame held in memory.
+ */
+QVideoFrame toVideoFrame(const QImage &image, DecodePath path)
+{
+    const bool nv12 = path == DecodePath::FrameNV12;
+    // NV12 chroma is subsampled, the frame size has to be even
+    const QSize size = nv12 ? QSize(image.width() & ~1, image.height() & ~1) : image.size();
+
+    #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    const QImage rgb = nv12 ? QImage() : image.convertToFormat(QImage::Format_RGB32);
+    QVideoFrame frame = nv12
+      ? QVideoFrame(size.width() * size.height() * 3 / 2, size, size.width(), QVideoFrame::Format_NV12)
+      : QVideoFrame(int(rgb.sizeInBytes()), size, int(rgb.bytesPerLine()), QVideoFrame::Format_RGB32);
+
+    if (!frame.map(QAbstractVideoBuffer::WriteOnly)) {
+        return {};
+    }
+    #else
+    const QImage rgb = nv12 ? QImage() : image.convertToFormat(QImage::Format_RGBX8888);
+    QVideoFrame frame(QVideoFrameFormat(size, nv12 ? QVideoFrameFormat::Format_NV12
+                                                   : QVideoFrameFormat::Format_RGBX8888));
+
+    if (!frame.map(QVideoFrame::WriteOnly)) {
+        return {};
+    }
+    #endif
+
+    const QImage &source = nv12 ? image : rgb;
+    const size_t rowBytes = nv12 ? size_t(size.width()) : size_t(4 * size.width());
+
+    for (int y = 0; y < size.height(); ++y) {
+        std::memcpy(frame.bits(0) + y * frame.bytesPerLine(0), source.constScanLine(y), rowBytes);
+    }
+
+    if (nv12) {
+        // Neutral chroma
+        std::memset(frame.bits(1), 128, size_t(frame.bytesPerLine(1)) * size_t(size.height() / 2));
+    }
+
+    frame.unmap();
+
+    return frame;
+}
+
+/*!
+ * \fn bool isDecoded(const QList<SBarcodeResult> &results, const QString &expected)
+ * \brief Returns true if any of the results holds the expected text.
+ */
+bool isDecoded(const QList<SBarcodeResult> &results, const QString &expected)
+{
+    return std::any_of(results.begin(), results.end(), [&](const SBarcodeResult &result) {
+        return result.text.contains(expected);
+    });
+}
+
+/*!
+ * \fn double percentile(const std::vector<double> &sorted, double fraction)
+ * \brief Returns the nearest rank percentile of sorted values.
+ */
+double percentile(const std::vector<double> &sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+
+    const size_t rank = size_t(std::ceil(fraction * double(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+/*!
+ * \fn QString caseKey(const QJsonObject &result)
+ * \brief Returns the key identifying a benchmark case across runs.
+ */
+QString caseKey(const QJsonObject &result)
+{
+    return QStringList{ result.value(QStringLiteral("format")).toString(),
+                        result.value(QStringLiteral("resolution")).toString(),
+                        QString::number(result.value(QStringLiteral("moduleSize")).toInt()),
+                        result.value(QStringLiteral("degradation")).toString(),
+                        result.value(QStringLiteral("path")).toString() }.join(QLatin1Char('/'));
+}
+
+/*!
+ * \fn int compareWithBaseline(const QJsonArray &cases, const QString &baselinePath, double tolerance)
+ * \brief Prints cases whose success rate dropped or whose median time grew by more than the tolerance.
+ * \return number of regressions, -1 if the baseline can't be read.
+ */
+int compareWithBaseline(const QJsonArray &cases, const QString &baselinePath, double tolerance)
+{
+    QFile file(baselinePath);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "scodes-bench: can't read baseline %s\n", qPrintable(baselinePath));
+        return -1;
+    }
+
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+
+    if (document.object().value(QStringLiteral("version")).toInt() != k_outputVersion) {
+        std::fprintf(stderr, "scodes-bench: baseline %s has different version\n", qPrintable(baselinePath));
+        return -1;
+    }
+
+    QHash<QString, QJsonObject> baseline;
+
+    for (const auto &value : document.object().value(QStringLiteral("cases")).toArray()) {
+        baseline.insert(caseKey(value.toObject()), value.toObject());
+    }
+
+    int regressions = 0;
+
+    for (const auto &value : cases) {
+        const QJsonObject current = value.toObject();
+        const QString key = caseKey(current);
+        const auto it = baseline.constFind(key);
+
+        if (it == baseline.constEnd()) {
+            continue;
+        }
+
+        const double baseRate = it->value(QStringLiteral("successRate")).toDouble();
+        const double rate = current.value(QStringLiteral("successRate")).toDouble();
+        const double baseMedian = it->value(QStringLiteral("p50Ms")).toDouble();
+        const double median = current.value(QStringLiteral("p50Ms")).toDouble();
+
+        if (rate + 1e-9 < baseRate) {
+            std::fprintf(stderr, "scodes-bench: %s success rate %.2f -> %.2f\n", qPrintable(key), baseRate, rate);
+            ++regressions;
+        }
+
+        if (baseMedian > 0.0 && median > baseMedian * (1.0 + tolerance / 100.0)) {
+            std::fprintf(stderr, "scodes-bench: %s p50 %.3f ms -> %.3f ms\n", qPrintable(key), baseMedian, median);
+            ++regressions;
+        }
+    }
+
+    return regressions;
+}
+
+/*!
+ * \fn template <typename T> bool parseSelection(const QString &value, const QList<QPair<T, QString>> &names, QList<QPair<T, QString>> &selection)
+ * \brief Selects the named entries given as comma separated list, in the order of names.
+ * \return false if the list contains unknown name.
+ */
+template <typename T>
+bool parseSelection(const QString &value, const QList<QPair<T, QString>> &names, QList<QPair<T, QString>> &selection)
+{
+    const QStringList requested = value.split(QLatin1Char(','), Qt::SkipEmptyParts);
+
+    for (const auto &name : requested) {
+        if (std::none_of(names.begin(), names.end(), [&](const auto &entry) { return entry.second == name; })) {
+            std::fprintf(stderr, "scodes-bench: unknown name %s\n", qPrintable(name));
+            return false;
+        }
+    }
+
+    selection.clear();
+
+    for (const auto &entry : names) {
+        if (requested.contains(entry.second)) {
+            selection.append(entry);
+        }
+    }
+
+    return true;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("scodes-bench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Measures decoding speed and success rate on a synthetic corpus."));
+    parser.addHelpOption();
+
+    const QCommandLineOption formatsOption({ QStringLiteral("f"), QStringLiteral("formats") },
+                                           QStringLiteral("Comma separated barcode formats (default: all with encoder)."),
+                                           QStringLiteral("formats"));
+    const QCommandLineOption resolutionsOption(QStringLiteral("resolutions"),
+                                               QStringLiteral("Comma separated frame sizes."),
+                                               QStringLiteral("sizes"), QStringLiteral("640x480,1280x720,1920x1080"));
+    const QCommandLineOption moduleSizesOption(QStringLiteral("module-sizes"),
+                                               QStringLiteral("Comma separated module sizes in pixels."),
+                                               QStringLiteral("sizes"), QStringLiteral("2,4,8"));
+    const QCommandLineOption degradationsOption(QStringLiteral("degradations"),
+                                                QStringLiteral("Comma separated degradations: none, blur, noise, "
+                                                               "perspective, low-contrast, inverted (default: all)."),
+                                                QStringLiteral("names"));
+    const QCommandLineOption pathsOption(QStringLiteral("paths"),
+                                         QStringLiteral("Comma separated decoding paths: process, frame-nv12, "
+                                                        "frame-rgb32 (default: all)."),
+                                         QStringLiteral("names"));
+    const QCommandLineOption variantsOption(QStringLiteral("variants"),
+                                            QStringLiteral("Number of random samples per case."),
+                                            QStringLiteral("count"), QStringLiteral("4"));
+    const QCommandLineOption iterationsOption({ QStringLiteral("n"), QStringLiteral("iterations") },
+                                              QStringLiteral("Number of timed decodes per sample."),
+                                              QStringLiteral("count"), QStringLiteral("3"));
+    const QCommandLineOption seedOption(QStringLiteral("seed"), QStringLiteral("Seed of the corpus."),
+                                       QStringLiteral("seed"), QStringLiteral("1"));
+    const QCommandLineOption anyFormatOption(QStringLiteral("any-format"),
+                                             QStringLiteral("Decode with all formats enabled, not only the encoded one."));
+    const QCommandLineOption outputOption({ QStringLiteral("o"), QStringLiteral("output") },
+                                          QStringLiteral("JSON results file (default: standard output)."),
+                                          QStringLiteral("file"));
+    const QCommandLineOption baselineOption(QStringLiteral("baseline"),
+                                            QStringLiteral("Results of an earlier run to compare with."),
+                                            QStringLiteral("file"));
+    const QCommandLineOption toleranceOption(QStringLiteral("tolerance"),
+                                             QStringLiteral("Allowed growth of the median time in percent."),
+                                             QStringLiteral("percent"), QStringLiteral("10"));
+
+    parser.addOptions({ formatsOption, resolutionsOption, moduleSizesOption, degradationsOption, pathsOption,
+                        variantsOption, iterationsOption, seedOption, anyFormatOption, outputOption, baselineOption,
+                        toleranceOption });
+    parser.process(app);
+
+    QList<SCodes::SBarcodeFormat> formats;
+    QStringList skippedFormats;
+
+    for (int i = 0; i < SCodes::k_singleFormatCount; ++i) {
+        const auto format = static_cast<SCodes::SBarcodeFormat>(1 << i);
+
+        if (SCodes::canEncode(format)) {
+            formats.append(format);
+        } else {
+            skippedFormats.append(SCodes::toString(format));
+        }
+    }
+
+    if (parser.isSet(formatsOption)) {
+        QList<SCodes::SBarcodeFormat> selected;
+
+        for (const auto &name : parser.value(formatsOption).split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+            SCodes::SBarcodeFormat format = SCodes::SBarcodeFormat::None;
+
+            try {
+                format = SCodes::fromString(name);
+            } catch (const std::exception &) {
+            }
+
+            if (!formats.contains(format)) {
+                std::fprintf(stderr, "scodes-bench: no encoder for format %s\n", qPrintable(name));
+                return 2;
+            }
+
+            selected.append(format);
+        }
+
+        formats = selected;
+    }
+
+    QList<QSize> resolutions;
+
+    for (const auto &value : parser.value(resolutionsOption).split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        const QStringList parts = value.split(QLatin1Char('x'));
+        const QSize size = parts.size() == 2 ? QSize(parts[0].toInt(), parts[1].toInt()) : QSize();
+
+        if (size.isEmpty()) {
+            std::fprintf(stderr, "scodes-bench: invalid resolution %s\n", qPrintable(value));
+            return 2;
+        }
+
+        resolutions.append(size);
+    }
+
+    QList<int> moduleSizes;
+
+    for (const auto &value : parser.value(moduleSizesOption).split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        if (value.toInt() <= 0) {
+            std::fprintf(stderr, "scodes-bench: invalid module size %s\n", qPrintable(value));
+            return 2;
+        }
+
+        moduleSizes.append(value.toInt());
+    }
+
+    auto degradations = k_degradations;
+    auto paths = k_paths;
+
+    if ((parser.isSet(degradationsOption) && !parseSelection(parser.value(degradationsOption), k_degradations, degradations))
+        || (parser.isSet(pathsOption) && !parseSelection(parser.value(pathsOption), k_paths, paths))) {
+        return 2;
+    }
+
+    const int variants   = std::max(1, parser.value(variantsOption).toInt());
+    const int iterations = std::max(1, parser.value(iterationsOption).toInt());
+    const uint seed      = parser.value(seedOption).toUInt();
+    const bool anyFormat = parser.isSet(anyFormatOption);
+
+    SBarcodeDecoder decoder;
+    QJsonArray cases;
+    int totalDecodes = 0;
+    int totalDecoded = 0;
+    double totalTime = 0.0;
+
+    for (const auto format : formats) {
+        const QString formatName = SCodes::toString(format);
+        const ZXing::BarcodeFormats decodeFormats = anyFormat ? ZXing::BarcodeFormat::Any : SCodes::toZXingFormat(format);
+
+        std::fprintf(stderr, "scodes-bench: %s\n", qPrintable(formatName));
+
+        for (const auto &resolution : resolutions) {
+            for (const int moduleSize : moduleSizes) {
+                for (const auto &degradation : degradations) {
+                    // Every case has its own generator, so selecting a subset of cases doesn't change the corpus
+                    std::seed_seq caseSeed{ seed, uint(format), uint(resolution.width()), uint(resolution.height()),
+                                            uint(moduleSize), uint(degradation.first) };
+                    std::mt19937 random(caseSeed);
+                    std::vector<Sample> samples;
+
+                    try {
+                        for (int i = 0; i < variants; ++i) {
+                            Sample sample;
+
+                            if (!renderSample(format, resolution, moduleSize, degradation.first, random, sample)) {
+                                break;
+                            }
+
+                            samples.push_back(sample);
+                        }
+                    } catch (const std::exception &e) {
+                        std::fprintf(stderr, "scodes-bench: %s can't be encoded: %s\n", qPrintable(formatName),
+                                     e.what());
+                        samples.clear();
+                    }
+
+                    if (samples.empty()) {
+                        continue;
+                    }
+
+                    for (const auto &path : paths) {
+                        std::vector<double> times;
+                        times.reserve(samples.size() * size_t(iterations));
+                        int decoded = 0;
+
+                        for (const auto &sample : samples) {
+                            const QVideoFrame frame = path.first == DecodePath::Process
+                              ? QVideoFrame()
+                              : toVideoFrame(sample.image, path.first);
+
+                            for (int i = 0; i < iterations; ++i) {
+                                QElapsedTimer timer;
+                                timer.start();
+
+                                const QList<SBarcodeResult> results = path.first == DecodePath::Process
+                                  ? decoder.process(sample.image, decodeFormats)
+                                  : decoder.processFrame(frame, QRect(), decodeFormats);
+
+                                times.push_back(timer.nsecsElapsed() / 1e6);
+
+                                // Decoding is deterministic, the first attempt decides about success
+                                if (i == 0 && isDecoded(results, sample.expected)) {
+                                    ++decoded;
+                                }
+                            }
+                        }
+
+                        const double time = std::accumulate(times.begin(), times.end(), 0.0);
+                        std::sort(times.begin(), times.end());
+
+                        cases.append(QJsonObject{
+                            { QStringLiteral("format"), formatName },
+                            { QStringLiteral("resolution"),
+                              QStringLiteral("%1x%2").arg(resolution.width()).arg(resolution.height()) },
+                            { QStringLiteral("moduleSize"), moduleSize },
+                            { QStringLiteral("degradation"), degradation.second },
+                            { QStringLiteral("path"), path.second },
+                            { QStringLiteral("samples"), int(samples.size()) },
+                            { QStringLiteral("decoded"), decoded },
+                            { QStringLiteral("successRate"), double(decoded) / samples.size() },
+                            { QStringLiteral("meanMs"), time / times.size() },
+                            { QStringLiteral("p50Ms"), percentile(times, 0.5) },
+                            { QStringLiteral("p90Ms"), percentile(times, 0.9) },
+                            { QStringLiteral("p99Ms"), percentile(times, 0.99) },
+                            { QStringLiteral("maxMs"), times.back() },
+                            { QStringLiteral("throughputFps"), time > 0.0 ? 1000.0 * times.size() / time : 0.0 },
+                        });
+
+                        totalDecodes += int(samples.size());
+                        totalDecoded += decoded;
+                        totalTime += time;
+                    }
+                }
+            }
+        }
+    }
+
+    QJsonArray skipped;
+
+    for (const auto &name : skippedFormats) {
+        skipped.append(name);
+    }
+
+    QJsonObject summary{
+        { QStringLiteral("cases"), cases.size() },
+        { QStringLiteral("samples"), totalDecodes },
+        { QStringLiteral("decoded"), totalDecoded },
+        { QStringLiteral("successRate"), totalDecodes > 0 ? double(totalDecoded) / totalDecodes : 0.0 },
+        { QStringLiteral("totalMs"), totalTime },
+    };
+
+    int regressions = 0;
+
+    if (parser.isSet(baselineOption)) {
+        regressions = compareWithBaseline(cases, parser.value(baselineOption), parser.value(toleranceOption).toDouble());
+
+        if (regressions < 0) {
+            return 2;
+        }
+
+        summary.insert(QStringLiteral("regressions"), regressions);
+    }
+
+    const QJsonObject document{
+        { QStringLiteral("version"), k_outputVersion },
+        { QStringLiteral("qtVersion"), QString::fromLatin1(qVersion()) },
+        { QStringLiteral("seed"), qint64(seed) },
+        { QStringLiteral("variants"), variants },
+        { QStringLiteral("iterations"), iterations },
+        { QStringLiteral("anyFormat"), anyFormat },
+        { QStringLiteral("skippedFormats"), skipped },
+        { QStringLiteral("cases"), cases },
+        { QStringLiteral("summary"), summary },
+    };
+
+    const QByteArray json = QJsonDocument(document).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            std::fprintf(stderr, "scodes-bench: can't write %s\n", qPrintable(parser.value(outputOption)));
+            return 2;
+        }
+    } else {
+        std::fwrite(json.constData(), 1, size_t(json.size()), stdout);
+    }
+
+    std::fprintf(stderr, "scodes-bench: %d cases, %d of %d samples decoded, %d regressions\n", int(cases.size()),
+                 totalDecoded, totalDecodes, regressions);
+
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,245 @@
+/*!
+ * scodes-scan decodes barcodes in image files without any UI and writes one JSON object per image to the
+ * standard output:
+ *
+ *   {"file":"a.png","loadMs":1.2,"decodeMs":8.4,"results":[{"text":"...","format":"QRCode","position":[[x,y],...]}]}
+ *
+ * Images which can't be read are reported with "error" instead of "results". A summary is written to the
+ * standard error output at the end.
+ */
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QSet>
+
+#include <cstdio>
+#include <stdexcept>
+
+#include "SBarcodeBatchDecoder.h"
+
+namespace {
+/*!
+ * \fn QStringList imageNameFilters()
+ * \brief Returns name filters matching all image formats Qt can read.
+ */
+QStringList imageNameFilters()
+{
+    QStringList filters;
+
+    for (const auto &format : QImageReader::supportedImageFormats()) {
+        filters.append(QStringLiteral("*.") + QString::fromLatin1(format));
+    }
+
+    return filters;
+}
+
+/*!
+ * \fn QStringList collectPaths(const QStringList &arguments, bool recursive)
+ * \brief Expands directories and glob patterns to the list of image files, in the given order.
+ * \param const QStringList &arguments - files, directories or glob patterns.
+ * \param bool recursive - true to descend into subdirectories.
+ */
+QStringList collectPaths(const QStringList &arguments, bool recursive)
+{
+    const QStringList filters = imageNameFilters();
+    QStringList paths;
+
+    for (const auto &argument : arguments) {
+        const QFileInfo info(argument);
+
+        if (info.isFile()) {
+            paths.append(argument);
+            continue;
+        }
+
+        QStringList found;
+
+        if (info.isDir()) {
+            QDirIterator it(argument, filters, QDir::Files,
+                            recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+
+            while (it.hasNext()) {
+                found.append(it.next());
+            }
+        } else {
+            // Glob pattern in the last path component, e.g. "photos/*.jpg"
+            const QDir dir(info.path());
+
+            for (const auto &name : dir.entryList({ info.fileName() }, QDir::Files)) {
+                found.append(dir.filePath(name));
+            }
+        }
+
+        if (found.isEmpty()) {
+            std::fprintf(stderr, "scodes-scan: no images found for %s\n", qPrintable(argument));
+        }
+
+        found.sort();
+        paths.append(found);
+    }
+
+    return paths;
+}
+
+/*!
+ * \fn QJsonObject toJson(const SBarcodeResult &result)
+ * \brief Returns the barcode as JSON object.
+ */
+QJsonObject toJson(const SBarcodeResult &result)
+{
+    QJsonArray position;
+
+    for (const auto &point : result.position) {
+        position.append(QJsonArray{ point.x(), point.y() });
+    }
+
+    return {
+        { QStringLiteral("text"), result.text },
+        { QStringLiteral("format"), SCodes::toString(result.format) },
+        { QStringLiteral("bytes"), QString::fromLatin1(result.bytes.toBase64()) },
+        { QStringLiteral("position"), position },
+    };
+}
+
+/*!
+ * \fn void writeLine(const QJsonObject &object)
+ * \brief Writes the object as single line of JSON to the standard output.
+ */
+void writeLine(const QJsonObject &object)
+{
+    const QByteArray line = QJsonDocument(object).toJson(QJsonDocument::Compact);
+    std::fwrite(line.constData(), 1, size_t(line.size()), stdout);
+    std::fputc('\n', stdout);
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("scodes-scan"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Decodes barcodes in images and prints JSON lines."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("inputs"), QStringLiteral("Image files, directories or glob patterns."),
+                                 QStringLiteral("inputs..."));
+
+    const QCommandLineOption formatsOption({ QStringLiteral("f"), QStringLiteral("formats") },
+                                           QStringLiteral("Comma separated barcode formats, e.g. QRCode,EAN13 (default: all)."),
+                                           QStringLiteral("formats"));
+    const QCommandLineOption threadsOption({ QStringLiteral("j"), QStringLiteral("threads") },
+                                           QStringLiteral("Number of decoding threads (default: one per CPU core)."),
+                                           QStringLiteral("count"), QStringLiteral("0"));
+    const QCommandLineOption maxLoadedOption(QStringLiteral("max-loaded"),
+                                             QStringLiteral("Maximum number of images held in memory (default: one per thread)."),
+                                             QStringLiteral("count"), QStringLiteral("0"));
+    const QCommandLineOption recursiveOption({ QStringLiteral("r"), QStringLiteral("recursive") },
+                                             QStringLiteral("Descend into subdirectories."));
+    const QCommandLineOption multiOption({ QStringLiteral("m"), QStringLiteral("multi") },
+                                         QStringLiteral("Report all barcodes in an image, not only the first one."));
+    const QCommandLineOption raceOption(QStringLiteral("race"),
+                                        QStringLiteral("Race several binarizers on every image."));
+    const QCommandLineOption budgetOption(QStringLiteral("budget"),
+                                          QStringLiteral("Time budget per image in milliseconds (default: no limit)."),
+                                          QStringLiteral("ms"), QStringLiteral("0"));
+    const QCommandLineOption unorderedOption(QStringLiteral("unordered"),
+                                             QStringLiteral("Print results as soon as they are completed."));
+
+    parser.addOptions({ formatsOption, threadsOption, maxLoadedOption, recursiveOption, multiOption, raceOption,
+                        budgetOption, unorderedOption });
+    parser.process(app);
+
+    if (parser.positionalArguments().isEmpty()) {
+        parser.showHelp(2);
+    }
+
+    ZXing::BarcodeFormats formats = ZXing::BarcodeFormat::Any;
+
+    if (parser.isSet(formatsOption)) {
+        try {
+            formats = ZXing::BarcodeFormatsFromString(parser.value(formatsOption).toStdString());
+        } catch (const std::exception &e) {
+            std::fprintf(stderr, "scodes-scan: %s\n", e.what());
+            return 2;
+        }
+    }
+
+    const QStringList paths = collectPaths(parser.positionalArguments(), parser.isSet(recursiveOption));
+
+    if (paths.isEmpty()) {
+        return 1;
+    }
+
+    SBarcodeBatchDecoder batch;
+    batch.setFormats(formats);
+    batch.setThreadCount(parser.value(threadsOption).toInt());
+    batch.setMaxLoadedImages(parser.value(maxLoadedOption).toInt());
+    batch.setResultOrder(parser.isSet(unorderedOption) ? SBarcodeBatchDecoder::ResultOrder::Completion
+                                                       : SBarcodeBatchDecoder::ResultOrder::Input);
+    batch.decoder()->setMultiResult(parser.isSet(multiOption));
+    batch.decoder()->setBinarizerRace(parser.isSet(raceOption));
+    batch.decoder()->setDecodeTimeBudget(parser.value(budgetOption).toInt());
+
+    QMap<int, QJsonObject> lines;
+    int found  = 0;
+    int failed = 0;
+    qint64 decodeTime = 0;
+
+    QObject::connect(&batch, &SBarcodeBatchDecoder::imageTimed, [&](int index, qint64 loadTime, qint64 imageDecodeTime){
+        lines.insert(index, {
+            { QStringLiteral("file"), paths.at(index) },
+            { QStringLiteral("loadMs"), loadTime / 1000.0 },
+            { QStringLiteral("decodeMs"), imageDecodeTime / 1000.0 },
+        });
+        decodeTime += imageDecodeTime;
+    });
+
+    QObject::connect(&batch, &SBarcodeBatchDecoder::resultReady, [&](int index, const QList<SBarcodeResult> &results){
+        QJsonObject line = lines.take(index);
+        QJsonArray barcodes;
+
+        for (const auto &result : results) {
+            barcodes.append(toJson(result));
+        }
+
+        line.insert(QStringLiteral("results"), barcodes);
+        writeLine(line);
+
+        found += results.isEmpty() ? 0 : 1;
+    });
+
+    QObject::connect(&batch, &SBarcodeBatchDecoder::imageFailed, [&](int index, const QString &errorString){
+        QJsonObject line = lines.take(index);
+        line.insert(QStringLiteral("error"), errorString);
+        writeLine(line);
+
+        ++failed;
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QObject::connect(&batch, &SBarcodeBatchDecoder::finished, &app, [&](bool cancelled){
+        const double seconds = timer.nsecsElapsed() / 1e9;
+
+        std::fflush(stdout);
+        std::fprintf(stderr, "scodes-scan: %d images, %d with barcodes, %d failed, %.2f s wall, %.2f ms mean decode, "
+                     "%.1f images/s\n", int(paths.size()), found, failed, seconds,
+                     paths.isEmpty() ? 0.0 : decodeTime / 1000.0 / paths.size(),
+                     seconds > 0 ? paths.size() / seconds : 0.0);
+
+        app.exit(cancelled ? 1 : 0);
+    });
+
+    batch.start(paths);
+
+    return app.exec();
+}